@@ -105,6 +105,55 @@ public class FullContextParsingDescriptors {
 
 	}
 
+	/**
+	 * The C++ target can cache full context predictions in the DFA states which require them (see
+	 * ParserATNSimulator::setFullContextCacheLimit). The last two predictions are taken from that cache, so no
+	 * full context simulation is attempted (or reported) for them.
+	 */
+	public static class CtxSensitiveDFACachedPredictions extends BaseDiagnosticParserTestDescriptor {
+		public String input = "$ 34 abc @ 34 abc $ 34 abc @ 34 abc";
+		/**
+		Decision 2:
+		s0-INT->s1
+		s1-ID->:s2^=>1
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		/**
+		line 1:5 reportAttemptingFullContext d=2 (e), input='34abc'
+		line 1:2 reportContextSensitivity d=2 (e), input='34'
+		line 1:14 reportAttemptingFullContext d=2 (e), input='34abc'
+		line 1:14 reportContextSensitivity d=2 (e), input='34abc'
+		 */
+		@CommentHasStringValue
+		public String errors;
+
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 s
+		 @init {<FullContextCacheLimit("4")>}
+		 @after {<DumpDFA()>}
+		   : ('$' a | '@' b)+ ;
+		 a : e ID ;
+		 b : e INT ID ;
+		 e : INT | ;
+		 ID : 'a'..'z'+ ;
+		 INT : '0'..'9'+ ;
+		 WS : (' '|'\t'|'\n')+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
 	public static abstract class CtxSensitiveDFA extends BaseDiagnosticParserTestDescriptor {
 		public String startRule = "s";
 		public String grammarName = "T";
@@ -808,6 +808,51 @@ public class LexerExecDescriptors {
 
 	}
 
+	/**
+	 * With the precompiledDFA option the C++ lexer matches tokens with a table of the complete DFA, built
+	 * when the lexer class is initialized. Tokens, channels and mode changes must not differ from the lazily
+	 * built DFA.
+	 */
+	public static class PrecompiledDFA extends BaseLexerTestDescriptor {
+		public String input = "abc 12 \"x y\" // c\nd";
+		/**
+		[@0,0:2='abc',<1>,1:0]
+		[@1,4:5='12',<2>,1:4]
+		[@2,7:7='"',<3>,1:7]
+		[@3,8:10='x y',<6>,1:8]
+		[@4,11:11='"',<7>,1:11]
+		[@5,13:16='// c',<5>,channel=1,1:13]
+		[@6,18:18='d',<1>,2:0]
+		[@7,19:18='<EOF>',<-1>,2:1]
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "";
+		public String grammarName = "L";
+
+		/**
+		 lexer grammar L;
+		 options { precompiledDFA=true; }
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 STRING_START : '"' -> pushMode(StringMode) ;
+		 WS : [ \t\n]+ -> skip ;
+		 COMMENT : '//' ~[\n]* -> channel(HIDDEN) ;
+		 mode StringMode;
+		 STRING_TEXT : ~["]+ ;
+		 STRING_END : '"' -> popMode ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
 	public static class QuoteTranslation extends BaseLexerTestDescriptor {
 		public String input = "\"";
 		/**
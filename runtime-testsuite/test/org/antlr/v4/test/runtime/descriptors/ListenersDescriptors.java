@@ -189,6 +189,203 @@ public class ListenersDescriptors {
 		public String output;
 	}
 
+	public static class StreamingEvents extends BaseParserTestDescriptor {
+		public String input = "x = 1 + y; z = 2";
+		/**
+		enter prog x
+		enter stat x
+		terminal x
+		terminal =
+		enter expr 1
+		enter atom 1
+		terminal 1
+		exit atom 1
+		terminal +
+		enter atom y
+		terminal y
+		exit atom y
+		exit expr 1
+		terminal ;
+		exit stat x
+		enter stat z
+		terminal z
+		terminal =
+		enter expr 2
+		enter atom 2
+		terminal 2
+		exit atom 2
+		exit expr 2
+		error <missing ';'>
+		exit stat z
+		terminal <EOF>
+		exit prog x
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = "line 1:16 missing ';' at '<EOF>'\n";
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		 class EventPrinter : public antlr4::tree::ParseTreeListener {
+		 public:
+		   EventPrinter(antlr4::Parser *parser) : _parser(parser) {}
+		   void visitTerminal(antlr4::tree::TerminalNode *node) override {
+		     std::cout \<\< "terminal " \<\< node->getText() \<\< std::endl;
+		   }
+		   void visitErrorNode(antlr4::tree::ErrorNode *node) override {
+		     std::cout \<\< "error " \<\< node->getText() \<\< std::endl;
+		   }
+		   void enterEveryRule(antlr4::ParserRuleContext *ctx) override {
+		     std::cout \<\< "enter " \<\< _parser->getRuleNames()[ctx->getRuleIndex()] \<\< " " \<\< ctx->start->getText() \<\< std::endl;
+		   }
+		   void exitEveryRule(antlr4::ParserRuleContext *ctx) override {
+		     std::cout \<\< "exit " \<\< _parser->getRuleNames()[ctx->getRuleIndex()] \<\< " " \<\< ctx->start->getText() \<\< std::endl;
+		   }
+		 private:
+		   antlr4::Parser *_parser;
+		 };
+		 }
+		 s
+		 @init {
+		 TParser streamingParser(getTokenStream());
+		 EventPrinter printer(&streamingParser);
+		 streamingParser.setStreamingMode(true);
+		 streamingParser.addParseListener(&printer);
+		 streamingParser.prog();
+		 }
+		   : EOF ;
+		 prog : stat+ EOF ;
+		 stat : ID '=' expr ';' ;
+		 expr : atom ('+' atom)* ;
+		 atom : INT
+		      | ID
+		      ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * Left recursive rules and labeled alternatives in streaming mode. The contexts stored in the labels must
+	 * not be recycled by the later invocations of the same rule.
+	 */
+	public static class StreamingLeftRecursion extends BaseParserTestDescriptor {
+		public String input = "x = 1 * 2 + 3, 4 + 5;";
+		/**
+		enter stat x
+		terminal x
+		terminal =
+		enter expr 1
+		terminal 1
+		exit expr 1 Int
+		enter expr 1 Mul
+		terminal *
+		enter expr 2
+		terminal 2
+		exit expr 2 Int
+		exit expr 1 Mul
+		enter expr 1 Add
+		terminal +
+		enter expr 3
+		terminal 3
+		exit expr 3 Int
+		exit expr 1 Add
+		terminal ,
+		enter expr 4
+		terminal 4
+		exit expr 4 Int
+		enter expr 4 Add
+		terminal +
+		enter expr 5
+		terminal 5
+		exit expr 5 Int
+		exit expr 4 Add
+		terminal ;
+		x = 5, 9
+		exit stat x
+		result 5 9
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		 class EventPrinter : public antlr4::tree::ParseTreeListener {
+		 public:
+		   EventPrinter(antlr4::Parser *parser) : _parser(parser) {}
+		   void visitTerminal(antlr4::tree::TerminalNode *node) override {
+		     std::cout \<\< "terminal " \<\< node->getText() \<\< std::endl;
+		   }
+		   void visitErrorNode(antlr4::tree::ErrorNode *node) override {
+		     std::cout \<\< "error " \<\< node->getText() \<\< std::endl;
+		   }
+		   void enterEveryRule(antlr4::ParserRuleContext *ctx) override {
+		     std::cout \<\< "enter " \<\< describe(ctx) \<\< std::endl;
+		   }
+		   void exitEveryRule(antlr4::ParserRuleContext *ctx) override {
+		     std::cout \<\< "exit " \<\< describe(ctx) \<\< std::endl;
+		   }
+		 private:
+		   antlr4::Parser *_parser;
+		   std::string describe(antlr4::ParserRuleContext *ctx) {
+		     std::string result = _parser->getRuleNames()[ctx->getRuleIndex()] + " " + ctx->start->getText();
+		     if (dynamic_cast\<MulContext *>(ctx) != nullptr) {
+		       result += " Mul";
+		     } else if (dynamic_cast\<AddContext *>(ctx) != nullptr) {
+		       result += " Add";
+		     } else if (dynamic_cast\<IntContext *>(ctx) != nullptr) {
+		       result += " Int";
+		     }
+		     return result;
+		   }
+		 };
+		 }
+		 s
+		 @init {
+		 TParser streamingParser(getTokenStream());
+		 EventPrinter printer(&streamingParser);
+		 streamingParser.setStreamingMode(true);
+		 streamingParser.addParseListener(&printer);
+		 StatContext *result = streamingParser.stat();
+		 std::cout \<\< "result " \<\< result->a->v \<\< " " \<\< result->b->v \<\< std::endl;
+		 }
+		   : EOF ;
+		 stat : ID '=' a=expr ',' b=expr ';' { std::cout \<\< $ID.text \<\< " = " \<\< $a.v \<\< ", " \<\< $b.v \<\< std::endl; } ;
+		 expr returns [int v]
+		   : l=expr '*' r=expr { $v = $l.v * $r.v; } # Mul
+		   | l=expr '+' r=expr { $v = $l.v + $r.v; } # Add
+		   | INT { $v = $INT.int; } # Int
+		   ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
 	public static abstract class TokenGetters extends BaseParserTestDescriptor {
 		public String errors = null;
 		public String startRule = "s";
@@ -144,6 +144,51 @@ public class ParseTreesDescriptors {
 
 	}
 
+	public static class PatternMatch extends BaseParserTestDescriptor {
+		public String input = "x = 1 + y; 3; y = x;";
+		public String output = "x 1+y\n" +
+			"-\n" +
+			"y x\n" +
+			"2\n";
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 s
+		 @init {
+		 <BuildParseTrees()>
+		 }
+		 @after {
+		 antlr4::tree::pattern::ParseTreePattern pattern = compileParseTreePattern("\<ID> = \<e:expr>;", RuleStat);
+		 for (auto *stat : $ctx->stat()) {
+		   antlr4::tree::pattern::ParseTreeMatch match = pattern.match(stat);
+		   std::cout \<\< (match.succeeded() ? match.get("ID")->getText() + " " + match.get("e")->getText() : "-") \<\< std::endl;
+		 }
+		 std::cout \<\< pattern.findAll($ctx, "//stat").size() \<\< std::endl;
+		 }
+		   : stat+ EOF ;
+		 stat : ID '=' expr ';'
+		      | expr ';'
+		      ;
+		 expr : expr '+' expr
+		      | ID
+		      | INT
+		      ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
 	public static class RuleRef extends BaseParserTestDescriptor {
 		public String input = "yx";
 		public String output = "(a (b y) x)\n";
@@ -304,4 +349,169 @@ public class ParseTreesDescriptors {
 		public String grammar;
 
 	}
+
+	/**
+	 * Contexts with more than 8 children index them for the token and rule context getters (C++ only). The index
+	 * must not be used after the children list was changed directly, also not when the number of children
+	 * matches the index again.
+	 */
+	public static class ChildIndex extends BaseParserTestDescriptor {
+		public String input = "a 1 b 2 c 3 d 4 e";
+		/**
+		IDs: a b c d e
+		INT 1: 2
+		IDs: e d c b a
+		INT 1: 3
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		 template\<typename Context>
+		 static void printChildren(Context *ctx) {
+		   std::cout \<\< "IDs:";
+		   for (auto *node : ctx->ID()) {
+		     std::cout \<\< " " \<\< node->getText();
+		   }
+		   std::cout \<\< std::endl;
+		   std::cout \<\< "INT 1: " \<\< ctx->INT(1)->getText() \<\< std::endl;
+		 }
+		 }
+		 s : a EOF ;
+		 a
+		 @after {
+		 printChildren($ctx);
+		 std::vector\<antlr4::tree::ParseTree *> nodes = $ctx->children;
+		 $ctx->removeLastChild();
+		 $ctx->children.clear();
+		 for (auto iterator = nodes.rbegin(); iterator != nodes.rend(); ++iterator) {
+		   $ctx->addChild(static_cast\<antlr4::tree::TerminalNode *>(*iterator));
+		 }
+		 printChildren($ctx);
+		 }
+		   : (ID | INT)+ ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * Converts a parse tree to a FlatParseTree and compares it with the original, also after saving it to a
+	 * buffer and to a file and reading it back. Every truncation of the saved data must be rejected.
+	 */
+	public static class FlatParseTree extends BaseParserTestDescriptor {
+		public String input = "x = 1 + 2 * y; // c\nz = (3 - x) / 4;\n";
+		/**
+		nodes: 33, tokens: 19
+		text: x=1+2*y;z=(3-x)/4;<EOF>
+		converted tree differences: 0
+		saved tree differences: 0
+		loaded tree differences: 0
+		truncated data accepted 0 times
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "prog";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		   // Returns the number of differences between the subtree of a flat tree node and the original subtree.
+		   static size_t compare(const antlr4::tree::FlatParseTree &flat, size_t node, antlr4::tree::ParseTree *t) {
+		     size_t differences = 0;
+		     antlr4::tree::TerminalNode *terminal = dynamic_cast\<antlr4::tree::TerminalNode *>(t);
+		     if (terminal != nullptr) {
+		       size_t token = flat.getToken(node);
+		       if (!flat.isTerminal(node) || flat.getTokenType(token) != terminal->getSymbol()->getType() ||
+		           flat.getTokenText(token) != terminal->getText() ||
+		           flat.getTokenIndex(token) != terminal->getSymbol()->getTokenIndex()) {
+		         ++differences;
+		       }
+		     } else if (flat.isTerminal(node) ||
+		                flat.getRuleIndex(node) != static_cast\<antlr4::ParserRuleContext *>(t)->getRuleIndex()) {
+		       ++differences;
+		     }
+		     if (flat.getText(node) != t->getText() || flat.getChildCount(node) != t->children.size()) {
+		       return differences + 1;
+		     }
+		     size_t i = 0;
+		     size_t sibling = flat.getFirstChild(node);
+		     for (size_t child : flat.getChildren(node)) {
+		       if (child != sibling || flat.getParent(child) != node) {
+		         ++differences;
+		       }
+		       differences += compare(flat, child, t->children[i++]);
+		       sibling = flat.getNextSibling(child);
+		     }
+		     if (sibling != INVALID_INDEX) {
+		       ++differences;
+		     }
+		     return differences;
+		   }
+		 }
+		 prog
+		 @after {
+		 antlr4::tree::FlatParseTree flat($ctx);
+		 std::cout \<\< "nodes: " \<\< flat.size() \<\< ", tokens: " \<\< flat.getTokenCount() \<\< std::endl;
+		 std::cout \<\< "text: " \<\< flat.getText(0) \<\< std::endl;
+		 std::cout \<\< "converted tree differences: " \<\< compare(flat, 0, $ctx) \<\< std::endl;
+		 std::stringstream stream;
+		 flat.save(stream);
+		 std::string bytes = stream.str();
+		 antlr4::tree::FlatParseTree copy(bytes.data(), bytes.size());
+		 std::cout \<\< "saved tree differences: " \<\< compare(copy, 0, $ctx) \<\< std::endl;
+		 {
+		   std::ofstream file("flat.bin", std::ios::binary);
+		   file \<\< bytes;
+		 }
+		 antlr4::tree::FlatParseTree loaded = antlr4::tree::FlatParseTree::load("flat.bin");
+		 std::cout \<\< "loaded tree differences: " \<\< compare(loaded, 0, $ctx) \<\< std::endl;
+		 size_t accepted = 0;
+		 for (size_t size = 0; size \< bytes.size(); ++size) {
+		   try {
+		     antlr4::tree::FlatParseTree truncated(bytes.data(), size);
+		     ++accepted;
+		   } catch (antlr4::IllegalArgumentException &) {
+		   }
+		 }
+		 std::cout \<\< "truncated data accepted " \<\< accepted \<\< " times" \<\< std::endl;
+		 }
+		   : stat+ EOF ;
+		 stat : ID '=' expr ';' ;
+		 expr : expr ('*'|'/') expr
+		      | expr ('+'|'-') expr
+		      | '(' expr ')'
+		      | ID
+		      | INT
+		      ;
+		 ID : [a-z]+ ;
+		 INT : [0-9]+ ;
+		 COMMENT : '//' ~[\n]* -> channel(HIDDEN) ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
 }
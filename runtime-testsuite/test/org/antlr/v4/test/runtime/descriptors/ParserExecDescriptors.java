@@ -917,4 +917,561 @@ public class ParserExecDescriptors {
 		@CommentHasStringValue
 		public String grammar;
 	}
+
+	/**
+	 * Converts the interpreter data written by the tool into the binary form of the C++ runtime, reads it back and
+	 * compares it with the text form. Truncated data and a name count larger than the data must be rejected.
+	 */
+	public static class BinaryInterpreterData extends BaseParserTestDescriptor {
+		public String input = "abc";
+		/**
+		T.interp:
+		vocabulary equal
+		rule names equal
+		channels equal
+		modes equal
+		atn equal
+		truncated data accepted 0 times
+		corrupt name count rejected
+		TLexer.interp:
+		vocabulary equal
+		rule names equal
+		channels equal
+		modes equal
+		atn equal
+		truncated data accepted 0 times
+		corrupt name count rejected
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		   static void checkBinaryInterpreterData(const std::string &fileName) {
+		     std::ifstream text(fileName);
+		     std::stringstream binary;
+		     antlr4::misc::InterpreterDataReader::convertToBinary(text, binary);
+		     std::string bytes = binary.str();
+		     antlr4::misc::InterpreterData expected = antlr4::misc::InterpreterDataReader::parseFile(fileName);
+		     antlr4::misc::InterpreterData actual = antlr4::misc::InterpreterDataReader::parseBinary(bytes.data(), bytes.size());
+		     bool sameVocabulary = actual.vocabulary.getMaxTokenType() == expected.vocabulary.getMaxTokenType();
+		     for (size_t i = 0; i \<= expected.vocabulary.getMaxTokenType(); ++i) {
+		       sameVocabulary = sameVocabulary && actual.vocabulary.getLiteralName(i) == expected.vocabulary.getLiteralName(i) &&
+		         actual.vocabulary.getSymbolicName(i) == expected.vocabulary.getSymbolicName(i);
+		     }
+		     std::cout \<\< fileName \<\< ":" \<\< std::endl;
+		     std::cout \<\< "vocabulary " \<\< (sameVocabulary ? "equal" : "differs") \<\< std::endl;
+		     std::cout \<\< "rule names " \<\< (actual.ruleNames == expected.ruleNames ? "equal" : "differ") \<\< std::endl;
+		     std::cout \<\< "channels " \<\< (actual.channels == expected.channels ? "equal" : "differ") \<\< std::endl;
+		     std::cout \<\< "modes " \<\< (actual.modes == expected.modes ? "equal" : "differ") \<\< std::endl;
+		     std::cout \<\< "atn " \<\< (antlr4::atn::ATNSerializer::getSerialized(&actual.atn) ==
+		       antlr4::atn::ATNSerializer::getSerialized(&expected.atn) ? "equal" : "differs") \<\< std::endl;
+		     size_t accepted = 0;
+		     for (size_t size = 0; size \< bytes.size(); ++size) {
+		       try {
+		         antlr4::misc::InterpreterDataReader::parseBinary(bytes.data(), size);
+		         ++accepted;
+		       } catch (antlr4::IllegalArgumentException &) {
+		       }
+		     }
+		     std::cout \<\< "truncated data accepted " \<\< accepted \<\< " times" \<\< std::endl;
+		     // A name count which needs more bytes than there are (and overflows when multiplied on 32 bit platforms).
+		     std::string corrupt = bytes;
+		     corrupt.replace(12, 4, 4, static_cast\<char>(0xFF));
+		     try {
+		       antlr4::misc::InterpreterDataReader::parseBinary(corrupt.data(), corrupt.size());
+		       std::cout \<\< "corrupt name count accepted" \<\< std::endl;
+		     } catch (antlr4::IllegalArgumentException &) {
+		       std::cout \<\< "corrupt name count rejected" \<\< std::endl;
+		     }
+		   }
+		 }
+		 s
+		 @init {
+		 checkBinaryInterpreterData("T.interp");
+		 checkBinaryInterpreterData("TLexer.interp");
+		 }
+		   : ID EOF ;
+		 ID : [a-z]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * Lexes an input in several chunks on worker threads and compares the result with the serial lexer,
+	 * including the syntax errors and the EOF token returned again after the end.
+	 */
+	public static class ParallelTokenSource extends BaseParserTestDescriptor {
+		public String input = "abc";
+		/**
+		chunks: several
+		tokens: equal
+		syntax errors: 4 (serial 4)
+		EOF after the end: 3 of 3
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::postinclude {
+		 #include "TLexer.h"
+		 }
+		 @parser::members {
+		   static std::vector\<std::string> lexAll(antlr4::TokenSource *source) {
+		     antlr4::CommonTokenStream tokens(source);
+		     tokens.fill();
+		     std::vector\<std::string> result;
+		     for (antlr4::Token *token : tokens.getTokens()) {
+		       result.push_back(token->toString());
+		     }
+		     return result;
+		   }
+		   static void checkParallelTokenSource(const std::string &text) {
+		     antlr4::ANTLRInputStream serialInput(text);
+		     TLexer serialLexer(&serialInput);
+		     serialLexer.removeErrorListeners();
+		     std::vector\<std::string> expected = lexAll(&serialLexer);
+		     antlr4::ANTLRInputStream input(text);
+		     TLexer lexer(&input);
+		     lexer.removeErrorListeners();
+		     antlr4::ParallelTokenSource parallel(&lexer, [](antlr4::CharStream *chunkInput) {
+		       return std::unique_ptr\<antlr4::Lexer>(new TLexer(chunkInput));
+		     }, 4);
+		     parallel.setMinimumChunkSize(64);
+		     std::vector\<std::string> actual = lexAll(&parallel);
+		     std::cout \<\< "chunks: " \<\< (parallel.getChunkCount() > 1 ? "several" : "one") \<\< std::endl;
+		     std::cout \<\< "tokens: " \<\< (actual == expected ? "equal" : "differ") \<\< std::endl;
+		     std::cout \<\< "syntax errors: " \<\< parallel.getNumberOfSyntaxErrors() \<\< " (serial " \<\< serialLexer.getNumberOfSyntaxErrors() \<\< ")" \<\< std::endl;
+		     size_t eofCount = 0;
+		     for (size_t i = 0; i \< 3; ++i) {
+		       std::unique_ptr\<antlr4::Token> token = parallel.nextToken();
+		       if (token != nullptr && token->getType() == antlr4::Token::EOF) {
+		         ++eofCount;
+		       }
+		     }
+		     std::cout \<\< "EOF after the end: " \<\< eofCount \<\< " of 3" \<\< std::endl;
+		   }
+		 }
+		 s
+		 @init {
+		 std::string text;
+		 for (int i = 0; i \< 200; ++i) {
+		   text += "a" + std::to_string(i) + " = " + std::to_string(i * 7) + " + b; // line " + std::to_string(i) + "\n";
+		   if (i % 50 == 25) {
+		     text += "# ";
+		   }
+		 }
+		 checkParallelTokenSource(text);
+		 }
+		   : ID EOF ;
+		 ID : [a-z] [a-z0-9]* ;
+		 INT : [0-9]+ ;
+		 EQ : '=' ;
+		 PLUS : '+' ;
+		 SEMI : ';' ;
+		 LINE_COMMENT : '//' ~[\n]* -> channel(HIDDEN) ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * Parses with the lexer running on a producer thread, using a ring buffer small enough to make both
+	 * sides wait for each other, and compares the result with a parse from a CommonTokenStream.
+	 */
+	public static class ConcurrentTokenStream extends BaseParserTestDescriptor {
+		public String input = "abc";
+		/**
+		tree: equal
+		tokens: 2001 equal
+		LT(1) at the end: <EOF>, <EOF>
+		LT(1) after seek(0): a0
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::postinclude {
+		 #include "TLexer.h"
+		 }
+		 @parser::members {
+		   static std::string parseWith(antlr4::TokenStream *tokens) {
+		     TParser parser(tokens);
+		     return parser.items()->toStringTree(&parser);
+		   }
+		   static std::vector\<std::string> tokenStrings(antlr4::BufferedTokenStream &tokens) {
+		     std::vector\<std::string> result;
+		     for (antlr4::Token *token : tokens.getTokens()) {
+		       result.push_back(token->toString());
+		     }
+		     return result;
+		   }
+		 }
+		 s
+		 @init {
+		 std::string text;
+		 for (int i = 0; i \< 1000; ++i) {
+		   text += "a" + std::to_string(i) + " " + std::to_string(i) + "\n";
+		 }
+		 antlr4::ANTLRInputStream serialInput(text);
+		 TLexer serialLexer(&serialInput);
+		 antlr4::CommonTokenStream serialTokens(&serialLexer);
+		 std::string expected = parseWith(&serialTokens);
+		 antlr4::ANTLRInputStream concurrentInput(text);
+		 TLexer concurrentLexer(&concurrentInput);
+		 antlr4::ConcurrentTokenStream concurrentTokens(&concurrentLexer, antlr4::Token::DEFAULT_CHANNEL, 4);
+		 std::string actual = parseWith(&concurrentTokens);
+		 std::cout \<\< "tree: " \<\< (actual == expected ? "equal" : "differs") \<\< std::endl;
+		 std::cout \<\< "tokens: " \<\< concurrentTokens.size() \<\< " " \<\<
+		   (tokenStrings(concurrentTokens) == tokenStrings(serialTokens) ? "equal" : "differ") \<\< std::endl;
+		 std::cout \<\< "LT(1) at the end: " \<\< concurrentTokens.LT(1)->getText() \<\< ", " \<\< concurrentTokens.LT(1)->getText() \<\< std::endl;
+		 concurrentTokens.seek(0);
+		 std::cout \<\< "LT(1) after seek(0): " \<\< concurrentTokens.LT(1)->getText() \<\< std::endl;
+		 }
+		   : ID EOF ;
+		 items : (ID | INT)* EOF ;
+		 ID : [a-z] [a-z0-9]* ;
+		 INT : [0-9]+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * The cases of the Java TokenStreamRewriter tests (without the insertAfter ordering fixes, which the
+	 * C++ rewriter does not have), plus many operations added in reverse order.
+	 */
+	public static class TokenStreamRewriter extends BaseParserTestDescriptor {
+		public String input = "abc";
+		/**
+		abc -> 0abc
+		abc -> abcx
+		abc -> axbxc
+		abc -> ayc
+		abc -> _ayc
+		abc -> ac
+		abc -> insert op <InsertBeforeOp@b:"0"> within boundaries of previous <ReplaceOp@a..c:"x">
+		abc -> 0xbc
+		abc -> yxzbc
+		abc -> abyx
+		abc -> abxy
+		abcccba -> abyxba
+		abcccba -> insert op <InsertBeforeOp@c:"y"> within boundaries of previous <ReplaceOp@c..c:"x">
+		abcccba -> abxyba
+		abcccba -> replace op boundaries of <ReplaceOp@c..b:"foo"> overlap with previous <ReplaceOp@c..c:"xyz">
+		abcccba -> replace op boundaries of <ReplaceOp@b..c:"foo"> overlap with previous <ReplaceOp@c..c:"xyz">
+		abcba -> fooa
+		abc -> yazxbc
+		abc -> zfoo
+		abc -> z
+		abcc -> bar
+		abcc -> replace op boundaries of <ReplaceOp@b..c:"foo"> overlap with previous <ReplaceOp@a..c:"bar">
+		abcc -> barc
+		abcc -> abar
+		abcc -> afooc
+		abc -> afoofoo
+		abcc -> axbfoo
+		abc -> aby
+		1000 groups: as expected
+		groups 2 and 3: <ax<axc
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::postinclude {
+		 #include "TLexer.h"
+		 }
+		 @parser::members {
+		   static void rewrite(const std::string &text, std::function\<void (antlr4::TokenStreamRewriter &)> edit) {
+		     antlr4::ANTLRInputStream input(text);
+		     TLexer lexer(&input);
+		     antlr4::CommonTokenStream tokens(&lexer);
+		     tokens.fill();
+		     antlr4::TokenStreamRewriter rewriter(&tokens);
+		     edit(rewriter);
+		     std::string result;
+		     try {
+		       result = rewriter.getText();
+		     } catch (antlr4::IllegalArgumentException &e) {
+		       result = e.what();
+		     }
+		     std::cout \<\< text \<\< " -> " \<\< result \<\< std::endl;
+		   }
+		 }
+		 s
+		 @init {
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(r.getTokenStream()->get(0), "0"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertAfter(2, "x"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(1, "x"); r.insertAfter(1, "x"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, "x"); r.replace(1, "y"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(r.getTokenStream()->get(0), "_"); r.replace(1, "x"); r.replace(1, "y"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, "x"); r.Delete(1); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(0, 2, "x"); r.insertBefore(1, "0"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(r.getTokenStream()->get(0), "0"); r.replace(r.getTokenStream()->get(0), "x"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(r.getTokenStream()->get(0), "x"); r.insertBefore(r.getTokenStream()->get(0), "y"); r.replace(r.getTokenStream()->get(0), "z"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(2, "x"); r.insertBefore(2, "y"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(2, "x"); r.insertAfter(2, "y"); });
+		 rewrite("abcccba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 4, "x"); r.insertBefore(2, "y"); });
+		 rewrite("abcccba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 4, "x"); r.insertBefore(4, "y"); });
+		 rewrite("abcccba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 4, "x"); r.insertAfter(4, "y"); });
+		 rewrite("abcccba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 4, "xyz"); r.replace(3, 5, "foo"); });
+		 rewrite("abcccba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 4, "xyz"); r.replace(1, 3, "foo"); });
+		 rewrite("abcba", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 2, "xyz"); r.replace(0, 3, "foo"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(1, "x"); r.insertBefore(r.getTokenStream()->get(0), "y"); r.insertBefore(1, "z"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.replace(0, 2, "foo"); r.insertBefore(r.getTokenStream()->get(0), "z"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.Delete(0, 2); r.insertBefore(r.getTokenStream()->get(0), "z"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, 2, "foo"); r.replace(0, 3, "bar"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(0, 3, "bar"); r.replace(1, 2, "foo"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, 2, "foo"); r.replace(0, 2, "bar"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, 2, "foo"); r.replace(1, 3, "bar"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(1, 2, "foo"); r.replace(1, 2, "foo"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(1, "foo"); r.replace(1, 2, "foo"); });
+		 rewrite("abcc", [](antlr4::TokenStreamRewriter &r) { r.replace(2, 3, "foo"); r.insertBefore(1, "x"); });
+		 rewrite("abc", [](antlr4::TokenStreamRewriter &r) { r.insertBefore(2, "y"); r.Delete(2); });
+		 // Many operations, added in reverse order.
+		 std::string text;
+		 std::string expected;
+		 for (size_t i = 0; i \< 1000; ++i) {
+		   text += "abc";
+		   expected += i % 2 == 0 ? "\<ax" : "\<axc";
+		 }
+		 antlr4::ANTLRInputStream input(text);
+		 TLexer lexer(&input);
+		 antlr4::CommonTokenStream tokens(&lexer);
+		 tokens.fill();
+		 antlr4::TokenStreamRewriter rewriter(&tokens);
+		 for (size_t i = 1000; i-- > 0;) {
+		   if (i % 2 == 0) {
+		     rewriter.Delete(3 * i + 2);
+		   }
+		   rewriter.replace(3 * i + 1, "x");
+		   rewriter.insertBefore(3 * i, "\<");
+		 }
+		 std::cout \<\< "1000 groups: " \<\< (rewriter.getText() == expected ? "as expected" : "differs") \<\< std::endl;
+		 std::cout \<\< "groups 2 and 3: " \<\< rewriter.getText(antlr4::misc::Interval(static_cast\<size_t>(6), static_cast\<size_t>(11))) \<\< std::endl;
+		 }
+		   : (A | B | C)* EOF ;
+		 A : 'a' ;
+		 B : 'b' ;
+		 C : 'c' ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * The paths of the XPath tool tests (except those containing a comment end), evaluated with a compiled
+	 * XPath with and without an index of the tree. Unlike the Java target, nodes reached in several ways are
+	 * returned once per way (see //expr//ID).
+	 */
+	public static class XPathIndex extends BaseParserTestDescriptor {
+		public String input = "def f(x,y) { x = 3+4; y; ; }\ndef g(x) { return 1+2*x; }\n";
+		/**
+		/prog/func -> [func, func]
+		/prog/* -> [func, func]
+		prog -> [prog]
+		/prog -> [prog]
+		/* -> [prog]
+		* -> [prog]
+		//ID -> [f, x, y, x, y, g, x, x]
+		//expr/primary/ID -> [y, x]
+		//body//ID -> [x, y, x]
+		//'return' -> [return]
+		//RETURN -> [return]
+		//primary/* -> [3, 4, y, 1, 2, x]
+		/prog/func/'def' -> [def, def]
+		//stat/';' -> [;, ;, ;, ;]
+		//expr/primary/!ID -> [3, 4, 1, 2]
+		//expr/!primary -> [expr, expr, expr, expr, expr, expr]
+		//!* -> []
+		/!* -> []
+		//expr//ID -> [y, x, x, x]
+		IDs in func f -> [f, x, y, x, y]
+		IDs in func g -> [g, x, x]
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "prog";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::members {
+		   static std::string join(antlr4::Parser *parser, const std::vector\<antlr4::tree::ParseTree *> &nodes) {
+		     std::string result = "[";
+		     for (size_t i = 0; i \< nodes.size(); ++i) {
+		       antlr4::ParserRuleContext *ctx = dynamic_cast\<antlr4::ParserRuleContext *>(nodes[i]);
+		       result += i == 0 ? "" : ", ";
+		       result += ctx != nullptr ? parser->getRuleNames()[ctx->getRuleIndex()] : nodes[i]->getText();
+		     }
+		     return result + "]";
+		   }
+		 }
+		 prog
+		 @after {
+		 std::vector\<std::string> paths = {
+		   "/prog/func", "/prog/*", "prog", "/prog", "/*", "*", "//ID", "//expr/primary/ID", "//body//ID",
+		   "//'return'", "//RETURN", "//primary/*", "/prog/func/'def'", "//stat/';'",
+		   "//expr/primary/!ID", "//expr/!primary", "//!*", "/!*", "//expr//ID"
+		 };
+		 antlr4::tree::xpath::XPathIndex index($ctx);
+		 for (const std::string &path : paths) {
+		   antlr4::tree::xpath::XPath xpath(this, path);
+		   std::vector\<antlr4::tree::ParseTree *> nodes = xpath.evaluate($ctx);
+		   std::cout \<\< path \<\< " -> " \<\< join(this, nodes);
+		   if (xpath.evaluate($ctx, index) != nodes) {
+		     std::cout \<\< " (differs with the index)";
+		   }
+		   std::cout \<\< std::endl;
+		 }
+		 // Subtrees of the indexed tree.
+		 antlr4::tree::xpath::XPath ids(this, "//ID");
+		 for (antlr4::tree::ParseTree *func : antlr4::tree::xpath::XPath(this, "//func").evaluate($ctx)) {
+		   std::cout \<\< "IDs in func " \<\< func->children[1]->getText() \<\< " -> " \<\< join(this, ids.evaluate(func, index)) \<\< std::endl;
+		 }
+		 }
+		   : func+ ;
+		 func : 'def' ID '(' arg (',' arg)* ')' body ;
+		 body : '{' stat+ '}' ;
+		 arg : ID ;
+		 stat : expr ';'          # printExpr
+		      | ID '=' expr ';'   # assign
+		      | 'return' expr ';' # ret
+		      | ';'               # blank
+		      ;
+		 expr : expr ('*'|'/') expr # MulDiv
+		      | expr ('+'|'-') expr # AddSub
+		      | primary             # prim
+		      ;
+		 primary : INT          # int
+		         | ID           # id
+		         | '(' expr ')' # parens
+		         ;
+		 MUL : '*' ;
+		 DIV : '/' ;
+		 ADD : '+' ;
+		 SUB : '-' ;
+		 RETURN : 'return' ;
+		 ID : [a-zA-Z]+ ;
+		 INT : [0-9]+ ;
+		 NEWLINE : '\r'? '\n' -> skip ;
+		 WS : [ \t]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	/**
+	 * Serializes the generated ATNs, deserializes them and serializes the result again. The lexer ATN has a set
+	 * of code points beyond U+FFFF. The ATN with bypass alternatives is created from the serialized parser ATN.
+	 */
+	public static class ATNSerializationRoundTrip extends BaseParserTestDescriptor {
+		public String input = "abc";
+		/**
+		parser ATN round trip: equal
+		lexer ATN round trip: equal
+		bypass ATN created once: yes
+		bypass ATN has 3 more states per rule: yes
+		 */
+		@CommentHasStringValue
+		public String output;
+
+		public String errors = null;
+		public String startRule = "s";
+		public String grammarName = "T";
+
+		/**
+		 grammar T;
+		 @parser::postinclude {
+		 #include "TLexer.h"
+		 }
+		 @parser::members {
+		   static void checkRoundTrip(const std::string &name, const antlr4::atn::ATN &atn) {
+		     std::vector\<size_t> serialized = antlr4::atn::ATNSerializer::getSerialized(const_cast\<antlr4::atn::ATN *>(&atn));
+		     std::vector\<uint16_t> data;
+		     for (size_t value : serialized) {
+		       data.push_back(static_cast\<uint16_t>(value));
+		     }
+		     antlr4::atn::ATNDeserializer deserializer;
+		     antlr4::atn::ATN copy = deserializer.deserialize(data);
+		     bool equal = copy.states.size() == atn.states.size() && antlr4::atn::ATNSerializer::getSerialized(&copy) == serialized;
+		     std::cout \<\< name \<\< " ATN round trip: " \<\< (equal ? "equal" : "differs") \<\< std::endl;
+		   }
+		 }
+		 s
+		 @init {
+		 antlr4::ANTLRInputStream input("");
+		 TLexer lexer(&input);
+		 checkRoundTrip("parser", getATN());
+		 checkRoundTrip("lexer", lexer.getATN());
+		 const antlr4::atn::ATN &bypass = getATN().getATNWithBypassAlts();
+		 std::cout \<\< "bypass ATN created once: " \<\< (&bypass == &getATN().getATNWithBypassAlts() ? "yes" : "no") \<\< std::endl;
+		 std::cout \<\< "bypass ATN has 3 more states per rule: " \<\<
+		   (bypass.states.size() == getATN().states.size() + 3 * getATN().ruleToStartState.size() ? "yes" : "no") \<\< std::endl;
+		 }
+		   : ID EOF ;
+		 ID : [a-z]+ ;
+		 EMOJI : ('\\u{1F600}'..'\\u{1F64F}')+ ;
+		 WS : [ \t\n]+ -> skip ;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
 }
@@ -239,4 +239,95 @@ public class PerformanceDescriptors {
 		@CommentHasStringValue
 		public String input;
 	}
+
+	/**
+	 * Expressions with many precedence levels and calls make the ATN closures of the left recursive rule large
+	 * and full of precedence predicates, which stresses the hashing and merging of configurations, prediction
+	 * contexts and semantic contexts.
+	 */
+	public static abstract class ClosureHeavyPrediction extends BaseParserTestDescriptor {
+		public String output = null;
+		public String errors = null;
+		public String startRule = "program";
+		public String grammarName = "Expr";
+
+		/**
+		 grammar Expr;
+
+		 program: stat+ EOF;
+
+		 stat
+		 	: ID '=' expr ';'
+		 	| expr ';'
+		 	;
+
+		 expr
+		 	: expr ('*'|'/') expr
+		 	| expr ('+'|'-') expr
+		 	| expr ('<'|'>') expr
+		 	| expr '==' expr
+		 	| expr 'and' expr
+		 	| expr 'or' expr
+		 	| \<assoc=right> expr '?' expr ':' expr
+		 	| '-' expr
+		 	| 'not' expr
+		 	| '(' expr ')'
+		 	| ID '(' args? ')'
+		 	| ID
+		 	| INT
+		 	;
+
+		 args: expr (',' expr)*;
+
+		 ID: [a-zA-Z_][a-zA-Z_0-9]*;
+		 INT: [0-9]+;
+		 WS: [ \t\n\r\f]+ -> skip;
+		 */
+		@CommentHasStringValue
+		public String grammar;
+
+		@Override
+		public boolean ignore(String targetName) {
+			return !targetName.equals("Cpp");
+		}
+	}
+
+	public static class ClosureHeavyPrediction_1 extends ClosureHeavyPrediction {
+		/**
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 a = f(x, y * 2 + 3, -z) * (b + c) / d - e;
+		 x < y == not z and a or b ? c : d;
+		 g(h(i(j(k, 1), 2), 3), 4) + 1 * 2 - 3 / 4 > 5;
+		 not (a and b or c) ? -1 : (2 + 3) * f(4, not x);
+		 */
+		@CommentHasStringValue
+		public String input;
+	}
+
+	public static class ClosureHeavyPrediction_2 extends ClosureHeavyPrediction {
+		/**
+		 f(a + f(a + f(a + f(a + f(a + f(a + f(a + f(a + f(a + f(a + f(a + f(a + x * b) * b) * b) * b) * b) * b) * b) * b) * b) * b) * b) * b) ? ((((((((y or z) or z) or z) or z) or z) or z) or z) or z) : -w;
+		 */
+		@CommentHasStringValue
+		public String input;
+	}
 }
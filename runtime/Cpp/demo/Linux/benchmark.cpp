@@ -0,0 +1,182 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+//
+//  benchmark.cpp
+//  antlr4-benchmark
+//
+//  Measures the runtime with the demo grammar: lexer throughput with and without batched token fetching,
+//  the generated parser against a ParserInterpreter for the same ATN, and cold (closure heavy) predictions.
+//  Without arguments a generated input is used, otherwise the content of the given file.
+//
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "antlr4-runtime.h"
+#include "TLexer.h"
+#include "TParser.h"
+
+using namespace antlrcpptest;
+using namespace antlr4;
+
+namespace {
+
+  // The lexer with batched token fetching (Lexer::nextTokens()) switched on or off.
+  class BenchmarkLexer : public TLexer {
+  public:
+    BenchmarkLexer(CharStream *input, bool batched) : TLexer(input) {
+      _batchMatchingType = batched ? &typeid(BenchmarkLexer) : nullptr;
+    }
+  };
+
+  std::string generateExpression(std::mt19937 &random, int depth) {
+    if (depth == 0) {
+      switch (random() % 3) {
+        case 0:
+          return "a" + std::to_string(random() % 100);
+        case 1:
+          return std::to_string(random() % 1000);
+        default:
+          return "\"s\"";
+      }
+    }
+
+    switch (random() % 6) {
+      case 0:
+        return generateExpression(random, depth - 1) + " * " + generateExpression(random, depth - 1);
+      case 1:
+        return generateExpression(random, depth - 1) + " + " + generateExpression(random, depth - 1);
+      case 2:
+        return "(" + generateExpression(random, depth - 1) + ")";
+      case 3:
+        return generateExpression(random, depth - 1) + " ? " + generateExpression(random, depth - 1) + " : " +
+          generateExpression(random, depth - 1);
+      case 4:
+        return "return " + generateExpression(random, depth - 1);
+      default:
+        return generateExpression(random, 0);
+    }
+  }
+
+  // Statements with nested expressions of all operators, which make the closures of the left recursive expr rule
+  // large and full of precedence predicates.
+  std::string generateInput(size_t statements) {
+    std::mt19937 random(42);
+    std::string result;
+    for (size_t i = 0; i < statements; ++i) {
+      if (random() % 2 == 0) {
+        result += "a" + std::to_string(i) + " = ";
+      }
+      result += generateExpression(random, 5) + ";\n";
+    }
+    return result;
+  }
+
+  template<typename Function>
+  double measure(size_t iterations, Function function) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      function();
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / static_cast<double>(iterations);
+  }
+
+  double measureLexer(const std::string &text, bool batched, size_t &tokenCount) {
+    return measure(10, [&] {
+      ANTLRInputStream input(text);
+      BenchmarkLexer lexer(&input, batched);
+      CommonTokenStream tokens(&lexer);
+      tokens.fill();
+      tokenCount = tokens.size();
+    });
+  }
+
+}
+
+int main(int argc, const char **argv) {
+  std::string text;
+  if (argc > 1) {
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.good()) {
+      std::cerr << "Cannot read " << argv[1] << std::endl;
+      return 1;
+    }
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  } else {
+    text = generateInput(2000);
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+
+  size_t tokenCount = 0;
+  double single = measureLexer(text, false, tokenCount);
+  double batched = measureLexer(text, true, tokenCount);
+  std::cout << "Input: " << text.size() << " characters, " << tokenCount << " tokens" << std::endl;
+  std::cout << "Lexer, one token at a time: " << tokenCount / single / 1e6 << " M tokens/s" << std::endl;
+  std::cout << "Lexer, batched:             " << tokenCount / batched / 1e6 << " M tokens/s" << std::endl;
+
+  ANTLRInputStream input(text);
+  TLexer lexer(&input);
+  CommonTokenStream tokens(&lexer);
+  tokens.fill();
+
+  TParser parser(&tokens);
+  parser.removeErrorListeners();
+  auto parseGenerated = [&] {
+    parser.reset(); // Also rewinds the token stream.
+    parser.main();
+  };
+  parseGenerated(); // Warm up the DFA.
+  if (parser.getNumberOfSyntaxErrors() > 0) {
+    std::cout << "Warning: the input has " << parser.getNumberOfSyntaxErrors() << " syntax errors" << std::endl;
+  }
+  double generated = measure(10, parseGenerated);
+  std::cout << "Parser, generated:                 " << generated * 1e3 << " ms" << std::endl;
+
+  ParserInterpreter interpreter(parser.getGrammarFileName(), parser.getVocabulary(), parser.getRuleNames(),
+                                parser.getATN(), &tokens);
+  interpreter.removeErrorListeners();
+  auto parseInterpreted = [&] {
+    interpreter.reset();
+    interpreter.parse(TParser::RuleMain);
+  };
+  parseInterpreted();
+  double interpreted = measure(10, parseInterpreted);
+  std::cout << "Parser, interpreted:               " << interpreted * 1e3 << " ms ("
+    << interpreted / generated << "x generated)" << std::endl;
+
+  // A new interpreter per parse, as in a rule engine, which shares the DFA of all earlier ones.
+  std::vector<dfa::DFA> decisionToDFA;
+  for (size_t i = 0; i < parser.getATN().getNumberOfDecisions(); ++i) {
+    decisionToDFA.emplace_back(parser.getATN().getDecisionState(i), i);
+  }
+  atn::PredictionContextCache sharedContextCache;
+  auto parseShared = [&] {
+    ParserInterpreter sharedInterpreter(parser.getGrammarFileName(), parser.getVocabulary(), parser.getRuleNames(),
+                                        parser.getATN(), &tokens, decisionToDFA, sharedContextCache);
+    sharedInterpreter.removeErrorListeners();
+    tokens.seek(0);
+    sharedInterpreter.parse(TParser::RuleMain);
+  };
+  parseShared();
+  double shared = measure(10, parseShared);
+  std::cout << "Parser, interpreted, new instance: " << shared * 1e3 << " ms ("
+    << shared / generated << "x generated)" << std::endl;
+
+  // Every parse starts with empty DFAs, so all predictions run the closure computations again.
+  auto parseCold = [&] {
+    parser.getInterpreter<atn::ParserATNSimulator>()->clearDFA();
+    parseGenerated();
+  };
+  double cold = measure(3, parseCold);
+  std::cout << "Parser, generated, cold DFA:       " << cold * 1e3 << " ms" << std::endl;
+
+  return 0;
+}
@@ -70,6 +70,8 @@ namespace antlr4 {
     virtual std::string toString() const override;
 
   private:
+    friend class ParallelTokenSource; // Lexes chunks of _data in place.
+
     void InitializeInstanceFields();
   };
 
@@ -91,24 +91,23 @@ size_t BufferedTokenStream::fetch(size_t n) {
     return 0;
   }
 
-  size_t i = 0;
-  while (i < n) {
-    std::unique_ptr<Token> t(_tokenSource->nextToken());
-
-    if (is<WritableToken *>(t.get())) {
-      (static_cast<WritableToken *>(t.get()))->setTokenIndex(_tokens.size());
+  // The tokens get their index also if the token source throws in the middle of a batch.
+  size_t start = _tokens.size();
+  auto onExit = finally([this, start] {
+    for (size_t i = start; i < _tokens.size(); ++i) {
+      Token *t = _tokens[i].get();
+      if (is<WritableToken *>(t)) {
+        (static_cast<WritableToken *>(t))->setTokenIndex(i);
+      }
     }
+  });
+  size_t fetched = _tokenSource->nextTokens(_tokens, n);
 
-    _tokens.push_back(std::move(t));
-    ++i;
-
-    if (_tokens.back()->getType() == Token::EOF) {
-      _fetchedEOF = true;
-      break;
-    }
+  if (fetched > 0 && _tokens.back()->getType() == Token::EOF) {
+    _fetchedEOF = true;
   }
 
-  return i;
+  return fetched;
 }
 
 Token* BufferedTokenStream::get(size_t i) const {
@@ -374,15 +373,23 @@ std::string BufferedTokenStream::getText(const misc::Interval &interval) {
     stop = _tokens.size() - 1;
   }
 
-  std::stringstream ss;
+  std::string text;
+  if (start <= stop) {
+    size_t first = _tokens[start]->getStartIndex();
+    size_t last = _tokens[stop]->getStopIndex();
+    if (first != INVALID_INDEX && last != INVALID_INDEX && last >= first) {
+      text.reserve(last - first + 1);
+    }
+  }
+
   for (size_t i = start; i <= stop; i++) {
     Token *t = _tokens[i].get();
     if (t->getType() == Token::EOF) {
       break;
     }
-    ss << t->getText();
+    text += t->getText();
   }
-  return ss.str();
+  return text;
 }
 
 std::string BufferedTokenStream::getText(RuleContext *ctx) {
@@ -0,0 +1,200 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Token.h"
+#include "TokenSource.h"
+#include "WritableToken.h"
+#include "support/CPPUtils.h"
+
+#include "ConcurrentTokenStream.h"
+
+using namespace antlr4;
+using namespace antlrcpp;
+
+ConcurrentTokenStream::ConcurrentTokenStream(TokenSource *tokenSource)
+  : ConcurrentTokenStream(tokenSource, Token::DEFAULT_CHANNEL) {
+}
+
+ConcurrentTokenStream::ConcurrentTokenStream(TokenSource *tokenSource, size_t channel)
+  : ConcurrentTokenStream(tokenSource, channel, 1024) {
+}
+
+ConcurrentTokenStream::ConcurrentTokenStream(TokenSource *tokenSource, size_t channel, size_t capacity)
+  : CommonTokenStream(tokenSource, channel), _head(0), _tail(0), _producerDone(false), _stopRequested(false),
+    _consumerWaiting(false), _producerWaiting(false), _producerStarted(false) {
+  size_t size = 2;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  _ring.resize(size, nullptr);
+  _mask = size - 1;
+}
+
+ConcurrentTokenStream::~ConcurrentTokenStream() {
+  stopProducer();
+}
+
+void ConcurrentTokenStream::setTokenSource(TokenSource *tokenSource) {
+  stopProducer();
+  CommonTokenStream::setTokenSource(tokenSource);
+}
+
+size_t ConcurrentTokenStream::fetch(size_t n) {
+  if (_fetchedEOF) {
+    return 0;
+  }
+
+  startProducer();
+
+  // Take everything the producer has finished so far, but at least n tokens (or up to EOF).
+  size_t fetched = 0;
+  while (!_fetchedEOF) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load();
+    if (head == tail) {
+      if (fetched >= n) {
+        break;
+      }
+
+      if (_producerDone) {
+        // The producer might have pushed its last tokens before it finished.
+        if (head != _tail.load()) {
+          continue;
+        }
+
+        if (_producerException) {
+          std::rethrow_exception(_producerException);
+        }
+        break;
+      }
+
+      waitFor(_consumerWaiting, [this, head] {
+        return _tail.load() != head || _producerDone;
+      });
+      continue;
+    }
+
+    while (head != tail) {
+      Token *t = _ring[head & _mask];
+      ++head;
+      ++fetched;
+
+      if (is<WritableToken *>(t)) {
+        (static_cast<WritableToken *>(t))->setTokenIndex(_tokens.size());
+      }
+      _tokens.emplace_back(t);
+
+      if (t->getType() == Token::EOF) {
+        _fetchedEOF = true;
+        break;
+      }
+    }
+
+    _head.store(head);
+    wakeUp(_producerWaiting);
+  }
+
+  return fetched;
+}
+
+void ConcurrentTokenStream::produce() {
+  // Tokens are obtained in small blocks, to reduce the per-token overhead without delaying the parser.
+  const size_t blockSize = 64;
+
+  std::vector<std::unique_ptr<Token>> block;
+  bool done = false;
+  try {
+    while (!done && !_stopRequested) {
+      block.clear();
+      size_t count = _tokenSource->nextTokens(block, blockSize);
+      if (count == 0) {
+        break;
+      }
+      done = block.back()->getType() == Token::EOF;
+
+      size_t tail = _tail.load(std::memory_order_relaxed);
+      for (auto &t : block) {
+        if (tail - _head.load() == _ring.size()) {
+          // Publish what we have so far before waiting for free slots.
+          _tail.store(tail);
+          wakeUp(_consumerWaiting);
+
+          waitFor(_producerWaiting, [this, tail] {
+            return tail - _head.load() < _ring.size() || _stopRequested;
+          });
+          if (_stopRequested) {
+            return;
+          }
+        }
+
+        _ring[tail & _mask] = t.release();
+        ++tail;
+      }
+
+      _tail.store(tail);
+      wakeUp(_consumerWaiting);
+    }
+  } catch (...) {
+    _producerException = std::current_exception();
+  }
+
+  _producerDone = true;
+  wakeUp(_consumerWaiting);
+}
+
+void ConcurrentTokenStream::startProducer() {
+  if (!_producerStarted) {
+    _producerStarted = true;
+    _producer = std::thread(&ConcurrentTokenStream::produce, this);
+  }
+}
+
+void ConcurrentTokenStream::stopProducer() {
+  if (!_producerStarted) {
+    return;
+  }
+
+  _stopRequested = true;
+  wakeUp(_producerWaiting);
+  _producer.join();
+
+  // Delete all tokens which have not been taken by the parser.
+  for (size_t head = _head; head != _tail; ++head) {
+    delete _ring[head & _mask];
+    _ring[head & _mask] = nullptr;
+  }
+
+  _head = 0;
+  _tail = 0;
+  _producerDone = false;
+  _stopRequested = false;
+  _producerException = nullptr;
+  _producerStarted = false;
+}
+
+template<typename Predicate>
+void ConcurrentTokenStream::waitFor(std::atomic<bool> &waiting, Predicate predicate) {
+  // The other side is usually only a few tokens behind, so try without blocking first.
+  for (size_t i = 0; i < 64; ++i) {
+    if (predicate()) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  std::unique_lock<std::mutex> lock(_waitMutex);
+  waiting = true;
+  _waitCondition.wait(lock, predicate);
+  waiting = false;
+}
+
+void ConcurrentTokenStream::wakeUp(std::atomic<bool> &waiting) {
+  // Sequentially consistent stores of the ring indexes and the waiting flag make sure that either the
+  // waiting side sees the new index in its predicate or we see the flag here.
+  if (waiting) {
+    std::lock_guard<std::mutex> lock(_waitMutex);
+    _waitCondition.notify_all();
+  }
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "CommonTokenStream.h"
+
+namespace antlr4 {
+
+  /// A <seealso cref="CommonTokenStream"/> which runs its token source on a separate thread.
+  ///
+  /// On the first fetch a producer thread is started, which pulls tokens from the token source and
+  /// runs ahead of the parser, as long as there is room in a bounded single producer/single consumer
+  /// ring buffer. The parser thread only moves finished tokens from the ring into the token list,
+  /// so lexing and parsing overlap. All tokens taken from the ring stay buffered, hence LT(k), seek
+  /// and the text retrieval functions work as usual for everything which has been fetched.
+  ///
+  /// Since the token source (usually a lexer) runs on another thread, it must not be used by the
+  /// parser thread while the stream is active. Lexer error listeners are invoked on the producer thread.
+  /// Token text is read from the char stream on the parser thread, which is safe for
+  /// <seealso cref="ANTLRInputStream"/>. For other char streams use a token factory which copies the text.
+  /// Exceptions thrown by the token source are rethrown on the parser thread, when the parser
+  /// reaches the position at which they occurred.
+  class ANTLR4CPP_PUBLIC ConcurrentTokenStream : public CommonTokenStream {
+  public:
+    ConcurrentTokenStream(TokenSource *tokenSource);
+    ConcurrentTokenStream(TokenSource *tokenSource, size_t channel);
+
+    /// <param name="capacity"> The maximum number of tokens the producer thread can be ahead
+    ///   of the parser (rounded up to a power of 2). </param>
+    ConcurrentTokenStream(TokenSource *tokenSource, size_t channel, size_t capacity);
+    virtual ~ConcurrentTokenStream();
+
+    virtual void setTokenSource(TokenSource *tokenSource) override;
+
+  protected:
+    virtual size_t fetch(size_t n) override;
+
+    /// The loop of the producer thread.
+    virtual void produce();
+
+  private:
+    std::vector<Token *> _ring;
+    size_t _mask;
+
+    // The next slot to read (owned by the consumer) and the next slot to write (owned by the producer).
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+
+    std::atomic<bool> _producerDone;
+    std::atomic<bool> _stopRequested;
+    std::exception_ptr _producerException;
+
+    // Used only if one side has to wait for the other.
+    std::mutex _waitMutex;
+    std::condition_variable _waitCondition;
+    std::atomic<bool> _consumerWaiting;
+    std::atomic<bool> _producerWaiting;
+
+    std::thread _producer;
+    bool _producerStarted;
+
+    void startProducer();
+    void stopProducer();
+
+    template<typename Predicate>
+    void waitFor(std::atomic<bool> &waiting, Predicate predicate);
+    void wakeUp(std::atomic<bool> &waiting);
+  };
+
+} // namespace antlr4
@@ -120,8 +120,8 @@ void DefaultErrorStrategy::sync(Parser *recognizer) {
     case atn::ATNState::PLUS_LOOP_BACK:
     case atn::ATNState::STAR_LOOP_BACK: {
       reportUnwantedToken(recognizer);
-      misc::IntervalSet expecting = recognizer->getExpectedTokens();
-      misc::IntervalSet whatFollowsLoopIterationOrRule = expecting.Or(getErrorRecoverySet(recognizer));
+      misc::IntervalSet whatFollowsLoopIterationOrRule = recognizer->getExpectedTokens();
+      whatFollowsLoopIterationOrRule.addAll(getErrorRecoverySet(recognizer));
       consumeUntil(recognizer, whatFollowsLoopIterationOrRule);
     }
       break;
@@ -307,8 +307,7 @@ misc::IntervalSet DefaultErrorStrategy::getErrorRecoverySet(Parser *recognizer)
     // compute what follows who invoked us
     atn::ATNState *invokingState = atn.states[ctx->invokingState];
     atn::RuleTransition *rt = dynamic_cast<atn::RuleTransition*>(invokingState->transitions[0]);
-    misc::IntervalSet follow = atn.nextTokens(rt->followState);
-    recoverSet.addAll(follow);
+    recoverSet.addAll(atn.nextTokens(rt->followState));
 
     if (ctx->parent == nullptr)
       break;
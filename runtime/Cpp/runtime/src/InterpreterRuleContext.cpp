@@ -17,3 +17,7 @@ InterpreterRuleContext::InterpreterRuleContext(ParserRuleContext *parent, size_t
 size_t InterpreterRuleContext::getRuleIndex() const {
   return _ruleIndex;
 }
+
+bool InterpreterRuleContext::hasDefaultGetText() const {
+  return typeid(*this) == typeid(InterpreterRuleContext);
+}
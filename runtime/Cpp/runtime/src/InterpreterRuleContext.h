@@ -36,6 +36,7 @@ namespace antlr4 {
     InterpreterRuleContext(ParserRuleContext *parent, size_t invokingStateNumber, size_t ruleIndex);
 
     virtual size_t getRuleIndex() const override;
+    virtual bool hasDefaultGetText() const override;
 
   protected:
     /** This is the backing field for {@link #getRuleIndex}. */
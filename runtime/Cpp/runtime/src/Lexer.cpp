@@ -31,7 +31,9 @@ Lexer::Lexer(CharStream *input) : Recognizer(), _input(input) {
 
 void Lexer::reset() {
   // wack Lexer state variables
-  _input->seek(0); // rewind the input
+  if (_input != nullptr) {
+    _input->seek(0); // rewind the input
+  }
 
   _syntaxErrors = 0;
   token.reset();
@@ -61,6 +63,36 @@ std::unique_ptr<Token> Lexer::nextToken() {
     _input->release(tokenStartMarker);
   });
 
+  return matchToken(getInterpreter<atn::LexerATNSimulator>());
+}
+
+size_t Lexer::nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) {
+  if (_batchMatchingType == nullptr || typeid(*this) != *_batchMatchingType) {
+    return TokenSource::nextTokens(tokens, n);
+  }
+
+  // A single marker for the entire batch. It keeps the text of all tokens in this batch
+  // available in unbuffered streams.
+  ssize_t batchStartMarker = _input->mark();
+
+  auto onExit = finally([this, batchStartMarker]{
+    _input->release(batchStartMarker);
+  });
+
+  atn::LexerATNSimulator *interpreter = getInterpreter<atn::LexerATNSimulator>();
+  size_t i = 0;
+  while (i < n) {
+    tokens.push_back(matchToken(interpreter));
+    ++i;
+
+    if (tokens.back()->getType() == EOF) {
+      break;
+    }
+  }
+  return i;
+}
+
+std::unique_ptr<Token> Lexer::matchToken(atn::LexerATNSimulator *interpreter) {
   while (true) {
   outerContinue:
     if (hitEOF) {
@@ -71,14 +103,14 @@ std::unique_ptr<Token> Lexer::nextToken() {
     token.reset();
     channel = Token::DEFAULT_CHANNEL;
     tokenStartCharIndex = _input->index();
-    tokenStartCharPositionInLine = getInterpreter<atn::LexerATNSimulator>()->getCharPositionInLine();
-    tokenStartLine = getInterpreter<atn::LexerATNSimulator>()->getLine();
+    tokenStartCharPositionInLine = interpreter->getCharPositionInLine();
+    tokenStartLine = interpreter->getLine();
     _text = "";
     do {
       type = Token::INVALID_TYPE;
       size_t ttype;
       try {
-        ttype = getInterpreter<atn::LexerATNSimulator>()->match(_input, mode);
+        ttype = interpreter->match(_input, mode);
       } catch (LexerNoViableAltException &e) {
         notifyListeners(e); // report error
         recover(e);
@@ -292,4 +324,5 @@ void Lexer::InitializeInstanceFields() {
   channel = 0;
   type = 0;
   mode = Lexer::DEFAULT_MODE;
+  _batchMatchingType = nullptr;
 }
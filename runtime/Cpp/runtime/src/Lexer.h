@@ -97,6 +97,11 @@ namespace antlr4 {
     /// Return a token from this source; i.e., match a token on the char stream.
     virtual std::unique_ptr<Token> nextToken() override;
 
+    /// Match up to n tokens in one go. If batch matching is enabled this runs a loop which sets up
+    /// the char stream marker and the interpreter only once per batch, instead of once per token.
+    /// Otherwise each token is obtained from nextToken().
+    virtual size_t nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) override;
+
     /// Instruct the lexer to skip creating a token for current lexer rule
     /// and look for another token.  nextToken() knows to keep looking when
     /// a lexer rule finishes with token set to SKIP_TOKEN.  Recall that
@@ -201,6 +206,15 @@ namespace antlr4 {
     /// the input char buffer (via setText()).
     std::string _text;
 
+    /// The lexer class for which nextTokens() may bypass nextToken(), or null. Batch matching is only used if
+    /// this is the dynamic type of the lexer, so an override of nextToken() (e.g. to emit multiple tokens per
+    /// rule) is never bypassed, also not in subclasses. Generated lexers set this to their own class if neither
+    /// the grammar nor the super class overrides nextToken().
+    const std::type_info *_batchMatchingType;
+
+    /// The token matching part of nextToken(), without the stream marker handling.
+    std::unique_ptr<Token> matchToken(atn::LexerATNSimulator *interpreter);
+
   private:
     size_t _syntaxErrors;
     void InitializeInstanceFields();
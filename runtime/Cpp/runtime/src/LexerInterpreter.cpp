@@ -27,18 +27,23 @@ LexerInterpreter::LexerInterpreter(const std::string &grammarFileName, const dfa
                   _channelNames(channelNames), _modeNames(modeNames),
                   _vocabulary(vocabulary) {
 
-  if (_atn.grammarType != atn::ATNType::LEXER) {
-    throw IllegalArgumentException("The ATN must be a lexer ATN.");
+  for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
+    _decisionToDFA.push_back(dfa::DFA(_atn.getDecisionState(i), i));
   }
+  initialize(_decisionToDFA, _sharedContextCache);
+}
 
-  for (size_t i = 0; i < atn.maxTokenType; i++) {
-    _tokenNames.push_back(vocabulary.getDisplayName(i));
-  }
+LexerInterpreter::LexerInterpreter(const std::string &grammarFileName, const dfa::Vocabulary &vocabulary,
+  const std::vector<std::string> &ruleNames, const std::vector<std::string> &channelNames, const std::vector<std::string> &modeNames,
+  const atn::ATN &atn, CharStream *input, std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache)
+  : Lexer(input), _grammarFileName(grammarFileName), _atn(atn), _ruleNames(ruleNames),
+                  _channelNames(channelNames), _modeNames(modeNames),
+                  _vocabulary(vocabulary) {
 
-  for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
-    _decisionToDFA.push_back(dfa::DFA(_atn.getDecisionState(i), i));
+  if (decisionToDFA.size() != atn.getNumberOfDecisions()) {
+    throw IllegalArgumentException("There must be one DFA for each decision of the ATN.");
   }
-  _interpreter = new atn::LexerATNSimulator(this, _atn, _decisionToDFA, _sharedContextCache); /* mem-check: deleted in d-tor */
+  initialize(decisionToDFA, sharedContextCache);
 }
 
 LexerInterpreter::~LexerInterpreter()
@@ -46,6 +51,18 @@ LexerInterpreter::~LexerInterpreter()
   delete _interpreter;
 }
 
+void LexerInterpreter::initialize(std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache) {
+  if (_atn.grammarType != atn::ATNType::LEXER) {
+    throw IllegalArgumentException("The ATN must be a lexer ATN.");
+  }
+
+  for (size_t i = 0; i < _atn.maxTokenType; i++) {
+    _tokenNames.push_back(_vocabulary.getDisplayName(i));
+  }
+
+  _interpreter = new atn::LexerATNSimulator(this, _atn, decisionToDFA, sharedContextCache); /* mem-check: deleted in d-tor */
+}
+
 const atn::ATN& LexerInterpreter::getATN() const {
   return _atn;
 }
@@ -21,6 +21,14 @@ namespace antlr4 {
                      const std::vector<std::string> &ruleNames, const std::vector<std::string> &channelNames,
                      const std::vector<std::string> &modeNames, const atn::ATN &atn, CharStream *input);
 
+    /// Uses the given DFAs (one per decision of the ATN, as for generated lexers) and prediction context cache
+    /// instead of private ones, so that all interpreters for the same grammar share their DFA states. Both must
+    /// outlive the interpreter.
+    LexerInterpreter(const std::string &grammarFileName, const dfa::Vocabulary &vocabulary,
+                     const std::vector<std::string> &ruleNames, const std::vector<std::string> &channelNames,
+                     const std::vector<std::string> &modeNames, const atn::ATN &atn, CharStream *input,
+                     std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache);
+
     ~LexerInterpreter();
 
     virtual const atn::ATN& getATN() const override;
@@ -47,6 +55,8 @@ namespace antlr4 {
 
   private:
     dfa::Vocabulary _vocabulary;
+
+    void initialize(std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache);
   };
 
 } // namespace antlr4
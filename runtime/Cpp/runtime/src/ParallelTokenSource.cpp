@@ -0,0 +1,430 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "CommonToken.h"
+#include "WritableToken.h"
+#include "BaseErrorListener.h"
+#include "misc/Interval.h"
+#include "support/CPPUtils.h"
+
+#include "ParallelTokenSource.h"
+
+using namespace antlr4;
+using namespace antlrcpp;
+
+namespace {
+
+  struct SyntaxError {
+    size_t line;
+    size_t charPositionInLine;
+    std::string message;
+  };
+
+  // Collects the errors of a single chunk. They are reported only if the chunk is accepted.
+  class ChunkErrorCollector : public BaseErrorListener {
+  public:
+    ChunkErrorCollector(std::vector<SyntaxError> &errors) : _errors(errors) {
+    }
+
+    virtual void syntaxError(Recognizer * /*recognizer*/, Token * /*offendingSymbol*/, size_t line,
+                             size_t charPositionInLine, const std::string &msg, std::exception_ptr /*e*/) override {
+      _errors.push_back({ line, charPositionInLine, msg });
+    }
+
+  private:
+    std::vector<SyntaxError> &_errors;
+  };
+
+  // Replaces the chunk lexer and its stream as token source, so that tokens stay valid after lexing.
+  class ChunkTokenFactory : public TokenFactory<CommonToken> {
+  public:
+    ChunkTokenFactory(TokenFactory<CommonToken> *factory, TokenSource *source, CharStream *input)
+      : _factory(factory), _source(source), _input(input) {
+    }
+
+    virtual std::unique_ptr<CommonToken> create(std::pair<TokenSource *, CharStream *> /*source*/, size_t type,
+      const std::string &text, size_t channel, size_t start, size_t stop, size_t line, size_t charPositionInLine) override {
+      return _factory->create({ _source, _input }, type, text, channel, start, stop, line, charPositionInLine);
+    }
+
+    virtual std::unique_ptr<CommonToken> create(size_t type, const std::string &text) override {
+      return _factory->create(type, text);
+    }
+
+  private:
+    TokenFactory<CommonToken> *_factory;
+    TokenSource *_source;
+    CharStream *_input;
+  };
+
+}
+
+struct ParallelTokenSource::Chunk {
+  // The code point range of this chunk, [start, stop).
+  size_t start = 0;
+  size_t stop = 0;
+  bool isLast = false;
+
+  std::vector<std::unique_ptr<Token>> tokens;
+  std::vector<SyntaxError> errors;
+  std::exception_ptr exception;
+
+  // The lexer state after the chunk has been lexed. Lines are relative to the chunk start.
+  size_t exitMode = Lexer::DEFAULT_MODE;
+  std::vector<size_t> exitModeStack;
+  size_t endLine = 1;
+  size_t endCharPositionInLine = 0;
+};
+
+/// A view on a range of the original input. It uses the same indices as the original input,
+/// so tokens created from it can directly be used with the original input.
+class ParallelTokenSource::ChunkStream : public CharStream {
+public:
+  ChunkStream(ANTLRInputStream *input) : _input(input), _data(input->_data) {
+  }
+
+  void setRange(size_t start, size_t stop) {
+    _start = start;
+    _stop = stop;
+    _p = start;
+  }
+
+  virtual void consume() override {
+    if (_p >= _stop) {
+      throw IllegalStateException("cannot consume EOF");
+    }
+    ++_p;
+  }
+
+  virtual size_t LA(ssize_t i) override {
+    if (i == 0) {
+      return 0; // undefined
+    }
+
+    ssize_t position = static_cast<ssize_t>(_p);
+    if (i < 0) {
+      i++; // e.g., translate LA(-1) to use offset i=0; then _data[p+0-1]
+      if ((position + i - 1) < static_cast<ssize_t>(_start)) {
+        return IntStream::EOF;
+      }
+    }
+
+    if ((position + i - 1) >= static_cast<ssize_t>(_stop)) {
+      return IntStream::EOF;
+    }
+
+    return _data[static_cast<size_t>((position + i - 1))];
+  }
+
+  virtual ssize_t mark() override {
+    return -1;
+  }
+
+  virtual void release(ssize_t /*marker*/) override {
+  }
+
+  virtual size_t index() override {
+    return _p;
+  }
+
+  virtual void seek(size_t index) override {
+    _p = std::max(_start, std::min(index, _stop));
+  }
+
+  virtual size_t size() override {
+    return _stop;
+  }
+
+  virtual std::string getText(const misc::Interval &interval) override {
+    return _input->getText(interval);
+  }
+
+  virtual std::string getSourceName() const override {
+    return _input->getSourceName();
+  }
+
+  virtual std::string toString() const override {
+    return _input->getText(misc::Interval(_start, _stop - 1));
+  }
+
+private:
+  ANTLRInputStream *_input;
+  const UTF32String &_data;
+
+  size_t _start = 0;
+  size_t _stop = 0;
+  size_t _p = 0;
+};
+
+ParallelTokenSource::ParallelTokenSource(Lexer *lexer, LexerFactory factory, size_t threadCount)
+  : _lexer(lexer), _factory(std::move(factory)), _threadCount(threadCount) {
+  _input = dynamic_cast<ANTLRInputStream *>(lexer->getInputStream());
+  if (_input == nullptr) {
+    throw IllegalArgumentException("ParallelTokenSource requires a lexer reading from an ANTLRInputStream");
+  }
+
+  if (_threadCount == 0) {
+    _threadCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  _syncPredicate = [](const UTF32String &input, size_t index) {
+    return input[index - 1] == '\n';
+  };
+
+  _minimumChunkSize = 64 * 1024;
+  _index = 0;
+  _tokenized = false;
+  _chunkCount = 0;
+  _relexedChunkCount = 0;
+  _syntaxErrors = 0;
+}
+
+ParallelTokenSource::~ParallelTokenSource() {
+}
+
+void ParallelTokenSource::setMinimumChunkSize(size_t size) {
+  _minimumChunkSize = std::max<size_t>(size, 1);
+}
+
+size_t ParallelTokenSource::getMinimumChunkSize() const {
+  return _minimumChunkSize;
+}
+
+void ParallelTokenSource::setSyncPredicate(SyncPredicate predicate) {
+  _syncPredicate = std::move(predicate);
+}
+
+void ParallelTokenSource::tokenize() {
+  if (_tokenized) {
+    return;
+  }
+  _tokenized = true;
+
+  _chunkTokenFactory.reset(new ChunkTokenFactory(_lexer->getTokenFactory(), this, _input));
+
+  std::vector<size_t> boundaries = findChunkBoundaries();
+  std::vector<Chunk> chunks(boundaries.size() - 1);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    chunks[i].start = boundaries[i];
+    chunks[i].stop = boundaries[i + 1];
+  }
+  chunks.back().isLast = true;
+  _chunkCount = chunks.size();
+
+  // Speculative phase: every chunk starts in the default mode.
+  size_t threadCount = std::min(_threadCount, chunks.size());
+  std::atomic<size_t> nextChunk(0);
+  std::vector<std::exception_ptr> failures(threadCount);
+  auto work = [&](size_t id) {
+    try {
+      ChunkStream stream(_input);
+      std::unique_ptr<Lexer> lexer = createChunkLexer(stream);
+      for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+        lexChunk(lexer.get(), stream, chunks[i], Lexer::DEFAULT_MODE, {});
+      }
+    } catch (...) {
+      failures[id] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t id = 1; id < threadCount; ++id) {
+    workers.emplace_back(work, id);
+  }
+  work(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (auto &failure : failures) {
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+
+  // Reconciliation phase: relex all chunks which started with a wrong mode state.
+  ChunkStream stream(_input);
+  std::unique_ptr<Lexer> lexer;
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    const Chunk &previous = chunks[i - 1];
+    if (previous.exitMode == Lexer::DEFAULT_MODE && previous.exitModeStack.empty()) {
+      continue;
+    }
+
+    if (!lexer) {
+      lexer = createChunkLexer(stream);
+    }
+    lexChunk(lexer.get(), stream, chunks[i], previous.exitMode, previous.exitModeStack);
+    ++_relexedChunkCount;
+  }
+
+  stitch(chunks);
+}
+
+std::unique_ptr<Token> ParallelTokenSource::nextToken() {
+  tokenize();
+
+  // The last token is always the EOF token. Keep it and hand out copies, so that calls after the end of the input
+  // return EOF again, like a lexer does.
+  if (_index + 1 < _tokens.size()) {
+    return std::move(_tokens[_index++]);
+  }
+  return std::unique_ptr<Token>(new CommonToken(_tokens.back().get()));
+}
+
+size_t ParallelTokenSource::getLine() const {
+  if (_index < _tokens.size()) {
+    return _tokens[_index]->getLine();
+  }
+  return 1;
+}
+
+size_t ParallelTokenSource::getCharPositionInLine() {
+  if (_index < _tokens.size()) {
+    return _tokens[_index]->getCharPositionInLine();
+  }
+  return 0;
+}
+
+CharStream* ParallelTokenSource::getInputStream() {
+  return _input;
+}
+
+std::string ParallelTokenSource::getSourceName() {
+  return _input->getSourceName();
+}
+
+TokenFactory<CommonToken>* ParallelTokenSource::getTokenFactory() {
+  return _lexer->getTokenFactory();
+}
+
+size_t ParallelTokenSource::getChunkCount() const {
+  return _chunkCount;
+}
+
+size_t ParallelTokenSource::getRelexedChunkCount() const {
+  return _relexedChunkCount;
+}
+
+size_t ParallelTokenSource::getNumberOfSyntaxErrors() const {
+  return _syntaxErrors;
+}
+
+std::vector<size_t> ParallelTokenSource::findChunkBoundaries() {
+  const UTF32String &data = _input->_data;
+  size_t size = data.size();
+
+  // Create a few more chunks than threads, so that chunks of different lexing cost balance out.
+  size_t chunkSize = std::max(_minimumChunkSize, size / (_threadCount * 4));
+
+  std::vector<size_t> boundaries = { 0 };
+  size_t position = chunkSize;
+  while (position + _minimumChunkSize / 2 < size) {
+    while (position < size && !_syncPredicate(data, position)) {
+      ++position;
+    }
+    if (position >= size) {
+      break;
+    }
+
+    boundaries.push_back(position);
+    position += chunkSize;
+  }
+  boundaries.push_back(size);
+
+  return boundaries;
+}
+
+std::unique_ptr<Lexer> ParallelTokenSource::createChunkLexer(ChunkStream &stream) {
+  std::unique_ptr<Lexer> lexer = _factory(&stream);
+  lexer->setTokenFactory(_chunkTokenFactory.get());
+  lexer->removeErrorListeners();
+  return lexer;
+}
+
+void ParallelTokenSource::lexChunk(Lexer *lexer, ChunkStream &stream, Chunk &chunk, size_t mode,
+                                   const std::vector<size_t> &modeStack) {
+  chunk.tokens.clear();
+  chunk.errors.clear();
+  chunk.exception = nullptr;
+
+  ChunkErrorCollector collector(chunk.errors);
+  lexer->addErrorListener(&collector);
+  auto onExit = finally([lexer, &collector] {
+    lexer->removeErrorListener(&collector);
+  });
+
+  stream.setRange(chunk.start, chunk.stop);
+  lexer->reset();
+  lexer->mode = mode;
+  lexer->modeStack = modeStack;
+
+  try {
+    while (true) {
+      std::unique_ptr<Token> token = lexer->nextToken();
+      if (token->getType() == Token::EOF) {
+        // Only the real end of the input produces an EOF token.
+        if (chunk.isLast) {
+          chunk.tokens.push_back(std::move(token));
+        }
+        break;
+      }
+      chunk.tokens.push_back(std::move(token));
+    }
+  } catch (...) {
+    // Keep the exception until we know if this chunk was lexed with the right entry state.
+    chunk.exception = std::current_exception();
+  }
+
+  chunk.exitMode = lexer->mode;
+  chunk.exitModeStack = lexer->modeStack;
+  chunk.endLine = lexer->getLine();
+  chunk.endCharPositionInLine = lexer->getCharPositionInLine();
+}
+
+void ParallelTokenSource::stitch(std::vector<Chunk> &chunks) {
+  size_t tokenCount = 0;
+  for (auto &chunk : chunks) {
+    if (chunk.exception) {
+      std::rethrow_exception(chunk.exception);
+    }
+    tokenCount += chunk.tokens.size();
+  }
+  _tokens.reserve(tokenCount);
+
+  // The position of the current chunk start within the entire input.
+  size_t line = 1;
+  size_t charPositionInLine = 0;
+
+  ProxyErrorListener &listener = _lexer->getErrorListenerDispatch();
+  for (auto &chunk : chunks) {
+    for (auto &error : chunk.errors) {
+      ++_syntaxErrors;
+      size_t column = error.line == 1 ? charPositionInLine + error.charPositionInLine : error.charPositionInLine;
+      listener.syntaxError(_lexer, nullptr, line + error.line - 1, column, error.message, nullptr);
+    }
+
+    for (auto &token : chunk.tokens) {
+      if (is<WritableToken *>(token.get())) {
+        WritableToken *writable = static_cast<WritableToken *>(token.get());
+        size_t tokenLine = writable->getLine();
+        if (tokenLine == 1) {
+          writable->setCharPositionInLine(charPositionInLine + writable->getCharPositionInLine());
+        }
+        writable->setLine(line + tokenLine - 1);
+        writable->setTokenIndex(_tokens.size());
+      }
+      _tokens.push_back(std::move(token));
+    }
+
+    if (chunk.endLine == 1) {
+      charPositionInLine += chunk.endCharPositionInLine;
+    } else {
+      charPositionInLine = chunk.endCharPositionInLine;
+    }
+    line += chunk.endLine - 1;
+  }
+}
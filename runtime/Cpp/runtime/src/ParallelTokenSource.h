@@ -0,0 +1,115 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "TokenSource.h"
+#include "Lexer.h"
+#include "ANTLRInputStream.h"
+
+namespace antlr4 {
+
+  /// A token source which tokenizes an entire <seealso cref="ANTLRInputStream"/> with several
+  /// lexers running concurrently.
+  ///
+  /// The input is split into chunks at safe boundaries (by default after a line break, or wherever
+  /// a user supplied sync predicate allows it). Each chunk is lexed by its own lexer instance (and hence
+  /// its own <seealso cref="atn::LexerATNSimulator"/>), all of them sharing the DFA cache of the grammar.
+  /// Every chunk except the first one is lexed speculatively, starting in the default mode with an empty
+  /// mode stack. When the chunks are stitched together the mode state each chunk ended in is compared
+  /// with the guess made for the following chunk. Chunks whose guess was wrong are lexed again with
+  /// the correct entry state, which may cascade to further chunks.
+  ///
+  /// A boundary is only safe if no token can span it. With the default predicate this means that
+  /// tokens matched in the default mode must not contain line breaks (block comments, multi line strings
+  /// etc. have to be lexed in their own mode). Lexer actions must not depend on the line number or on
+  /// state carried over from earlier tokens (other than the mode stack).
+  ///
+  /// The resulting tokens get their token index, line and char position fixed up to be relative to the
+  /// whole input and refer to this token source and the original input stream. Syntax errors found in
+  /// accepted chunks are forwarded (in input order) to the error listeners of the lexer given in the
+  /// constructor. An instance can be passed directly to a <seealso cref="BufferedTokenStream"/>
+  /// or <seealso cref="CommonTokenStream"/>. Tokenization runs on the first call to
+  /// <seealso cref="#nextToken"/> or <seealso cref="#tokenize"/>.
+  class ANTLR4CPP_PUBLIC ParallelTokenSource : public TokenSource {
+  public:
+    /// Creates a new lexer for the given input. Called once per worker thread.
+    typedef std::function<std::unique_ptr<Lexer> (CharStream *input)> LexerFactory;
+
+    /// Returns true if a chunk may start at the given code point index of the input.
+    typedef std::function<bool (const UTF32String &input, size_t index)> SyncPredicate;
+
+    /// <param name="lexer"> The lexer to take error listeners and the token factory from. Also used
+    ///   as recognizer when reporting errors. Its input stream must be an <seealso cref="ANTLRInputStream"/>. </param>
+    /// <param name="factory"> Creates the lexers for the worker threads. </param>
+    /// <param name="threadCount"> The number of worker threads or 0 to use the number of available cores. </param>
+    ParallelTokenSource(Lexer *lexer, LexerFactory factory, size_t threadCount = 0);
+    ParallelTokenSource(const ParallelTokenSource& other) = delete;
+    virtual ~ParallelTokenSource();
+
+    ParallelTokenSource& operator = (const ParallelTokenSource& other) = delete;
+
+    /// Set the minimum number of code points in a chunk. Inputs smaller than twice this size are
+    /// lexed in a single chunk.
+    virtual void setMinimumChunkSize(size_t size);
+    virtual size_t getMinimumChunkSize() const;
+
+    /// Set the predicate to determine positions where a new chunk can start.
+    /// The default predicate allows chunks to start after a line feed.
+    virtual void setSyncPredicate(SyncPredicate predicate);
+
+    /// Lex the entire input, if not yet done. Rethrows the first exception (other than syntax errors,
+    /// which are reported to the error listeners) that occurred in an accepted chunk.
+    virtual void tokenize();
+
+    virtual std::unique_ptr<Token> nextToken() override;
+    virtual size_t getLine() const override;
+    virtual size_t getCharPositionInLine() override;
+    virtual CharStream* getInputStream() override;
+    virtual std::string getSourceName() override;
+    virtual TokenFactory<CommonToken>* getTokenFactory() override;
+
+    /// The number of chunks the input was split into.
+    size_t getChunkCount() const;
+
+    /// The number of chunks which had to be lexed again, because their entry mode guess was wrong.
+    size_t getRelexedChunkCount() const;
+
+    /// The number of syntax errors reported for the accepted chunks.
+    size_t getNumberOfSyntaxErrors() const;
+
+  protected:
+    struct Chunk;
+    class ChunkStream;
+
+    Lexer *_lexer;
+    ANTLRInputStream *_input;
+    LexerFactory _factory;
+    SyncPredicate _syncPredicate;
+
+    size_t _threadCount;
+    size_t _minimumChunkSize;
+
+    std::vector<std::unique_ptr<Token>> _tokens;
+    size_t _index;
+    bool _tokenized;
+    size_t _chunkCount;
+    size_t _relexedChunkCount;
+    size_t _syntaxErrors;
+
+    /// Hands out tokens which refer to this source and the original input, instead of the chunk lexers.
+    std::unique_ptr<TokenFactory<CommonToken>> _chunkTokenFactory;
+
+    virtual std::vector<size_t> findChunkBoundaries();
+    virtual std::unique_ptr<Lexer> createChunkLexer(ChunkStream &stream);
+
+    /// Lex one chunk with the given lexer, starting with the given mode state.
+    virtual void lexChunk(Lexer *lexer, ChunkStream &stream, Chunk &chunk, size_t mode, const std::vector<size_t> &modeStack);
+
+    /// Move the tokens of the chunks into the result list, adjusting their positions and indices.
+    virtual void stitch(std::vector<Chunk> &chunks);
+  };
+
+} // namespace antlr4
@@ -3,18 +3,17 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
-#include "atn/ATNDeserializationOptions.h"
 #include "tree/pattern/ParseTreePatternMatcher.h"
 #include "dfa/DFA.h"
 #include "ParserRuleContext.h"
 #include "tree/TerminalNode.h"
 #include "tree/ErrorNodeImpl.h"
+#include "tree/TerminalNodeImpl.h"
 #include "Lexer.h"
 #include "atn/ParserATNSimulator.h"
 #include "misc/IntervalSet.h"
 #include "atn/RuleStartState.h"
 #include "DefaultErrorStrategy.h"
-#include "atn/ATNDeserializer.h"
 #include "atn/RuleTransition.h"
 #include "atn/ATN.h"
 #include "Exceptions.h"
@@ -31,8 +30,6 @@ using namespace antlr4::atn;
 
 using namespace antlrcpp;
 
-std::map<std::vector<uint16_t>, atn::ATN> Parser::bypassAltsAtnCache;
-
 Parser::TraceListener::TraceListener(Parser *outerInstance_) : outerInstance(outerInstance_) {
 }
 
@@ -83,6 +80,8 @@ Parser::Parser(TokenStream *input) {
 Parser::~Parser() {
   _tracker.reset();
   delete _tracer;
+  delete _streamTerminalNode;
+  delete _streamErrorNode;
 }
 
 void Parser::reset() {
@@ -97,6 +96,8 @@ void Parser::reset() {
   _precedenceStack.clear();
   _precedenceStack.push_back(0);
   _ctx = nullptr;
+  _streamFrames.clear();
+  _retainNextRuleContext = false;
   _tracker.reset();
 
   atn::ATNSimulator *interpreter = getInterpreter<atn::ParserATNSimulator>();
@@ -119,6 +120,8 @@ Token* Parser::match(size_t ttype) {
       // we must have conjured up a new token during single token insertion
       // if it's not the current symbol
       _ctx->addChild(createErrorNode(t));
+    } else if (_streamingMode && !_parseListeners.empty() && t->getTokenIndex() == INVALID_INDEX) {
+      triggerStreamTokenEvent(t, true);
     }
   }
   return t;
@@ -135,6 +138,8 @@ Token* Parser::matchWildcard() {
       // we must have conjured up a new token during single token insertion
       // if it's not the current symbol
       _ctx->addChild(createErrorNode(t));
+    } else if (_streamingMode && !_parseListeners.empty() && t->getTokenIndex() == INVALID_INDEX) {
+      triggerStreamTokenEvent(t, true);
     }
   }
 
@@ -143,6 +148,9 @@ Token* Parser::matchWildcard() {
 
 void Parser::setBuildParseTree(bool buildParseTrees) {
   this->_buildParseTrees = buildParseTrees;
+  if (buildParseTrees) {
+    _streamingMode = false;
+  }
 }
 
 bool Parser::getBuildParseTree() {
@@ -214,25 +222,7 @@ TokenFactory<CommonToken>* Parser::getTokenFactory() {
 
 
 const atn::ATN& Parser::getATNWithBypassAlts() {
-  std::vector<uint16_t> serializedAtn = getSerializedATN();
-  if (serializedAtn.empty()) {
-    throw UnsupportedOperationException("The current parser does not support an ATN with bypass alternatives.");
-  }
-
-  std::lock_guard<std::mutex> lck(_mutex);
-
-  // XXX: using the entire serialized ATN as key into the map is a big resource waste.
-  //      How large can that thing become?
-  if (bypassAltsAtnCache.find(serializedAtn) == bypassAltsAtnCache.end())
-  {
-    atn::ATNDeserializationOptions deserializationOptions;
-    deserializationOptions.setGenerateRuleBypassTransitions(true);
-
-    atn::ATNDeserializer deserializer(deserializationOptions);
-    bypassAltsAtnCache[serializedAtn] = deserializer.deserialize(serializedAtn);
-  }
-
-  return bypassAltsAtnCache[serializedAtn];
+  return getATN().getATNWithBypassAlts();
 }
 
 tree::pattern::ParseTreePattern Parser::compileParseTreePattern(const std::string &pattern, int patternRuleIndex) {
@@ -248,8 +238,10 @@ tree::pattern::ParseTreePattern Parser::compileParseTreePattern(const std::strin
 
 tree::pattern::ParseTreePattern Parser::compileParseTreePattern(const std::string &pattern, int patternRuleIndex,
   Lexer *lexer) {
-  tree::pattern::ParseTreePatternMatcher m(lexer, this);
-  return m.compile(pattern, patternRuleIndex);
+  if (_patternMatcher == nullptr || _patternMatcher->getLexer() != lexer) {
+    _patternMatcher = std::make_shared<tree::pattern::ParseTreePatternMatcher>(lexer, this);
+  }
+  return tree::pattern::ParseTreePattern(_patternMatcher, _patternMatcher->compile(pattern, patternRuleIndex));
 }
 
 Ref<ANTLRErrorStrategy> Parser::getErrorHandler() {
@@ -302,7 +294,11 @@ Token* Parser::consume() {
   }
 
   bool hasListener = _parseListeners.size() > 0 && !_parseListeners.empty();
-  if (_buildParseTrees || hasListener) {
+  if (_streamingMode) {
+    if (hasListener) {
+      triggerStreamTokenEvent(o, _errHandler->inErrorRecoveryMode(this));
+    }
+  } else if (_buildParseTrees || hasListener) {
     if (_errHandler->inErrorRecoveryMode(this)) {
       tree::ErrorNode *node = createErrorNode(o);
       _ctx->addChild(node);
@@ -338,6 +334,8 @@ void Parser::enterRule(ParserRuleContext *localctx, size_t state, size_t /*ruleI
   _ctx->start = _input->LT(1);
   if (_buildParseTrees) {
     addContextToParseTree();
+  } else if (_streamingMode) {
+    enterStreamFrame(localctx);
   }
   if (_parseListeners.size() > 0) {
     triggerEnterRuleEvent();
@@ -358,6 +356,9 @@ void Parser::exitRule() {
   }
   setState(_ctx->invokingState);
   _ctx = dynamic_cast<ParserRuleContext *>(_ctx->parent);
+  if (_streamingMode) {
+    exitStreamFrame();
+  }
 }
 
 void Parser::enterOuterAlt(ParserRuleContext *localctx, size_t altNum) {
@@ -392,6 +393,9 @@ void Parser::enterRecursionRule(ParserRuleContext *localctx, size_t state, size_
   _precedenceStack.push_back(precedence);
   _ctx = localctx;
   _ctx->start = _input->LT(1);
+  if (_streamingMode) {
+    enterStreamFrame(localctx);
+  }
   if (!_parseListeners.empty()) {
     triggerEnterRuleEvent(); // simulates rule entry for left-recursive rules
   }
@@ -435,6 +439,8 @@ void Parser::unrollRecursionContexts(ParserRuleContext *parentctx) {
   if (_buildParseTrees && parentctx != nullptr) {
     // add return ctx into invoking rule's tree
     parentctx->addChild(retctx);
+  } else if (_streamingMode) {
+    exitStreamFrame();
   }
 }
 
@@ -515,9 +521,9 @@ misc::IntervalSet Parser::getExpectedTokensWithinCurrentRule() {
 }
 
 size_t Parser::getRuleIndex(const std::string &ruleName) {
-  const std::map<std::string, size_t> &m = getRuleIndexMap();
-  auto iterator = m.find(ruleName);
-  if (iterator == m.end()) {
+  const std::unordered_map<std::string, size_t> &lookup = getRuleIndexLookup();
+  auto iterator = lookup.find(ruleName);
+  if (iterator == lookup.end()) {
     return INVALID_INDEX;
   }
   return iterator->second;
@@ -626,6 +632,81 @@ bool Parser::isTrace() const {
   return _tracer != nullptr;
 }
 
+void Parser::setStreamingMode(bool streaming) {
+  _streamingMode = streaming;
+  if (streaming) {
+    _buildParseTrees = false;
+    if (_streamTerminalNode == nullptr) {
+      _streamTerminalNode = new tree::TerminalNodeImpl(nullptr);
+      _streamErrorNode = new tree::ErrorNodeImpl(nullptr);
+    }
+  }
+}
+
+bool Parser::isStreamingMode() const {
+  return _streamingMode;
+}
+
+void Parser::retainNextRuleContext() {
+  _retainNextRuleContext = _streamingMode;
+}
+
+void Parser::enterStreamFrame(ParserRuleContext *localctx) {
+  // The context of a rule is created (by the generated rule function or the interpreter) right before the rule
+  // is entered. Contexts which do not come from the tracker are left alone.
+  size_t position = _tracker.size();
+  if (position > 0 && _tracker.getLast() == localctx) {
+    --position;
+  }
+
+  // On entry of a top level rule, the contexts kept for the caller of the previous one are not needed anymore.
+  if (_streamFrames.empty() && position > 0) {
+    releaseStreamContexts(0, position);
+    position = 0;
+  }
+
+  _streamFrames.push_back({ position, _retainNextRuleContext });
+  _retainNextRuleContext = false;
+}
+
+void Parser::exitStreamFrame() {
+  if (_streamFrames.empty()) {
+    return;
+  }
+
+  StreamFrame frame = _streamFrames.back();
+  _streamFrames.pop_back();
+  if (!frame.retain && !_streamFrames.empty()) {
+    // Releases the context of the rule and the contexts replaced by it (alt label and recursion contexts).
+    releaseStreamContexts(frame.position, _tracker.size());
+  }
+}
+
+void Parser::releaseStreamContexts(size_t begin, size_t end) {
+  _tracker.release(begin, end);
+
+  atn::ParserATNSimulator *simulator = getInterpreter<atn::ParserATNSimulator>();
+  if (simulator != nullptr) {
+    simulator->clearFullContextMemo();
+  }
+}
+
+void Parser::triggerStreamTokenEvent(Token *token, bool isError) {
+  if (isError) {
+    _streamErrorNode->symbol = token;
+    _streamErrorNode->setParent(_ctx);
+    for (auto *listener : _parseListeners) {
+      listener->visitErrorNode(_streamErrorNode);
+    }
+  } else {
+    _streamTerminalNode->symbol = token;
+    _streamTerminalNode->setParent(_ctx);
+    for (auto *listener : _parseListeners) {
+      listener->visitTerminal(_streamTerminalNode);
+    }
+  }
+}
+
 tree::TerminalNode *Parser::createTerminalNode(Token *t) {
   return _tracker.createInstance<tree::TerminalNodeImpl>(t);
 }
@@ -644,5 +725,9 @@ void Parser::InitializeInstanceFields() {
   _input = nullptr;
   _tracer = nullptr;
   _ctx = nullptr;
+  _streamingMode = false;
+  _retainNextRuleContext = false;
+  _streamTerminalNode = nullptr;
+  _streamErrorNode = nullptr;
 }
 
@@ -125,6 +125,29 @@ namespace antlr4 {
     /// using the default <seealso cref="Parser.TrimToSizeListener"/> during the parse process. </returns>
     virtual bool getTrimParseTree();
 
+    /// <summary>
+    /// Switches the parser to (or from) streaming mode. In streaming mode no parse tree is built (this implies
+    /// setBuildParseTree(false), and setBuildParseTree(true) ends streaming mode). The parse listeners are the
+    /// sink of the parse: they receive the enter and exit rule events as usual and a visitTerminal or
+    /// visitErrorNode event for each consumed token and for each token conjured up by error recovery, while
+    /// the rule contexts get no children. Syntax errors are reported to the error listeners as usual.
+    /// <p/>
+    /// Since nothing holds on to the contexts of finished rules, they are released when their rule is exited
+    /// and reused for the next rule invocations, so a parse run needs only as many contexts as the rule
+    /// invocation stack is deep. There are two exceptions: a context stored in a label of the calling rule
+    /// (including the implicit labels of $rule references in actions, e.g. for return values) stays valid until
+    /// the calling rule is exited, and the context returned to the caller of the parser stays valid until the
+    /// next rule function is called or the parser is reset. Any other context a listener or action keeps is only
+    /// valid until the next rule is entered. Terminal and error events use a single node each, which is only
+    /// valid during the call. The mode must not be changed during a parse run.
+    /// </summary>
+    virtual void setStreamingMode(bool streaming);
+    virtual bool isStreamingMode() const;
+
+    /// Called by generated parsers before invoking a rule whose context is stored in a label. In streaming mode
+    /// that context then stays valid until the calling rule is exited (see setStreamingMode()).
+    void retainNextRuleContext();
+
     virtual std::vector<tree::ParseTreeListener *> getParseListeners();
 
     /// <summary>
@@ -203,7 +226,7 @@ namespace antlr4 {
     }
 
     /// The ATN with bypass alternatives is expensive to create so we create it
-    /// lazily. The ATN is owned by us.
+    /// lazily, once per grammar (see ATN::getATNWithBypassAlts()).
     virtual const atn::ATN& getATNWithBypassAlts();
 
     /// <summary>
@@ -222,6 +245,9 @@ namespace antlr4 {
     /// <summary>
     /// The same as <seealso cref="#compileParseTreePattern(String, int)"/> but specify a
     /// <seealso cref="Lexer"/> rather than trying to deduce it from this parser.
+    /// <p/>
+    /// The patterns are compiled by a matcher which this parser keeps for the last lexer used. Each pattern
+    /// shares the ownership of its tree and its matcher, so it can be used as long as this parser lives.
     /// </summary>
     virtual tree::pattern::ParseTreePattern compileParseTreePattern(const std::string &pattern, int patternRuleIndex,
                                                                     Lexer *lexer);
@@ -447,13 +473,30 @@ namespace antlr4 {
     // All rule contexts created during a parse run. This is cleared when calling reset().
     tree::ParseTreeTracker _tracker;
 
-  private:
-    /// This field maps from the serialized ATN string to the deserialized <seealso cref="ATN"/> with
-    /// bypass alternatives.
-    ///
-    /// <seealso cref= ATNDeserializationOptions#isGenerateRuleBypassTransitions() </seealso>
-    static std::map<std::vector<uint16_t>, atn::ATN> bypassAltsAtnCache;
+    /// <seealso cref= #setStreamingMode </seealso>
+    bool _streamingMode;
 
+    struct StreamFrame {
+      size_t position; // The tracker position of the context of the rule invocation.
+      bool retain;     // Set if the context is stored in a label of the calling rule.
+    };
+
+    // In streaming mode, the frame of each active rule invocation. The contexts from the position of the frame
+    // on are released when that rule is exited, unless the frame is retained or the last one (which leaves them
+    // to the calling rule or the caller of the parser).
+    std::vector<StreamFrame> _streamFrames;
+    bool _retainNextRuleContext;
+
+    // The nodes passed to the parse listeners in streaming mode.
+    tree::TerminalNodeImpl *_streamTerminalNode;
+    tree::ErrorNodeImpl *_streamErrorNode;
+
+    void enterStreamFrame(ParserRuleContext *localctx);
+    void exitStreamFrame();
+    void releaseStreamContexts(size_t begin, size_t end);
+    void triggerStreamTokenEvent(Token *token, bool isError);
+
+  private:
     /// When setTrace(true) is called, a reference to the
     /// TraceListener is stored here so it can be easily removed in a
     /// later call to setTrace(false). The listener itself is
@@ -461,6 +504,10 @@ namespace antlr4 {
     /// other parser methods.
     TraceListener *_tracer;
 
+    /// The matcher last used by compileParseTreePattern(), which is kept to share its predictions between all
+    /// patterns compiled for the same lexer.
+    Ref<tree::pattern::ParseTreePatternMatcher> _patternMatcher;
+
     void InitializeInstanceFields();
   };
 
@@ -7,6 +7,7 @@
 #include "atn/RuleStartState.h"
 #include "InterpreterRuleContext.h"
 #include "atn/ParserATNSimulator.h"
+#include "atn/ParserATNSimulatorPredict.h"
 #include "ANTLRErrorStrategy.h"
 #include "atn/LoopEndState.h"
 #include "FailedPredicateException.h"
@@ -24,6 +25,7 @@
 #include "InputMismatchException.h"
 #include "CommonToken.h"
 #include "tree/ErrorNode.h"
+#include "Exceptions.h"
 
 #include "support/CPPUtils.h"
 
@@ -44,18 +46,25 @@ ParserInterpreter::ParserInterpreter(const std::string &grammarFileName, const d
   const std::vector<std::string> &ruleNames, const atn::ATN &atn, TokenStream *input)
   : Parser(input), _grammarFileName(grammarFileName), _atn(atn), _ruleNames(ruleNames), _vocabulary(vocabulary) {
 
-  for (size_t i = 0; i < atn.maxTokenType; ++i) {
-    _tokenNames.push_back(vocabulary.getDisplayName(i));
-  }
-
   // init decision DFA
   for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
     atn::DecisionState *decisionState = atn.getDecisionState(i);
     _decisionToDFA.push_back(dfa::DFA(decisionState, i));
   }
 
-  // get atn simulator that knows how to do predictions
-  _interpreter = new atn::ParserATNSimulator(this, atn, _decisionToDFA, _sharedContextCache); /* mem-check: deleted in d-tor */
+  initialize(_decisionToDFA, _sharedContextCache);
+}
+
+ParserInterpreter::ParserInterpreter(const std::string &grammarFileName, const dfa::Vocabulary &vocabulary,
+  const std::vector<std::string> &ruleNames, const atn::ATN &atn, TokenStream *input,
+  std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache)
+  : Parser(input), _grammarFileName(grammarFileName), _atn(atn), _ruleNames(ruleNames), _vocabulary(vocabulary) {
+
+  if (decisionToDFA.size() != atn.getNumberOfDecisions()) {
+    throw IllegalArgumentException("There must be one DFA for each decision of the ATN.");
+  }
+
+  initialize(decisionToDFA, sharedContextCache);
 }
 
 ParserInterpreter::~ParserInterpreter() {
@@ -63,11 +72,37 @@ ParserInterpreter::~ParserInterpreter() {
 }
 
 void ParserInterpreter::reset() {
+  // Parser::reset() would delete all nodes, including the released ones which are reused by the next parse.
+  tree::ParseTreeTracker trees;
+  std::swap(trees, _tracker);
   Parser::reset();
+  std::swap(trees, _tracker);
+
+  if (!_keepParseTrees) {
+    _tracker.release(0);
+    _rootContext = nullptr;
+  }
   _overrideDecisionReached = false;
   _overrideDecisionRoot = nullptr;
 }
 
+void ParserInterpreter::releaseContexts() {
+  _tracker.release(0);
+  _rootContext = nullptr;
+  _overrideDecisionRoot = nullptr;
+
+  // The full context memo refers to contexts, whose memory is about to be reused.
+  getInterpreter<atn::ParserATNSimulator>()->reset();
+}
+
+void ParserInterpreter::setKeepParseTrees(bool keep) {
+  _keepParseTrees = keep;
+}
+
+bool ParserInterpreter::getKeepParseTrees() const {
+  return _keepParseTrees;
+}
+
 const atn::ATN& ParserInterpreter::getATN() const {
   return _atn;
 }
@@ -161,16 +196,17 @@ atn::ATNState* ParserInterpreter::getATNState() {
 
 void ParserInterpreter::visitState(atn::ATNState *p) {
   size_t predictedAlt = 1;
-  if (is<DecisionState *>(p)) {
-    predictedAlt = visitDecisionState(dynamic_cast<DecisionState *>(p));
+  DecisionState *decisionState = _decisionStates[p->stateNumber];
+  if (decisionState != nullptr) {
+    predictedAlt = visitDecisionState(decisionState);
   }
 
   atn::Transition *transition = p->transitions[predictedAlt - 1];
   switch (transition->getSerializationType()) {
     case atn::Transition::EPSILON:
       if (p->getStateType() == ATNState::STAR_LOOP_ENTRY &&
-        (dynamic_cast<StarLoopEntryState *>(p))->isPrecedenceDecision &&
-        !is<LoopEndState *>(transition->target)) {
+        static_cast<StarLoopEntryState *>(p)->isPrecedenceDecision &&
+        transition->target->getStateType() != ATNState::LOOP_END) {
         // We are at the start of a left recursive rule's (...)* loop
         // and we're not taking the exit branch of loop.
         InterpreterRuleContext *localctx = createInterpreterRuleContext(_parentContextStack.top().first,
@@ -249,7 +285,7 @@ size_t ParserInterpreter::visitDecisionState(DecisionState *p) {
       predictedAlt = _overrideDecisionAlt;
       _overrideDecisionReached = true;
     } else {
-      predictedAlt = getInterpreter<ParserATNSimulator>()->adaptivePredict(_input, decision, _ctx);
+      predictedAlt = getInterpreter<ParserATNSimulator>()->predict(_input, decision, _ctx);
     }
   }
   return predictedAlt;
@@ -304,3 +340,17 @@ void ParserInterpreter::recover(RecognitionException &e) {
 Token* ParserInterpreter::recoverInline() {
   return _errHandler->recoverInline(this);
 }
+
+void ParserInterpreter::initialize(std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache) {
+  for (size_t i = 0; i < _atn.maxTokenType; ++i) {
+    _tokenNames.push_back(_vocabulary.getDisplayName(i));
+  }
+
+  _decisionStates.reserve(_atn.states.size());
+  for (ATNState *state : _atn.states) {
+    _decisionStates.push_back(dynamic_cast<DecisionState *>(state));
+  }
+
+  // get atn simulator that knows how to do predictions
+  _interpreter = new atn::ParserATNSimulator(this, _atn, decisionToDFA, sharedContextCache); /* mem-check: deleted in d-tor */
+}
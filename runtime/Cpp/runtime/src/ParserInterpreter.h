@@ -34,10 +34,30 @@ namespace antlr4 {
       const std::vector<std::string>& ruleNames, const atn::ATN &atn, TokenStream *input);
     ParserInterpreter(const std::string &grammarFileName, const dfa::Vocabulary &vocabulary,
                       const std::vector<std::string> &ruleNames, const atn::ATN &atn, TokenStream *input);
+
+    /// Uses the given DFAs (one per decision of the ATN, as for generated parsers) and prediction context cache
+    /// instead of private ones, so that all interpreters for the same grammar share their predictions like the
+    /// instances of a generated parser do, instead of each one starting from scratch. Both must outlive the
+    /// interpreter.
+    ParserInterpreter(const std::string &grammarFileName, const dfa::Vocabulary &vocabulary,
+                      const std::vector<std::string> &ruleNames, const atn::ATN &atn, TokenStream *input,
+                      std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache);
     ~ParserInterpreter();
 
+    /// Also releases the parse trees of earlier parse() calls, unless they are kept (see setKeepParseTrees()).
     virtual void reset() override;
 
+    /// Releases the parse trees of all earlier parse() calls. Their memory is reused for the nodes of the
+    /// following parses, which saves allocations when one interpreter parses many inputs. No node of an
+    /// earlier tree may be used after this call.
+    void releaseContexts();
+
+    /// By default the trees of earlier parse() calls are released when the interpreter is reset (which also
+    /// happens when it gets a new input). With keep set to true they stay valid until releaseContexts() is
+    /// called or the interpreter is destroyed.
+    void setKeepParseTrees(bool keep);
+    bool getKeepParseTrees() const;
+
     virtual const atn::ATN& getATN() const override;
 
     // @deprecated
@@ -48,7 +68,9 @@ namespace antlr4 {
     virtual const std::vector<std::string>& getRuleNames() const override;
     virtual std::string getGrammarFileName() const override;
 
-    /// Begin parsing at startRuleIndex
+    /// Begin parsing at startRuleIndex.
+    /// The returned tree is owned by the interpreter. It stays valid until the interpreter is reset, gets a new
+    /// input, releaseContexts() is called or the interpreter is destroyed (see also setKeepParseTrees()).
     virtual ParserRuleContext* parse(size_t startRuleIndex);
 
     virtual void enterRecursionRule(ParserRuleContext *localctx, size_t state, size_t ruleIndex, int precedence) override;
@@ -131,7 +153,7 @@ namespace antlr4 {
      *  Those values are used to create new recursive rule invocation contexts
      *  associated with left operand of an alt like "expr '*' expr".
      */
-    std::stack<std::pair<ParserRuleContext *, size_t>> _parentContextStack;
+    std::stack<std::pair<ParserRuleContext *, size_t>, std::vector<std::pair<ParserRuleContext *, size_t>>> _parentContextStack;
 
     /** We need a map from (decision,inputIndex)->forced alt for computing ambiguous
      *  parse trees. For now, we allow exactly one override.
@@ -147,6 +169,7 @@ namespace antlr4 {
      */
     Ref<InterpreterRuleContext> _overrideDecisionRoot;
     InterpreterRuleContext* _rootContext;
+    bool _keepParseTrees = false;
 
     virtual atn::ATNState *getATNState();
     virtual void visitState(atn::ATNState *p);
@@ -158,6 +181,7 @@ namespace antlr4 {
     size_t visitDecisionState(atn::DecisionState *p);
 
     /** Provide simple "factory" for InterpreterRuleContext's.
+     *  The memory of the nodes released by releaseContexts() is reused.
      *  @since 4.5.1
      */
     InterpreterRuleContext* createInterpreterRuleContext(ParserRuleContext *parent, size_t invokingStateNumber, size_t ruleIndex);
@@ -174,6 +198,11 @@ namespace antlr4 {
   private:
     const dfa::Vocabulary &_vocabulary;
     std::unique_ptr<Token> _errorToken;
+
+    /// The decision state for each ATN state (nullptr for other states), to avoid type checks in visitState().
+    std::vector<atn::DecisionState *> _decisionStates;
+
+    void initialize(std::vector<dfa::DFA> &decisionToDFA, atn::PredictionContextCache &sharedContextCache);
   };
 
 } // namespace antlr4
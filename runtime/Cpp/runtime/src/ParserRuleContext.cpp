@@ -20,6 +20,50 @@ using namespace antlrcpp;
 
 ParserRuleContext ParserRuleContext::EMPTY;
 
+namespace {
+
+  // Contexts with at most this many children are searched linearly, which is faster than maintaining an index.
+  const size_t ChildIndexThreshold = 8;
+
+}
+
+struct ParserRuleContext::ChildIndex {
+  size_t childCount = 0;
+  std::unordered_map<size_t, std::vector<tree::TerminalNode *>> tokens;
+  std::unordered_map<size_t, std::vector<RuleContext *>> contexts;
+
+  void add(tree::ParseTree *child) {
+    ++childCount;
+    if (is<tree::TerminalNode *>(child)) {
+      tree::TerminalNode *tnode = static_cast<tree::TerminalNode *>(child);
+      tokens[tnode->getSymbol()->getType()].push_back(tnode);
+    } else if (is<RuleContext *>(child)) {
+      RuleContext *context = static_cast<RuleContext *>(child);
+      contexts[context->getRuleIndex()].push_back(context);
+    }
+  }
+
+  // Removes the child which was added last. Returns false if it is not the last one of its kind (which can only be
+  // if the children list was changed directly), so the index must be dropped.
+  bool removeLast(tree::ParseTree *child) {
+    --childCount;
+    if (is<tree::TerminalNode *>(child)) {
+      auto &list = tokens[static_cast<tree::TerminalNode *>(child)->getSymbol()->getType()];
+      if (list.empty() || list.back() != child) {
+        return false;
+      }
+      list.pop_back();
+    } else if (is<RuleContext *>(child)) {
+      auto &list = contexts[static_cast<RuleContext *>(child)->getRuleIndex()];
+      if (list.empty() || list.back() != child) {
+        return false;
+      }
+      list.pop_back();
+    }
+    return true;
+  }
+};
+
 ParserRuleContext::ParserRuleContext()
   : start(nullptr), stop(nullptr) {
 }
@@ -28,6 +72,9 @@ ParserRuleContext::ParserRuleContext(ParserRuleContext *parent, size_t invokingS
 : RuleContext(parent, invokingStateNumber), start(nullptr), stop(nullptr) {
 }
 
+ParserRuleContext::~ParserRuleContext() {
+}
+
 void ParserRuleContext::copyFrom(ParserRuleContext *ctx) {
   // from RuleContext
   this->parent = ctx->parent;
@@ -36,6 +83,9 @@ void ParserRuleContext::copyFrom(ParserRuleContext *ctx) {
   this->start = ctx->start;
   this->stop = ctx->stop;
 
+  _childIndex.reset();
+  ctx->_childIndex.reset();
+
   // copy any error nodes to alt label node
   if (!ctx->children.empty()) {
     for (auto *child : ctx->children) {
@@ -62,25 +112,44 @@ void ParserRuleContext::exitRule(tree::ParseTreeListener * /*listener*/) {
 tree::TerminalNode* ParserRuleContext::addChild(tree::TerminalNode *t) {
   t->setParent(this);
   children.push_back(t);
+  updateChildIndex();
   return t;
 }
 
 RuleContext* ParserRuleContext::addChild(RuleContext *ruleInvocation) {
   children.push_back(ruleInvocation);
+  updateChildIndex();
   return ruleInvocation;
 }
 
 void ParserRuleContext::removeLastChild() {
   if (!children.empty()) {
+    tree::ParseTree *child = children.back();
+    if (_childIndex != nullptr && (_childIndex->childCount != children.size() || !_childIndex->removeLast(child))) {
+      _childIndex.reset();
+    }
     children.pop_back();
   }
 }
 
+void ParserRuleContext::resetChildIndex() {
+  _childIndex.reset();
+}
+
 tree::TerminalNode* ParserRuleContext::getToken(size_t ttype, size_t i) {
   if (i >= children.size()) {
     return nullptr;
   }
 
+  ChildIndex *index = getChildIndex();
+  if (index != nullptr) {
+    auto iterator = index->tokens.find(ttype);
+    if (iterator == index->tokens.end() || i >= iterator->second.size()) {
+      return nullptr;
+    }
+    return iterator->second[i];
+  }
+
   size_t j = 0; // what token with ttype have we found?
   for (auto *o : children) {
     if (is<tree::TerminalNode *>(o)) {
@@ -98,6 +167,15 @@ tree::TerminalNode* ParserRuleContext::getToken(size_t ttype, size_t i) {
 }
 
 std::vector<tree::TerminalNode *> ParserRuleContext::getTokens(size_t ttype) {
+  ChildIndex *index = getChildIndex();
+  if (index != nullptr) {
+    auto iterator = index->tokens.find(ttype);
+    if (iterator == index->tokens.end()) {
+      return {};
+    }
+    return iterator->second;
+  }
+
   std::vector<tree::TerminalNode *> tokens;
   for (auto &o : children) {
     if (is<tree::TerminalNode *>(o)) {
@@ -112,6 +190,79 @@ std::vector<tree::TerminalNode *> ParserRuleContext::getTokens(size_t ttype) {
   return tokens;
 }
 
+void ParserRuleContext::updateChildIndex() {
+  if (_childIndex != nullptr && _childIndex->childCount + 1 == children.size()) {
+    _childIndex->add(children.back());
+    return;
+  }
+
+  // An index which does not match the number of children is out of date (the children list was changed directly).
+  // It is dropped, even if the list is small now, as it could match again by chance after more children are added.
+  _childIndex.reset();
+  if (children.size() > ChildIndexThreshold) {
+    _childIndex.reset(new ChildIndex());
+    for (auto *child : children) {
+      _childIndex->add(child);
+    }
+  }
+}
+
+ParserRuleContext::ChildIndex* ParserRuleContext::getChildIndex() const {
+  // The index is never built here, so lookups do not modify the context and concurrent read only walks are safe.
+  if (_childIndex != nullptr && _childIndex->childCount == children.size()) {
+    return _childIndex.get();
+  }
+  return nullptr;
+}
+
+RuleContext* ParserRuleContext::getChildContext(size_t ruleIndex, size_t i) {
+  if (i >= children.size()) {
+    return nullptr;
+  }
+
+  ChildIndex *index = getChildIndex();
+  if (index != nullptr) {
+    auto iterator = index->contexts.find(ruleIndex);
+    if (iterator == index->contexts.end() || i >= iterator->second.size()) {
+      return nullptr;
+    }
+    return iterator->second[i];
+  }
+
+  size_t j = 0;
+  for (auto *child : children) {
+    if (is<RuleContext *>(child)) {
+      RuleContext *context = static_cast<RuleContext *>(child);
+      if (context->getRuleIndex() == ruleIndex && j++ == i) {
+        return context;
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::vector<RuleContext *> ParserRuleContext::getChildContexts(size_t ruleIndex) {
+  ChildIndex *index = getChildIndex();
+  if (index != nullptr) {
+    auto iterator = index->contexts.find(ruleIndex);
+    if (iterator == index->contexts.end()) {
+      return {};
+    }
+    return iterator->second;
+  }
+
+  std::vector<RuleContext *> contexts;
+  for (auto *child : children) {
+    if (is<RuleContext *>(child)) {
+      RuleContext *context = static_cast<RuleContext *>(child);
+      if (context->getRuleIndex() == ruleIndex) {
+        contexts.push_back(context);
+      }
+    }
+  }
+  return contexts;
+}
+
 misc::Interval ParserRuleContext::getSourceInterval() {
   if (start == nullptr) {
     return misc::Interval::INVALID;
@@ -123,6 +274,21 @@ misc::Interval ParserRuleContext::getSourceInterval() {
   return misc::Interval(start->getTokenIndex(), stop->getTokenIndex());
 }
 
+std::string ParserRuleContext::getText() {
+  std::string text;
+  if (start != nullptr && stop != nullptr && start->getStartIndex() != INVALID_INDEX
+      && stop->getStopIndex() != INVALID_INDEX && stop->getStopIndex() >= start->getStartIndex()) {
+    // Counts characters of all channels, which is at least close to the size of the result.
+    text.reserve(stop->getStopIndex() - start->getStartIndex() + 1);
+  }
+  appendChildrenText(text);
+  return text;
+}
+
+bool ParserRuleContext::hasDefaultGetText() const {
+  return typeid(*this) == typeid(ParserRuleContext);
+}
+
 Token* ParserRuleContext::getStart() {
   return start;
 }
@@ -67,7 +67,7 @@ namespace antlr4 {
 
     ParserRuleContext();
     ParserRuleContext(ParserRuleContext *parent, size_t invokingStateNumber);
-    virtual ~ParserRuleContext() {}
+    virtual ~ParserRuleContext();
 
     /** COPY a ctx (I'm deliberately not using copy constructor) to avoid
      *  confusion with creating node with parent. Does not copy children
@@ -90,6 +90,10 @@ namespace antlr4 {
     /// generic ruleContext object.
     virtual void removeLastChild();
 
+    /// Drops the index of the children (see getRuleContext(ruleIndex, i)). Code which replaces entries of the
+    /// children list directly must call this, as only a changed number of children is detected otherwise.
+    void resetChildIndex();
+
     virtual tree::TerminalNode* getToken(size_t ttype, std::size_t i);
 
     virtual std::vector<tree::TerminalNode *> getTokens(size_t ttype);
@@ -123,8 +127,36 @@ namespace antlr4 {
       return contexts;
     }
 
+    /// Returns the i-th child context of the rule with the given index or nullptr if there is none.
+    /// Unlike getRuleContext<T>(i) this makes no type checks, so all child contexts of that rule must be instances
+    /// of T, as in generated parsers, which use this form. Contexts with many children index them by token type
+    /// and rule index (also for getToken() and getTokens()), so accessing all children one by one takes linear
+    /// instead of quadratic time. The index is maintained by addChild() and removeLastChild() only, so lookups do
+    /// not modify the context and can run concurrently. After the children list was changed directly, lookups
+    /// search linearly until the next addChild() rebuilds the index.
+    template<typename T>
+    T* getRuleContext(size_t ruleIndex, size_t i) {
+      return static_cast<T *>(getChildContext(ruleIndex, i));
+    }
+
+    /// Returns all child contexts of the rule with the given index. The same restrictions as for
+    /// getRuleContext(ruleIndex, i) apply.
+    template<typename T>
+    std::vector<T *> getRuleContexts(size_t ruleIndex) {
+      std::vector<T *> contexts;
+      for (RuleContext *context : getChildContexts(ruleIndex)) {
+        contexts.push_back(static_cast<T *>(context));
+      }
+
+      return contexts;
+    }
+
     virtual misc::Interval getSourceInterval() override;
 
+    /// Like RuleContext::getText(), but reserves the size of the matched input (if known) in advance.
+    virtual std::string getText() override;
+    virtual bool hasDefaultGetText() const override;
+
     /**
      * Get the initial token in this context.
      * Note that the range from start to stop is inclusive, so for rules that do not consume anything
@@ -142,6 +174,21 @@ namespace antlr4 {
     /// <summary>
     /// Used for rule context info debugging during parse-time, not so much for ATN debugging </summary>
     virtual std::string toInfoString(Parser *recognizer);
+
+  private:
+    struct ChildIndex;
+
+    /// Created when the number of children exceeds a threshold. It is updated when children are added or the last
+    /// one is removed, and rebuilt when the number of children does not match anymore (e.g. after changing the
+    /// children list directly).
+    std::unique_ptr<ChildIndex> _childIndex;
+
+    void updateChildIndex();
+
+    /// Returns the child index or nullptr if there is none, or it is out of date.
+    ChildIndex* getChildIndex() const;
+    RuleContext* getChildContext(size_t ruleIndex, size_t i);
+    std::vector<RuleContext *> getChildContexts(size_t ruleIndex);
   };
 
 } // namespace antlr4
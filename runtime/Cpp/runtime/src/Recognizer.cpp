@@ -19,8 +19,35 @@
 using namespace antlr4;
 using namespace antlr4::atn;
 
-std::map<const dfa::Vocabulary*, std::map<std::string, size_t>> Recognizer::_tokenTypeMapCache;
-std::map<std::vector<std::string>, std::map<std::string, size_t>> Recognizer::_ruleIndexMapCache;
+namespace {
+
+  using NameLookup = std::unordered_map<std::string, size_t>;
+
+  // The names a shared lookup was built from. The key is only the address of the vocabulary or rule name list,
+  // so the names are compared too, in case that address got reused for other names (e.g. by interpreters, which
+  // own their names). This is done only once per recognizer.
+  struct SharedLookup {
+    std::vector<std::string> names;
+    Ref<const NameLookup> lookup;
+  };
+
+  std::mutex sharedLookupMutex;
+  std::unordered_map<const void *, SharedLookup> tokenTypeLookups;
+  std::unordered_map<const void *, SharedLookup> ruleIndexLookups;
+
+  template <typename Builder>
+  Ref<const NameLookup> getSharedLookup(std::unordered_map<const void *, SharedLookup> &lookups, const void *key,
+                                        std::vector<std::string> names, Builder build) {
+    std::lock_guard<std::mutex> lck(sharedLookupMutex);
+    SharedLookup &entry = lookups[key];
+    if (entry.lookup == nullptr || entry.names != names) {
+      entry.lookup = std::make_shared<const NameLookup>(build(names));
+      entry.names = std::move(names);
+    }
+    return entry.lookup;
+  }
+
+}
 
 Recognizer::Recognizer() {
   InitializeInstanceFields();
@@ -36,59 +63,68 @@ dfa::Vocabulary const& Recognizer::getVocabulary() const {
 }
 
 std::map<std::string, size_t> Recognizer::getTokenTypeMap() {
-  const dfa::Vocabulary& vocabulary = getVocabulary();
-
-  std::lock_guard<std::mutex> lck(_mutex);
-  std::map<std::string, size_t> result;
-  auto iterator = _tokenTypeMapCache.find(&vocabulary);
-  if (iterator != _tokenTypeMapCache.end()) {
-    result = iterator->second;
-  } else {
-    for (size_t i = 0; i <= getATN().maxTokenType; ++i) {
-      std::string literalName = vocabulary.getLiteralName(i);
-      if (!literalName.empty()) {
-        result[literalName] = i;
-      }
-
-      std::string symbolicName = vocabulary.getSymbolicName(i);
-      if (!symbolicName.empty()) {
-        result[symbolicName] = i;
-      }
-				}
-    result["EOF"] = EOF;
-    _tokenTypeMapCache[&vocabulary] = result;
-  }
-
-  return result;
+  const NameLookup &lookup = getTokenTypeLookup();
+  return std::map<std::string, size_t>(lookup.begin(), lookup.end());
 }
 
 std::map<std::string, size_t> Recognizer::getRuleIndexMap() {
-  const std::vector<std::string>& ruleNames = getRuleNames();
-  if (ruleNames.empty()) {
-    throw "The current recognizer does not provide a list of rule names.";
-  }
-
-  std::lock_guard<std::mutex> lck(_mutex);
-  std::map<std::string, size_t> result;
-  auto iterator = _ruleIndexMapCache.find(ruleNames);
-  if (iterator != _ruleIndexMapCache.end()) {
-    result = iterator->second;
-  } else {
-    result = antlrcpp::toMap(ruleNames);
-    _ruleIndexMapCache[ruleNames] = result;
-  }
-  return result;
+  const NameLookup &lookup = getRuleIndexLookup();
+  return std::map<std::string, size_t>(lookup.begin(), lookup.end());
 }
 
 size_t Recognizer::getTokenType(const std::string &tokenName) {
-  const std::map<std::string, size_t> &map = getTokenTypeMap();
-  auto iterator = map.find(tokenName);
-  if (iterator == map.end())
+  const NameLookup &lookup = getTokenTypeLookup();
+  auto iterator = lookup.find(tokenName);
+  if (iterator == lookup.end())
     return Token::INVALID_TYPE;
 
   return iterator->second;
 }
 
+const std::unordered_map<std::string, size_t>& Recognizer::getTokenTypeLookup() {
+  std::call_once(_tokenTypeLookupInitialized, [this]() {
+    const dfa::Vocabulary& vocabulary = getVocabulary();
+
+    // Literal and symbolic name of each token type.
+    std::vector<std::string> names;
+    names.reserve(2 * (getATN().maxTokenType + 1));
+    for (size_t i = 0; i <= getATN().maxTokenType; ++i) {
+      names.push_back(vocabulary.getLiteralName(i));
+      names.push_back(vocabulary.getSymbolicName(i));
+    }
+
+    _tokenTypeLookup = getSharedLookup(tokenTypeLookups, &vocabulary, std::move(names), [](const std::vector<std::string> &names) {
+      NameLookup result;
+      for (size_t i = 0; i < names.size(); ++i) {
+        if (!names[i].empty()) {
+          result[names[i]] = i / 2;
+        }
+      }
+      result["EOF"] = EOF;
+      return result;
+    });
+  });
+  return *_tokenTypeLookup;
+}
+
+const std::unordered_map<std::string, size_t>& Recognizer::getRuleIndexLookup() {
+  std::call_once(_ruleIndexLookupInitialized, [this]() {
+    const std::vector<std::string>& ruleNames = getRuleNames();
+    if (ruleNames.empty()) {
+      throw "The current recognizer does not provide a list of rule names.";
+    }
+
+    _ruleIndexLookup = getSharedLookup(ruleIndexLookups, &ruleNames, ruleNames, [](const std::vector<std::string> &names) {
+      NameLookup result;
+      for (size_t i = 0; i < names.size(); ++i) {
+        result.insert({ names[i], i });
+      }
+      return result;
+    });
+  });
+  return *_ruleIndexLookup;
+}
+
 void Recognizer::setInterpreter(atn::ATNSimulator *interpreter) {
   // Usually the interpreter is set by the descendant (lexer or parser (simulator), but can also be exchanged
   // by the profiling ATN simulator.
@@ -45,14 +45,15 @@ namespace antlr4 {
     /// <summary>
     /// Get a map from token names to token types.
     /// <p/>
-    /// Used for XPath and tree pattern compilation.
+    /// This is a copy of the lookup table used by getTokenType(), which should be preferred for single lookups.
     /// </summary>
     virtual std::map<std::string, size_t> getTokenTypeMap();
 
     /// <summary>
     /// Get a map from rule names to rule indexes.
     /// <p/>
-    /// Used for XPath and tree pattern compilation.
+    /// This is a copy of the lookup table used by Parser::getRuleIndex(), which should be preferred for single
+    /// lookups.
     /// </summary>
     virtual std::map<std::string, size_t> getRuleIndexMap();
 
@@ -155,9 +156,17 @@ namespace antlr4 {
     // Mutex to manage synchronized access for multithreading.
     std::mutex _mutex;
 
+    /// Lookup tables from token names to token types and from rule names to rule indexes. They are built once per
+    /// grammar (identified by the vocabulary and the rule names instance) and shared by all its recognizers.
+    /// Each recognizer fetches them only on first use, after that no locks are involved.
+    const std::unordered_map<std::string, size_t>& getTokenTypeLookup();
+    const std::unordered_map<std::string, size_t>& getRuleIndexLookup();
+
   private:
-    static std::map<const dfa::Vocabulary*, std::map<std::string, size_t>> _tokenTypeMapCache;
-    static std::map<std::vector<std::string>, std::map<std::string, size_t>> _ruleIndexMapCache;
+    std::once_flag _tokenTypeLookupInitialized;
+    std::once_flag _ruleIndexLookupInitialized;
+    Ref<const std::unordered_map<std::string, size_t>> _tokenTypeLookup;
+    Ref<const std::unordered_map<std::string, size_t>> _ruleIndexLookup;
 
     ProxyErrorListener _proxListener; // Manages a collection of listeners.
 
@@ -46,18 +46,29 @@ misc::Interval RuleContext::getSourceInterval() {
 }
 
 std::string RuleContext::getText() {
-  if (children.empty()) {
-    return "";
-  }
+  std::string text;
+  appendChildrenText(text);
+  return text;
+}
 
-  std::stringstream ss;
-  for (size_t i = 0; i < children.size(); i++) {
-    ParseTree *tree = children[i];
-    if (tree != nullptr)
-      ss << tree->getText();
+void RuleContext::appendText(std::string &text) {
+  if (hasDefaultGetText()) {
+    appendChildrenText(text);
+  } else {
+    text += getText();
   }
+}
 
-  return ss.str();
+bool RuleContext::hasDefaultGetText() const {
+  return typeid(*this) == typeid(RuleContext);
+}
+
+void RuleContext::appendChildrenText(std::string &text) {
+  for (ParseTree *tree : children) {
+    if (tree != nullptr) {
+      tree->appendText(text);
+    }
+  }
 }
 
 size_t RuleContext::getRuleIndex() const {
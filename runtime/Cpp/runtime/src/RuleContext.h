@@ -79,6 +79,12 @@ namespace antlr4 {
     virtual misc::Interval getSourceInterval() override;
 
     virtual std::string getText() override;
+    virtual void appendText(std::string &text) override;
+
+    /// Returns true if getText() is known not to be overridden for the dynamic type of this context. Only then
+    /// appendText() appends the text of the children directly, otherwise it calls getText(). Each class which
+    /// does not override getText() can override this to return true for its own type (as generated contexts do).
+    virtual bool hasDefaultGetText() const;
 
     virtual size_t getRuleIndex() const;
 
@@ -130,6 +136,10 @@ namespace antlr4 {
 
     bool operator == (const RuleContext &other) { return this == &other; } // Simple address comparison.
 
+  protected:
+    /// Appends the text of all children to the given string.
+    void appendChildrenText(std::string &text);
+
   private:
     void InitializeInstanceFields();
   };
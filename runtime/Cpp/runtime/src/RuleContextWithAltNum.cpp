@@ -25,3 +25,7 @@ size_t RuleContextWithAltNum::getAltNumber() const {
 void RuleContextWithAltNum::setAltNumber(size_t number) {
   altNum = number;
 }
+
+bool RuleContextWithAltNum::hasDefaultGetText() const {
+  return typeid(*this) == typeid(RuleContextWithAltNum);
+}
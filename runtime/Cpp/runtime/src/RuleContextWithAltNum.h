@@ -27,6 +27,7 @@ namespace antlr4 {
 
     virtual size_t getAltNumber() const override;
     virtual void setAltNumber(size_t altNum) override;
+    virtual bool hasDefaultGetText() const override;
   };
 
 } // namespace antlr4
@@ -3,7 +3,29 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "Token.h"
+
 #include "TokenSource.h"
 
-antlr4::TokenSource::~TokenSource() {
+using namespace antlr4;
+
+TokenSource::~TokenSource() {
+}
+
+size_t TokenSource::nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n) {
+  size_t i = 0;
+  while (i < n) {
+    std::unique_ptr<Token> t = nextToken();
+    if (t == nullptr) {
+      break;
+    }
+
+    tokens.push_back(std::move(t));
+    ++i;
+
+    if (tokens.back()->getType() == Token::EOF) {
+      break;
+    }
+  }
+  return i;
 }
@@ -34,6 +34,13 @@ namespace antlr4 {
     /// to the parser.
     virtual std::unique_ptr<Token> nextToken() = 0;
 
+    /// Append up to {@code n} tokens to {@code tokens}, stopping after the EOF token.
+    /// Token streams use this to fetch tokens in blocks, which allows an implementation to
+    /// amortize its per-token overhead. The default implementation calls <seealso cref="#nextToken"/>
+    /// for each token.
+    /// <returns> The number of tokens added to the list. </returns>
+    virtual size_t nextTokens(std::vector<std::unique_ptr<Token>> &tokens, size_t n);
+
     /// <summary>
     /// Get the line number for the current position in the input stream. The
     /// first line in the input is line 1.
@@ -38,10 +38,7 @@ size_t TokenStreamRewriter::RewriteOperation::execute(std::string * /*buf*/) {
 }
 
 std::string TokenStreamRewriter::RewriteOperation::toString() {
-  std::string opName = "TokenStreamRewriter";
-  size_t dollarIndex = opName.find('$');
-  opName = opName.substr(dollarIndex + 1, opName.length() - (dollarIndex + 1));
-  return "<" + opName + "@" + outerInstance->tokens->get(dollarIndex)->getText() + ":\"" + text + "\">";
+  return "<InsertBeforeOp@" + outerInstance->tokens->get(index)->getText() + ":\"" + text + "\">";
 }
 
 void TokenStreamRewriter::RewriteOperation::InitializeInstanceFields() {
@@ -93,11 +90,7 @@ TokenStreamRewriter::TokenStreamRewriter(TokenStream *tokens_) : tokens(tokens_)
 }
 
 TokenStreamRewriter::~TokenStreamRewriter() {
-  for (auto program : _programs) {
-    for (auto *operation : program.second) {
-      delete operation;
-    }
-  }
+  // All operations are owned by the pools.
 }
 
 TokenStream *TokenStreamRewriter::getTokenStream() {
@@ -109,9 +102,17 @@ void TokenStreamRewriter::rollback(size_t instructionIndex) {
 }
 
 void TokenStreamRewriter::rollback(const std::string &programName, size_t instructionIndex) {
-  std::vector<RewriteOperation*> is = _programs[programName];
-  if (is.size() > 0) {
-    _programs.insert({ programName, std::vector<RewriteOperation*>(is.begin() + MIN_TOKEN_INDEX, is.begin() + instructionIndex) });
+  auto iterator = _programs.find(programName);
+  if (iterator == _programs.end()) {
+    return;
+  }
+
+  std::vector<RewriteOperation*> &is = iterator->second;
+  for (size_t i = instructionIndex; i < is.size(); ++i) {
+    releaseOperation(is[i]);
+  }
+  if (instructionIndex < is.size()) {
+    is.resize(instructionIndex);
   }
 }
 
@@ -153,7 +154,7 @@ void TokenStreamRewriter::insertBefore(const std::string &programName, Token *t,
 }
 
 void TokenStreamRewriter::insertBefore(const std::string &programName, size_t index, const std::string& text) {
-  RewriteOperation *op = new InsertBeforeOp(this, index, text); /* mem-check: deleted in d-tor */
+  RewriteOperation *op = createInsertBeforeOp(index, text);
   std::vector<RewriteOperation*> &rewrites = getProgram(programName);
   op->instructionIndex = rewrites.size();
   rewrites.push_back(op);
@@ -180,7 +181,7 @@ void TokenStreamRewriter::replace(const std::string &programName, size_t from, s
     throw IllegalArgumentException("replace: range invalid: " + std::to_string(from) + ".." + std::to_string(to) +
                                    "(size = " + std::to_string(tokens->size()) + ")");
   }
-  RewriteOperation *op = new ReplaceOp(this, from, to, text); /* mem-check: deleted in d-tor */
+  RewriteOperation *op = createReplaceOp(from, to, text);
   std::vector<RewriteOperation*> &rewrites = getProgram(programName);
   op->instructionIndex = rewrites.size();
   rewrites.push_back(op);
@@ -269,30 +270,55 @@ std::string TokenStreamRewriter::getText(const std::string &programName, const I
     start = 0;
   }
 
-  if (rewrites.empty() || rewrites.empty()) {
+  if (rewrites.empty()) {
     return tokens->getText(interval); // no instructions to execute
   }
-  std::string buf;
 
   // First, optimize instruction stream
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> indexToOp = reduceToSingleOperationPerIndex(rewrites);
+  std::vector<TokenStreamRewriter::RewriteOperation*> ops = reduceToSingleOperationPerIndex(rewrites);
+
+  // Size the buffer for the original text of the range plus everything the operations may add.
+  size_t expectedSize = 0;
+  for (auto *op : ops) {
+    expectedSize += op->text.size();
+  }
+  if (start <= stop) {
+    size_t firstChar = tokens->get(start)->getStartIndex();
+    size_t lastChar = tokens->get(stop)->getStopIndex();
+    if (firstChar != INVALID_INDEX && lastChar != INVALID_INDEX && lastChar >= firstChar) {
+      expectedSize += lastChar - firstChar + 1;
+    }
+  }
+  std::string buf;
+  buf.reserve(expectedSize);
+
+  auto byIndex = [](RewriteOperation *op, size_t index) {
+    return op->index < index;
+  };
 
   // Walk buffer, executing instructions and emitting tokens
+  auto nextOp = std::lower_bound(ops.begin(), ops.end(), start, byIndex);
+  bool executedAtLastIndex = false;
   size_t i = start;
   while (i <= stop && i < tokens->size()) {
-    RewriteOperation *op = indexToOp[i];
-    indexToOp.erase(i); // remove so any left have index size-1
-    Token *t = tokens->get(i);
-    if (op == nullptr) {
+    // Operations in a range which has been replaced are skipped.
+    while (nextOp != ops.end() && (*nextOp)->index < i) {
+      ++nextOp;
+    }
+
+    if (nextOp != ops.end() && (*nextOp)->index == i) {
+      if (i == tokens->size() - 1) {
+        executedAtLastIndex = true;
+      }
+      i = (*nextOp++)->execute(&buf); // execute operation and skip
+    } else {
       // no operation at that index, just dump token
+      Token *t = tokens->get(i);
       if (t->getType() != Token::EOF) {
         buf.append(t->getText());
       }
       i++; // move to next token
     }
-    else {
-      i = op->execute(&buf); // execute operation and skip
-    }
   }
 
   // include stuff after end if it's last index in buffer
@@ -301,49 +327,95 @@ std::string TokenStreamRewriter::getText(const std::string &programName, const I
   if (stop == tokens->size() - 1) {
     // Scan any remaining operations after last token
     // should be included (they will be inserts).
-    for (auto op : indexToOp) {
-      if (op.second->index >= tokens->size() - 1) {
-        buf.append(op.second->text);
+    for (auto iterator = std::lower_bound(ops.begin(), ops.end(), tokens->size() - 1, byIndex); iterator != ops.end(); ++iterator) {
+      if ((*iterator)->index == tokens->size() - 1 && executedAtLastIndex) {
+        continue;
       }
+      buf.append((*iterator)->text);
     }
   }
   return buf;
 }
 
-std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRewriter::reduceToSingleOperationPerIndex(
+std::vector<TokenStreamRewriter::RewriteOperation*> TokenStreamRewriter::reduceToSingleOperationPerIndex(
   std::vector<TokenStreamRewriter::RewriteOperation*> &rewrites) {
 
+  // The live replaces, keyed by start index. Once a replace has been processed it does not overlap with any other.
+  std::map<size_t, ReplaceOp *> replaces;
+
+  // The live inserts, keyed by token index. Inserts at the same index stay in instruction order.
+  std::multimap<size_t, InsertBeforeOp *> inserts;
+
+  // Returns the live replace whose range contains the given index, if any.
+  auto replaceAt = [&replaces](size_t index) -> ReplaceOp* {
+    auto iterator = replaces.upper_bound(index);
+    if (iterator == replaces.begin()) {
+      return nullptr;
+    }
+    --iterator;
+    return iterator->second->lastIndex >= index ? iterator->second : nullptr;
+  };
 
   // WALK REPLACES
+  std::vector<ReplaceOp *> prevReplaces;
   for (size_t i = 0; i < rewrites.size(); ++i) {
     TokenStreamRewriter::RewriteOperation *op = rewrites[i];
+    if (op == nullptr)
+      continue;
+
     ReplaceOp *rop = dynamic_cast<ReplaceOp *>(op);
-    if (rop == nullptr)
+    if (rop == nullptr) {
+      InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(op);
+      if (iop != nullptr) {
+        inserts.emplace(iop->index, iop);
+      }
       continue;
+    }
 
     // Wipe prior inserts within range
-    std::vector<InsertBeforeOp *> inserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto *iop : inserts) {
-      if (iop->index == rop->index) {
-        // E.g., insert before 2, delete 2..2; update replace
-        // text to include insert before, kill insert
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
-        rop->text = iop->text + (!rop->text.empty() ? rop->text : "");
+    auto first = inserts.lower_bound(rop->index);
+    auto last = inserts.upper_bound(rop->lastIndex);
+    if (first != last && first->first == rop->index) {
+      // E.g., insert before 2, delete 2..2; update replace
+      // text to include insert before (the last insert first), kill insert
+      auto stop = inserts.upper_bound(rop->index);
+      size_t length = rop->text.size();
+      for (auto iterator = first; iterator != stop; ++iterator) {
+        length += iterator->second->text.size();
       }
-      else if (iop->index > rop->index && iop->index <= rop->lastIndex) {
-        // delete insert as it's a no-op.
-        delete rewrites[iop->instructionIndex];
-        rewrites[iop->instructionIndex] = nullptr;
+
+      std::string text;
+      text.reserve(length);
+      for (auto iterator = stop; iterator != first;) {
+        text.append((--iterator)->second->text);
       }
+      text.append(rop->text);
+      rop->text.swap(text);
     }
-    // Drop any prior replaces contained within
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
+    for (auto iterator = first; iterator != last; ++iterator) {
+      // Either merged into the replace above or a no-op.
+      killOperation(rewrites, iterator->second);
+    }
+    inserts.erase(first, last);
+
+    // Drop any prior replaces contained within. Only those which overlap the range need to be looked at.
+    prevReplaces.clear();
+    auto iterator = replaces.upper_bound(rop->index);
+    if (iterator != replaces.begin() && std::prev(iterator)->second->lastIndex >= rop->index) {
+      --iterator;
+    }
+    while (iterator != replaces.end() && iterator->first <= rop->lastIndex) {
+      prevReplaces.push_back((iterator++)->second);
+    }
+    std::sort(prevReplaces.begin(), prevReplaces.end(), [](ReplaceOp *lhs, ReplaceOp *rhs) {
+      return lhs->instructionIndex < rhs->instructionIndex;
+    });
+
     for (auto *prevRop : prevReplaces) {
       if (prevRop->index >= rop->index && prevRop->lastIndex <= rop->lastIndex) {
         // delete replace as it's a no-op.
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr;
+        replaces.erase(prevRop->index);
+        killOperation(rewrites, prevRop);
         continue;
       }
       // throw exception unless disjoint or identical
@@ -351,65 +423,87 @@ std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> TokenStreamRe
       // Delete special case of replace (text==null):
       // D.i-j.u D.x-y.v    | boundaries overlap    combine to max(min)..max(right)
       if (prevRop->text.empty() && rop->text.empty() && !disjoint) {
-        delete rewrites[prevRop->instructionIndex];
-        rewrites[prevRop->instructionIndex] = nullptr; // kill first delete
+        replaces.erase(prevRop->index);
         rop->index = std::min(prevRop->index, rop->index);
         rop->lastIndex = std::max(prevRop->lastIndex, rop->lastIndex);
-        std::cout << "new rop " << rop << std::endl;
+        killOperation(rewrites, prevRop); // kill first delete
       }
       else if (!disjoint) {
         throw IllegalArgumentException("replace op boundaries of " + rop->toString() +
                                        " overlap with previous " + prevRop->toString());
       }
     }
+
+    replaces[rop->index] = rop;
   }
 
   // WALK INSERTS
-  for (size_t i = 0; i < rewrites.size(); i++) {
-    InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(rewrites[i]);
-    if (iop == nullptr)
-      continue;
-
-    // combine current insert with prior if any at same index
-
-    std::vector<InsertBeforeOp *> prevInserts = getKindOfOps<InsertBeforeOp>(rewrites, i);
-    for (auto *prevIop : prevInserts) {
-      if (prevIop->index == iop->index) { // combine objects
-                                          // convert to strings...we're in process of toString'ing
-                                          // whole token buffer so no lazy eval issue with any templates
-        iop->text = catOpText(&iop->text, &prevIop->text);
-        // delete redundant prior insert
-        delete rewrites[prevIop->instructionIndex];
-        rewrites[prevIop->instructionIndex] = nullptr;
+  // Inserts at different indexes don't affect each other, so they are handled per index, in instruction order.
+  for (auto first = inserts.begin(); first != inserts.end();) {
+    size_t index = first->first;
+    auto stop = inserts.upper_bound(index);
+
+    // Combine all inserts at this index (the last one first). If there is a prior replace covering this index,
+    // the inserts following it must be at its start and are combined with it. Otherwise the last insert remains.
+    ReplaceOp *rop = replaceAt(index);
+    RewriteOperation *target = nullptr;
+    if (rop != nullptr) {
+      for (auto iterator = first; iterator != stop; ++iterator) {
+        if (iterator->second->instructionIndex > rop->instructionIndex) {
+          if (index != rop->index) {
+            throw IllegalArgumentException("insert op " + iterator->second->toString() + " within boundaries of previous " +
+                                           rop->toString());
+          }
+          target = rop;
+          break;
+        }
       }
     }
-    // look for replaces where iop.index is in range; error
-    std::vector<ReplaceOp*> prevReplaces = getKindOfOps<ReplaceOp>(rewrites, i);
-    for (auto *rop : prevReplaces) {
-      if (iop->index == rop->index) {
-        rop->text = catOpText(&iop->text, &rop->text);
-        delete rewrites[i];
-        rewrites[i] = nullptr; // delete current insert
-        continue;
-      }
-      if (iop->index >= rop->index && iop->index <= rop->lastIndex) {
-        throw IllegalArgumentException("insert op " + iop->toString() + " within boundaries of previous " + rop->toString());
+
+    size_t length = target == nullptr ? 0 : target->text.size();
+    for (auto iterator = first; iterator != stop; ++iterator) {
+      length += iterator->second->text.size();
+    }
+
+    std::string text;
+    text.reserve(length);
+    for (auto iterator = stop; iterator != first;) {
+      text.append((--iterator)->second->text);
+    }
+
+    if (target == nullptr) {
+      target = std::prev(stop)->second;
+    } else {
+      text.append(target->text);
+    }
+    target->text.swap(text);
+
+    for (auto iterator = first; iterator != stop; ++iterator) {
+      if (iterator->second != target) {
+        killOperation(rewrites, iterator->second);
       }
     }
+    first = stop;
   }
 
-  std::unordered_map<size_t, TokenStreamRewriter::RewriteOperation*> m;
+  std::vector<TokenStreamRewriter::RewriteOperation*> ops;
   for (TokenStreamRewriter::RewriteOperation *op : rewrites) {
     if (op == nullptr) { // ignore deleted ops
       continue;
     }
-    if (m.count(op->index) > 0) {
+    ops.push_back(op);
+  }
+
+  std::sort(ops.begin(), ops.end(), [](RewriteOperation *lhs, RewriteOperation *rhs) {
+    return lhs->index < rhs->index;
+  });
+  for (size_t i = 1; i < ops.size(); ++i) {
+    if (ops[i - 1]->index == ops[i]->index) {
       throw RuntimeException("should only be one op per index");
     }
-    m[op->index] = op;
   }
 
-  return m;
+  return ops;
 }
 
 std::string TokenStreamRewriter::catOpText(std::string *a, std::string *b) {
@@ -423,3 +517,54 @@ std::string TokenStreamRewriter::catOpText(std::string *a, std::string *b) {
   }
   return x + y;
 }
+
+TokenStreamRewriter::InsertBeforeOp* TokenStreamRewriter::createInsertBeforeOp(size_t index, const std::string &text) {
+  if (_freeInsertOps.empty()) {
+    _insertOpPool.emplace_back(this, index, text);
+    return &_insertOpPool.back();
+  }
+
+  InsertBeforeOp *op = _freeInsertOps.back();
+  _freeInsertOps.pop_back();
+  op->index = index;
+  op->text = text;
+  op->instructionIndex = 0;
+  return op;
+}
+
+TokenStreamRewriter::ReplaceOp* TokenStreamRewriter::createReplaceOp(size_t from, size_t to, const std::string &text) {
+  if (_freeReplaceOps.empty()) {
+    _replaceOpPool.emplace_back(this, from, to, text);
+    return &_replaceOpPool.back();
+  }
+
+  ReplaceOp *op = _freeReplaceOps.back();
+  _freeReplaceOps.pop_back();
+  op->index = from;
+  op->lastIndex = to;
+  op->text = text;
+  op->instructionIndex = 0;
+  return op;
+}
+
+void TokenStreamRewriter::releaseOperation(RewriteOperation *op) {
+  if (op == nullptr) {
+    return;
+  }
+
+  ReplaceOp *rop = dynamic_cast<ReplaceOp *>(op);
+  if (rop != nullptr) {
+    _freeReplaceOps.push_back(rop);
+    return;
+  }
+
+  InsertBeforeOp *iop = dynamic_cast<InsertBeforeOp *>(op);
+  if (iop != nullptr) {
+    _freeInsertOps.push_back(iop);
+  }
+}
+
+void TokenStreamRewriter::killOperation(std::vector<RewriteOperation *> &rewrites, RewriteOperation *op) {
+  rewrites[op->instructionIndex] = nullptr;
+  releaseOperation(op);
+}
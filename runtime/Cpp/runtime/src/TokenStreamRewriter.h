@@ -272,29 +272,30 @@ namespace antlr4 {
     ///  add tokens in front of a method body '{' and then delete the method
     ///  body, I think the stuff before the '{' you added should disappear too.
     ///
-    ///  Return a map from token index to operation.
+    ///  Return the remaining operations, sorted by token index.
+    ///
+    ///  The live operations are indexed by token position while walking the program (replaces never overlap
+    ///  once reduced, so they are kept sorted by their start index), which makes this O(n log n) instead of
+    ///  comparing each operation with all prior ones.
     /// </summary>
-    virtual std::unordered_map<size_t, RewriteOperation*> reduceToSingleOperationPerIndex(std::vector<RewriteOperation*> &rewrites);
+    virtual std::vector<RewriteOperation*> reduceToSingleOperationPerIndex(std::vector<RewriteOperation*> &rewrites);
 
     virtual std::string catOpText(std::string *a, std::string *b);
 
-    /// Get all operations before an index of a particular kind.
-    template <typename T>
-    std::vector<T *> getKindOfOps(std::vector<RewriteOperation *> rewrites, size_t before) {
-      std::vector<T *> ops;
-      for (size_t i = 0; i < before && i < rewrites.size(); i++) {
-        T *op = dynamic_cast<T *>(rewrites[i]);
-        if (op == nullptr) { // ignore deleted or non matching entries
-          continue;
-        }
-        ops.push_back(op);
-      }
-      return ops;
-    }
-
   private:
+    // Operations are allocated in blocks and reused once they were dropped from a program.
+    std::deque<InsertBeforeOp> _insertOpPool;
+    std::deque<ReplaceOp> _replaceOpPool;
+    std::vector<InsertBeforeOp *> _freeInsertOps;
+    std::vector<ReplaceOp *> _freeReplaceOps;
+
     std::vector<RewriteOperation *>& initializeProgram(const std::string &name);
 
+    InsertBeforeOp* createInsertBeforeOp(size_t index, const std::string &text);
+    ReplaceOp* createReplaceOp(size_t from, size_t to, const std::string &text);
+    void releaseOperation(RewriteOperation *op);
+    void killOperation(std::vector<RewriteOperation *> &rewrites, RewriteOperation *op);
+
   };
 
 } // namespace antlr4
@@ -34,6 +34,9 @@
 #include <exception>
 #include <bitset>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
 
 #ifndef USE_UTF8_INSTEAD_OF_CODECVT
   #include <codecvt>
@@ -42,6 +45,8 @@
 // Defines for the Guid class and other platform dependent stuff.
 #ifdef _WIN32
   #ifdef _MSC_VER
+    #include <intrin.h> // For the bit scan intrinsics used by antlrcpp::BitSet.
+
     #pragma warning (disable: 4250) // Class inherits by dominance.
     #pragma warning (disable: 4512) // assignment operator could not be generated
 
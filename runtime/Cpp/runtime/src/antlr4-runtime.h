@@ -20,6 +20,7 @@
 #include "CommonToken.h"
 #include "CommonTokenFactory.h"
 #include "CommonTokenStream.h"
+#include "ConcurrentTokenStream.h"
 #include "ConsoleErrorListener.h"
 #include "DefaultErrorStrategy.h"
 #include "DiagnosticErrorListener.h"
@@ -33,6 +34,7 @@
 #include "LexerNoViableAltException.h"
 #include "ListTokenSource.h"
 #include "NoViableAltException.h"
+#include "ParallelTokenSource.h"
 #include "Parser.h"
 #include "ParserInterpreter.h"
 #include "ParserRuleContext.h"
@@ -85,12 +87,14 @@
 #include "atn/LexerActionType.h"
 #include "atn/LexerChannelAction.h"
 #include "atn/LexerCustomAction.h"
+#include "atn/LexerDFATable.h"
 #include "atn/LexerIndexedCustomAction.h"
 #include "atn/LexerModeAction.h"
 #include "atn/LexerMoreAction.h"
 #include "atn/LexerPopModeAction.h"
 #include "atn/LexerPushModeAction.h"
 #include "atn/LexerSkipAction.h"
+#include "atn/LexerTransitionTable.h"
 #include "atn/LexerTypeAction.h"
 #include "atn/LookaheadEventInfo.h"
 #include "atn/LoopEndState.h"
@@ -98,6 +102,7 @@
 #include "atn/OrderedATNConfigSet.h"
 #include "atn/ParseInfo.h"
 #include "atn/ParserATNSimulator.h"
+#include "atn/ParserATNSimulatorPredict.h"
 #include "atn/PlusBlockStartState.h"
 #include "atn/PlusLoopbackState.h"
 #include "atn/PrecedencePredicateTransition.h"
@@ -121,8 +126,10 @@
 #include "atn/WildcardTransition.h"
 #include "dfa/DFA.h"
 #include "dfa/DFASerializer.h"
+#include "dfa/DFASnapshot.h"
 #include "dfa/DFAState.h"
 #include "dfa/LexerDFASerializer.h"
+#include "misc/FastHash.h"
 #include "misc/InterpreterDataReader.h"
 #include "misc/Interval.h"
 #include "misc/IntervalSet.h"
@@ -137,6 +144,7 @@
 #include "tree/AbstractParseTreeVisitor.h"
 #include "tree/ErrorNode.h"
 #include "tree/ErrorNodeImpl.h"
+#include "tree/FlatParseTree.h"
 #include "tree/ParseTree.h"
 #include "tree/ParseTreeListener.h"
 #include "tree/ParseTreeProperty.h"
@@ -146,15 +154,18 @@
 #include "tree/TerminalNodeImpl.h"
 #include "tree/Trees.h"
 #include "tree/pattern/Chunk.h"
+#include "tree/pattern/CompiledParseTreePattern.h"
 #include "tree/pattern/ParseTreeMatch.h"
 #include "tree/pattern/ParseTreePattern.h"
 #include "tree/pattern/ParseTreePatternMatcher.h"
+#include "tree/pattern/ParseTreePatternSet.h"
 #include "tree/pattern/RuleTagToken.h"
 #include "tree/pattern/TagChunk.h"
 #include "tree/pattern/TextChunk.h"
 #include "tree/pattern/TokenTagToken.h"
 #include "tree/xpath/XPath.h"
 #include "tree/xpath/XPathElement.h"
+#include "tree/xpath/XPathIndex.h"
 #include "tree/xpath/XPathLexer.h"
 #include "tree/xpath/XPathLexerErrorListener.h"
 #include "tree/xpath/XPathRuleAnywhereElement.h"
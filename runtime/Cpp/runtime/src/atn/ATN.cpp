@@ -11,6 +11,9 @@
 #include "atn/DecisionState.h"
 #include "Recognizer.h"
 #include "atn/ATNType.h"
+#include "atn/ATNDeserializationOptions.h"
+#include "atn/ATNDeserializer.h"
+#include "atn/ATNSerializer.h"
 #include "Exceptions.h"
 #include "support/CPPUtils.h"
 
@@ -23,7 +26,7 @@ using namespace antlrcpp;
 ATN::ATN() : ATN(ATNType::LEXER, 0) {
 }
 
-ATN::ATN(ATN &&other) {
+ATN::ATN(ATN &&other) : _bypassAltsATN(other._bypassAltsATN.exchange(nullptr)) {
   // All source vectors are implicitly cleared by the moves.
   states = std::move(other.states);
   decisionToState = std::move(other.decisionToState);
@@ -34,15 +37,18 @@ ATN::ATN(ATN &&other) {
   ruleToTokenType = std::move(other.ruleToTokenType);
   lexerActions = std::move(other.lexerActions);
   modeToStartState = std::move(other.modeToStartState);
+  lexerTransitionTable = std::move(other.lexerTransitionTable);
 }
 
-ATN::ATN(ATNType grammarType_, size_t maxTokenType_) : grammarType(grammarType_), maxTokenType(maxTokenType_) {
+ATN::ATN(ATNType grammarType_, size_t maxTokenType_)
+  : grammarType(grammarType_), maxTokenType(maxTokenType_), _bypassAltsATN(nullptr) {
 }
 
 ATN::~ATN() {
   for (ATNState *state : states) {
     delete state;
   }
+  delete _bypassAltsATN.load();
 }
 
 /**
@@ -58,6 +64,8 @@ ATN& ATN::operator = (ATN &other) NOEXCEPT {
   ruleToTokenType = other.ruleToTokenType;
   lexerActions = other.lexerActions;
   modeToStartState = other.modeToStartState;
+  lexerTransitionTable = other.lexerTransitionTable;
+  delete _bypassAltsATN.exchange(nullptr);
 
   return *this;
 }
@@ -77,6 +85,8 @@ ATN& ATN::operator = (ATN &&other) NOEXCEPT {
   ruleToTokenType = std::move(other.ruleToTokenType);
   lexerActions = std::move(other.lexerActions);
   modeToStartState = std::move(other.modeToStartState);
+  lexerTransitionTable = std::move(other.lexerTransitionTable);
+  delete _bypassAltsATN.exchange(other._bypassAltsATN.exchange(nullptr));
 
   return *this;
 }
@@ -92,6 +102,7 @@ misc::IntervalSet const& ATN::nextTokens(ATNState *s) const {
     std::unique_lock<std::mutex> lock { _mutex };
     if (!s->_nextTokenUpdated) {
       s->_nextTokenWithinRule = nextTokens(s, nullptr);
+      s->_nextTokenWithinRule.createBitmap();
       s->_nextTokenUpdated = true;
     }
   }
@@ -136,19 +147,20 @@ misc::IntervalSet ATN::getExpectedTokens(size_t stateNumber, RuleContext *contex
 
   RuleContext *ctx = context;
   ATNState *s = states.at(stateNumber);
-  misc::IntervalSet following = nextTokens(s);
-  if (!following.contains(Token::EPSILON)) {
-    return following;
+  // The sets are cached in the states, so there is no need to copy them.
+  const misc::IntervalSet *following = &nextTokens(s);
+  if (!following->contains(Token::EPSILON)) {
+    return *following;
   }
 
   misc::IntervalSet expected;
-  expected.addAll(following);
+  expected.addAll(*following);
   expected.remove(Token::EPSILON);
-  while (ctx && ctx->invokingState != ATNState::INVALID_STATE_NUMBER && following.contains(Token::EPSILON)) {
+  while (ctx && ctx->invokingState != ATNState::INVALID_STATE_NUMBER && following->contains(Token::EPSILON)) {
     ATNState *invokingState = states.at(ctx->invokingState);
     RuleTransition *rt = static_cast<RuleTransition*>(invokingState->transitions[0]);
-    following = nextTokens(rt->followState);
-    expected.addAll(following);
+    following = &nextTokens(rt->followState);
+    expected.addAll(*following);
     expected.remove(Token::EPSILON);
 
     if (ctx->parent == nullptr) {
@@ -157,13 +169,42 @@ misc::IntervalSet ATN::getExpectedTokens(size_t stateNumber, RuleContext *contex
     ctx = static_cast<RuleContext *>(ctx->parent);
   }
 
-  if (following.contains(Token::EPSILON)) {
+  if (following->contains(Token::EPSILON)) {
     expected.add(Token::EOF);
   }
 
   return expected;
 }
 
+const ATN& ATN::getATNWithBypassAlts() const {
+  ATN *result = _bypassAltsATN.load();
+  if (result != nullptr) {
+    return *result;
+  }
+
+  if (grammarType != ATNType::PARSER) {
+    throw UnsupportedOperationException("Bypass alternatives can only be created for parser ATNs.");
+  }
+
+  // The bypass alternatives are added by the deserializer, so take a round trip through the serialized form.
+  std::vector<size_t> serialized = ATNSerializer(const_cast<ATN *>(this)).serialize();
+  std::vector<uint16_t> data;
+  data.reserve(serialized.size());
+  for (size_t value : serialized) {
+    data.push_back(static_cast<uint16_t>(value));
+  }
+
+  ATNDeserializationOptions deserializationOptions;
+  deserializationOptions.setGenerateRuleBypassTransitions(true);
+  ATNDeserializer deserializer(deserializationOptions);
+  std::unique_ptr<ATN> created(new ATN(deserializer.deserialize(data)));
+
+  if (_bypassAltsATN.compare_exchange_strong(result, created.get())) {
+    return *created.release();
+  }
+  return *result; // Created by another thread in the meantime.
+}
+
 std::string ATN::toString() const {
   std::stringstream ss;
   std::string type;
@@ -60,6 +60,10 @@ namespace atn {
 
     std::vector<TokensStartState *> modeToStartState;
 
+    /// For lexer ATNs created by the ATNDeserializer, the matching transitions in table form, which the
+    /// LexerATNSimulator uses instead of Transition::matches(). Must be reset if the transitions are changed.
+    Ref<LexerTransitionTable> lexerTransitionTable;
+
     ATN& operator = (ATN &other) NOEXCEPT;
     ATN& operator = (ATN &&other) NOEXCEPT;
 
@@ -108,10 +112,19 @@ namespace atn {
     /// number {@code stateNumber} </exception>
     virtual misc::IntervalSet getExpectedTokens(size_t stateNumber, RuleContext *context) const;
 
+    /// Returns a copy of this parser ATN with bypass alternatives for all rules (see
+    /// ATNDeserializationOptions::isGenerateRuleBypassTransitions()), as needed for tree pattern matching.
+    /// It is created on first use and then shared by all users of this ATN, without locking.
+    /// Throws an UnsupportedOperationException if this is not a parser ATN.
+    const ATN& getATNWithBypassAlts() const;
+
     std::string toString() const;
 
   private:
     mutable std::mutex _mutex;
+
+    // Owned by this ATN. Set once by getATNWithBypassAlts(), the first thread to finish creating it wins.
+    mutable std::atomic<ATN *> _bypassAltsATN;
   };
 
 } // namespace atn
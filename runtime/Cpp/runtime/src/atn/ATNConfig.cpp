@@ -3,7 +3,7 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 #include "atn/PredictionContext.h"
 #include "SemanticContext.h"
 
@@ -48,12 +48,11 @@ ATNConfig::~ATNConfig() {
 }
 
 size_t ATNConfig::hashCode() const {
-  size_t hashCode = misc::MurmurHash::initialize(7);
-  hashCode = misc::MurmurHash::update(hashCode, state->stateNumber);
-  hashCode = misc::MurmurHash::update(hashCode, alt);
-  hashCode = misc::MurmurHash::update(hashCode, context);
-  hashCode = misc::MurmurHash::update(hashCode, semanticContext);
-  hashCode = misc::MurmurHash::finish(hashCode, 4);
+  size_t hashCode = misc::HashPolicy::initialize(7);
+  hashCode = misc::HashPolicy::update(hashCode, state->stateNumber, alt);
+  hashCode = misc::HashPolicy::update(hashCode, context != nullptr ? context->hashCode() : 0,
+    semanticContext != nullptr ? semanticContext->hashCode() : 0);
+  hashCode = misc::HashPolicy::finish(hashCode, 4);
   return hashCode;
 }
 
@@ -5,10 +5,12 @@
 
 #include "atn/PredictionContext.h"
 #include "atn/ATNConfig.h"
+#include "atn/LexerATNConfig.h"
 #include "atn/ATNSimulator.h"
 #include "Exceptions.h"
 #include "atn/SemanticContext.h"
 #include "support/Arrays.h"
+#include "misc/FastHash.h"
 
 #include "atn/ATNConfigSet.h"
 
@@ -45,34 +47,73 @@ bool ATNConfigSet::add(const Ref<ATNConfig> &config, PredictionContextMergeCache
     dipsIntoOuterContext = true;
   }
 
-  size_t hash = getHash(config.get());
-  ATNConfig *existing = _configLookup[hash];
-  if (existing == nullptr) {
-    _configLookup[hash] = config.get();
-    _cachedHashCode = 0;
-    configs.push_back(config); // track order here
-
-    return true;
+  if ((configs.size() + 1) * 2 > _configLookup.size()) {
+    growLookup(configs.size() + 1);
   }
 
-  // a previous (s,i,pi,_), merge with it and save result
-  bool rootIsWildcard = !fullCtx;
-  Ref<PredictionContext> merged = PredictionContext::merge(existing->context, config->context, rootIsWildcard, mergeCache);
-  // no need to check for existing.context, config.context in cache
-  // since only way to create new graphs is "call rule" and here. We
-  // cache at both places.
-  existing->reachesIntoOuterContext = std::max(existing->reachesIntoOuterContext, config->reachesIntoOuterContext);
-
-  // make sure to preserve the precedence filter suppression during the merge
-  if (config->isPrecedenceFilterSuppressed()) {
-    existing->setPrecedenceFilterSuppressed(true);
+  uint32_t hash = static_cast<uint32_t>(getHash(config.get()));
+  size_t slot = getSlot(hash);
+  size_t mask = _configLookup.size() - 1;
+  while (_configLookup[slot].index != 0) {
+    if (_configLookup[slot].hash == hash) {
+      Ref<ATNConfig> &existingRef = configs[_configLookup[slot].index - 1];
+      ATNConfig *existing = existingRef.get();
+      if (isSameKey(existing, config.get())) {
+        // a previous (s,i,pi,_), merge with it and save result
+        bool rootIsWildcard = !fullCtx;
+        Ref<PredictionContext> merged = PredictionContext::merge(existing->context, config->context, rootIsWildcard, mergeCache);
+        // no need to check for existing.context, config.context in cache
+        // since only way to create new graphs is "call rule" and here. We
+        // cache at both places.
+        bool changed = merged != existing->context ||
+          config->reachesIntoOuterContext > existing->reachesIntoOuterContext ||
+          (config->isPrecedenceFilterSuppressed() && !existing->isPrecedenceFilterSuppressed());
+        if (!changed) {
+          return true;
+        }
+
+        if (existingRef.use_count() > 1) {
+          // The config is also held by another set (e.g. the one it was added from), whose cached hash
+          // must not go stale. Merge into a private copy instead.
+          existingRef = copyConfig(existingRef);
+          existing = existingRef.get();
+        }
+
+        existing->reachesIntoOuterContext = std::max(existing->reachesIntoOuterContext, config->reachesIntoOuterContext);
+
+        // make sure to preserve the precedence filter suppression during the merge
+        if (config->isPrecedenceFilterSuppressed()) {
+          existing->setPrecedenceFilterSuppressed(true);
+        }
+
+        if (merged != existing->context) {
+          _cachedHashCode -= getConfigHash(hash, existing);
+          existing->context = merged; // replace context; no need to alt mapping
+          _cachedHashCode += getConfigHash(hash, existing);
+        }
+
+        return true;
+      }
+    }
+    slot = (slot + 1) & mask;
   }
 
-  existing->context = merged; // replace context; no need to alt mapping
+  configs.push_back(config); // track order here
+  _configLookup[slot].hash = hash;
+  _configLookup[slot].index = static_cast<uint32_t>(configs.size());
+  _cachedHashCode += getConfigHash(hash, config.get());
+  _alts.set(config->alt);
 
   return true;
 }
 
+Ref<ATNConfig> ATNConfigSet::copyConfig(const Ref<ATNConfig> &config) {
+  if (Ref<LexerATNConfig> lexerConfig = std::dynamic_pointer_cast<LexerATNConfig>(config)) {
+    return std::make_shared<LexerATNConfig>(lexerConfig, lexerConfig->state);
+  }
+  return std::make_shared<ATNConfig>(config);
+}
+
 bool ATNConfigSet::addAll(const Ref<ATNConfigSet> &other) {
   for (auto &c : other->configs) {
     add(c);
@@ -98,11 +139,7 @@ std::vector<ATNState*> ATNConfigSet::getStates() {
  */
 
 BitSet ATNConfigSet::getAlts() {
-  BitSet alts;
-  for (ATNConfig config : configs) {
-    alts.set(config.alt);
-  }
-  return alts;
+  return _alts;
 }
 
 std::vector<Ref<SemanticContext>> ATNConfigSet::getPredicates() {
@@ -123,7 +160,7 @@ void ATNConfigSet::optimizeConfigs(ATNSimulator *interpreter) {
   if (_readonly) {
     throw IllegalStateException("This set is readonly");
   }
-  if (_configLookup.empty())
+  if (configs.empty())
     return;
 
   for (auto &config : configs) {
@@ -136,7 +173,7 @@ bool ATNConfigSet::operator == (const ATNConfigSet &other) {
     return true;
   }
 
-  if (configs.size() != other.configs.size())
+  if (configs.size() != other.configs.size() || _cachedHashCode != other._cachedHashCode)
     return false;
 
   if (fullCtx != other.fullCtx || uniqueAlt != other.uniqueAlt ||
@@ -148,13 +185,6 @@ bool ATNConfigSet::operator == (const ATNConfigSet &other) {
 }
 
 size_t ATNConfigSet::hashCode() {
-  if (!isReadonly() || _cachedHashCode == 0) {
-    _cachedHashCode = 1;
-    for (auto &i : configs) {
-      _cachedHashCode = 31 * _cachedHashCode + i->hashCode(); // Same as Java's list hashCode impl.
-    }
-  }
-
   return _cachedHashCode;
 }
 
@@ -172,7 +202,10 @@ void ATNConfigSet::clear() {
   }
   configs.clear();
   _cachedHashCode = 0;
-  _configLookup.clear();
+  _alts.reset();
+
+  // Keep the lookup table for the next round.
+  std::fill(_configLookup.begin(), _configLookup.end(), LookupSlot { 0, 0 });
 }
 
 bool ATNConfigSet::isReadonly() {
@@ -181,7 +214,13 @@ bool ATNConfigSet::isReadonly() {
 
 void ATNConfigSet::setReadonly(bool readonly) {
   _readonly = readonly;
-  _configLookup.clear();
+
+  // A readonly set is usually part of a DFA state and kept for the lifetime of the DFA, so release
+  // everything not needed anymore (clear() would keep the lookup table).
+  std::vector<LookupSlot>().swap(_configLookup);
+  if (readonly) {
+    configs.shrink_to_fit();
+  }
 }
 
 std::string ATNConfigSet::toString() {
@@ -214,15 +253,78 @@ size_t ATNConfigSet::getHash(ATNConfig *c) {
   size_t hashCode = 7;
   hashCode = 31 * hashCode + c->state->stateNumber;
   hashCode = 31 * hashCode + c->alt;
-  hashCode = 31 * hashCode + c->semanticContext->hashCode();
+  if (c->semanticContext != SemanticContext::NONE) { // Saves computing the hash for the by far most common case.
+    hashCode = 31 * hashCode + c->semanticContext->hashCode();
+  }
   return hashCode;
 }
 
+bool ATNConfigSet::isSameKey(ATNConfig *lhs, ATNConfig *rhs) {
+  return lhs->state->stateNumber == rhs->state->stateNumber && lhs->alt == rhs->alt &&
+    (lhs->semanticContext == rhs->semanticContext || *lhs->semanticContext == *rhs->semanticContext);
+}
+
+void ATNConfigSet::reserve(size_t count) {
+  configs.reserve(count);
+  if (count * 2 > _configLookup.size()) {
+    growLookup(count);
+  }
+}
+
+size_t ATNConfigSet::getSlot(uint32_t hash) const {
+  // Fibonacci hashing, to spread the (not well distributed) lookup hashes over the table.
+  return static_cast<size_t>(static_cast<uint32_t>(hash * 2654435769U) >> _lookupShift);
+}
+
+void ATNConfigSet::growLookup(size_t capacity) {
+  size_t size = 16;
+  size_t shift = 28;
+  while (size < capacity * 2) {
+    size *= 2;
+    --shift;
+  }
+
+  std::vector<LookupSlot> oldLookup(size, LookupSlot { 0, 0 });
+  oldLookup.swap(_configLookup);
+  _lookupShift = shift;
+
+  size_t mask = size - 1;
+  auto insert = [this, mask](uint32_t hash, uint32_t index) {
+    size_t slot = getSlot(hash);
+    while (_configLookup[slot].index != 0) {
+      slot = (slot + 1) & mask;
+    }
+    _configLookup[slot].hash = hash;
+    _configLookup[slot].index = index;
+  };
+
+  if (oldLookup.empty()) {
+    // Either a new set or the lookup has been wiped out (by setReadonly()).
+    for (size_t i = 0; i < configs.size(); ++i) {
+      insert(static_cast<uint32_t>(getHash(configs[i].get())), static_cast<uint32_t>(i + 1));
+    }
+  } else {
+    for (auto &entry : oldLookup) {
+      if (entry.index != 0) {
+        insert(entry.hash, entry.index);
+      }
+    }
+  }
+}
+
+size_t ATNConfigSet::getConfigHash(uint32_t keyHash, ATNConfig *config) {
+  // The set hash is the sum of these, which can be updated when a config changes.
+  size_t hash = misc::HashPolicy::initialize();
+  hash = misc::HashPolicy::update(hash, static_cast<size_t>(keyHash), config->context->hashCode());
+  return misc::HashPolicy::finish(hash, 2);
+}
+
 void ATNConfigSet::InitializeInstanceFields() {
   uniqueAlt = 0;
   hasSemanticContext = false;
   dipsIntoOuterContext = false;
 
   _readonly = false;
+  _lookupShift = 28;
   _cachedHashCode = 0;
 }
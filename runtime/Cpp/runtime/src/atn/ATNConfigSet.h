@@ -77,6 +77,9 @@ namespace atn {
 
     bool addAll(const Ref<ATNConfigSet> &other);
 
+    /// Prepares the set for the given number of configs, so that add() doesn't need to grow the lookup.
+    void reserve(size_t count);
+
     bool operator == (const ATNConfigSet &other);
     virtual size_t hashCode();
     virtual size_t size();
@@ -96,12 +99,30 @@ namespace atn {
 
     virtual size_t getHash(ATNConfig *c); // Hash differs depending on set type.
 
+    /// Determines if two configs are the same for the lookup in add(). Must match getHash().
+    virtual bool isSameKey(ATNConfig *lhs, ATNConfig *rhs);
+
   private:
+    struct LookupSlot {
+      uint32_t hash;  // The lower bits of getHash().
+      uint32_t index; // Index + 1 of the config in configs, 0 for an empty slot.
+    };
+
+    /// All configs but hashed by (s, i, _, pi) not including context, as open addressing hash table
+    /// (linear probing, at most half full). Wiped out when we go readonly as this set becomes a DFA state.
+    std::vector<LookupSlot> _configLookup;
+    size_t _lookupShift;
+
+    /// The hash of the set and the represented alternatives, kept up to date by add().
     size_t _cachedHashCode;
+    antlrcpp::BitSet _alts;
+
+    size_t getSlot(uint32_t hash) const;
+    void growLookup(size_t capacity);
+    static size_t getConfigHash(uint32_t keyHash, ATNConfig *config);
 
-    /// All configs but hashed by (s, i, _, pi) not including context. Wiped out
-    /// when we go readonly as this set becomes a DFA state.
-    std::unordered_map<size_t, ATNConfig *> _configLookup;
+    /// Copies a config (keeping its dynamic type) before add() merges into it while it is shared.
+    static Ref<ATNConfig> copyConfig(const Ref<ATNConfig> &config);
 
     void InitializeInstanceFields();
   };
@@ -48,6 +48,7 @@
 #include "atn/LexerPushModeAction.h"
 #include "atn/LexerSkipAction.h"
 #include "atn/LexerTypeAction.h"
+#include "atn/LexerTransitionTable.h"
 
 #include "atn/ATNDeserializer.h"
 
@@ -527,6 +528,10 @@ ATN ATNDeserializer::deserialize(const std::vector<uint16_t>& input) {
     }
   }
 
+  if (atn.grammarType == ATNType::LEXER) {
+    atn.lexerTransitionTable = std::make_shared<LexerTransitionTable>(atn);
+  }
+
   return atn;
 }
 
@@ -154,32 +154,26 @@ std::vector<size_t> ATNSerializer::serialize() {
     }
   }
 
-  size_t nsets = sets.size();
-  data.push_back(nsets);
-  for (auto set : sets) {
-    bool containsEof = set.contains(Token::EOF);
-    if (containsEof && set.getIntervals().at(0).b == -1) {
-      data.push_back(set.getIntervals().size() - 1);
-    }
-    else {
-      data.push_back(set.getIntervals().size());
+  // Sets with code points beyond U+FFFF follow the others and use 32 bit values, as expected by the
+  // deserializer for the ADDED_UNICODE_SMP feature (which is part of SERIALIZED_UUID).
+  std::vector<misc::IntervalSet> bmpSets;
+  std::vector<misc::IntervalSet> smpSets;
+  for (auto &set : sets) {
+    if (set.getMaxElement() <= 0xFFFF) {
+      bmpSets.push_back(set);
+    } else {
+      smpSets.push_back(set);
     }
+  }
+  serializeSets(data, bmpSets, false);
+  serializeSets(data, smpSets, true);
 
-    data.push_back(containsEof ? 1 : 0);
-    for (const auto &interval : set.getIntervals()) {
-      if (interval.a == -1) {
-        if (interval.b == -1) {
-          continue;
-        } else {
-          data.push_back(0);
-        }
-      }
-      else {
-        data.push_back(interval.a);
-      }
-
-      data.push_back(interval.b);
-    }
+  setIndices.clear();
+  for (auto &set : bmpSets) {
+    setIndices.insert({ set, (int)setIndices.size() });
+  }
+  for (auto &set : smpSets) {
+    setIndices.insert({ set, (int)setIndices.size() });
   }
 
   data.push_back(nedges);
@@ -602,6 +596,44 @@ std::string ATNSerializer::getDecoded(ATN *atn, std::vector<std::string> &tokenN
   return ATNSerializer(atn, tokenNames).decode(serialized);
 }
 
+void ATNSerializer::serializeSets(std::vector<size_t> &data, const std::vector<misc::IntervalSet> &sets, bool use32Bit) {
+  auto serializeCodePoint = [&data, use32Bit](size_t value) {
+    if (use32Bit) {
+      data.push_back(value & 0xFFFF);
+      data.push_back(value >> 16);
+    } else {
+      data.push_back(value);
+    }
+  };
+
+  data.push_back(sets.size());
+  for (auto &set : sets) {
+    bool containsEof = set.contains(Token::EOF);
+    if (containsEof && set.getIntervals().at(0).b == -1) {
+      data.push_back(set.getIntervals().size() - 1);
+    }
+    else {
+      data.push_back(set.getIntervals().size());
+    }
+
+    data.push_back(containsEof ? 1 : 0);
+    for (const auto &interval : set.getIntervals()) {
+      if (interval.a == -1) {
+        if (interval.b == -1) {
+          continue;
+        } else {
+          serializeCodePoint(0);
+        }
+      }
+      else {
+        serializeCodePoint(interval.a);
+      }
+
+      serializeCodePoint(interval.b);
+    }
+  }
+}
+
 void ATNSerializer::serializeUUID(std::vector<size_t> &data, Guid uuid) {
   unsigned int twoBytes = 0;
   bool firstByte = true;
@@ -55,6 +55,7 @@ namespace atn {
     std::vector<std::string> _tokenNames;
 
     void serializeUUID(std::vector<size_t> &data, Guid uuid);
+    void serializeSets(std::vector<size_t> &data, const std::vector<misc::IntervalSet> &sets, bool use32Bit);
   };
 
 } // namespace atn
@@ -101,7 +101,7 @@ void LL1Analyzer::_LOOK(ATNState *s, ATNState *stopState, Ref<PredictionContext>
 
     if (ctx != PredictionContext::EMPTY) {
       bool removed = calledRuleStack.test(s->ruleIndex);
-      calledRuleStack[s->ruleIndex] = false;
+      calledRuleStack.reset(s->ruleIndex);
        auto onExit = finally([removed, &calledRuleStack, s] {
                 if (removed) {
                   calledRuleStack.set(s->ruleIndex);
@@ -127,7 +127,7 @@ void LL1Analyzer::_LOOK(ATNState *s, ATNState *stopState, Ref<PredictionContext>
 
       Ref<PredictionContext> newContext = SingletonPredictionContext::create(ctx, (static_cast<RuleTransition*>(t))->followState->stateNumber);
       auto onExit = finally([t, &calledRuleStack] {
-        calledRuleStack[(static_cast<RuleTransition*>(t))->target->ruleIndex] = false;
+        calledRuleStack.reset((static_cast<RuleTransition*>(t))->target->ruleIndex);
       });
 
       calledRuleStack.set((static_cast<RuleTransition*>(t))->target->ruleIndex);
@@ -142,12 +142,14 @@ void LL1Analyzer::_LOOK(ATNState *s, ATNState *stopState, Ref<PredictionContext>
     } else if (t->isEpsilon()) {
       _LOOK(t->target, stopState, ctx, look, lookBusy, calledRuleStack, seeThruPreds, addEOF);
     } else if (t->getSerializationType() == Transition::WILDCARD) {
-      look.addAll(misc::IntervalSet::of(Token::MIN_USER_TOKEN_TYPE, static_cast<ssize_t>(_atn.maxTokenType)));
+      look.add(Token::MIN_USER_TOKEN_TYPE, static_cast<ssize_t>(_atn.maxTokenType));
     } else {
       misc::IntervalSet set = t->label();
       if (!set.isEmpty()) {
         if (is<NotSetTransition*>(t)) {
-          set = set.complement(misc::IntervalSet::of(Token::MIN_USER_TOKEN_TYPE, static_cast<ssize_t>(_atn.maxTokenType)));
+          misc::IntervalSet vocabulary = misc::IntervalSet::of(Token::MIN_USER_TOKEN_TYPE, static_cast<ssize_t>(_atn.maxTokenType));
+          vocabulary.removeAll(set);
+          set = std::move(vocabulary);
         }
         look.addAll(set);
       }
@@ -20,6 +20,8 @@
 #include "dfa/DFAState.h"
 #include "atn/LexerATNConfig.h"
 #include "atn/LexerActionExecutor.h"
+#include "atn/LexerTransitionTable.h"
+#include "atn/LexerDFATable.h"
 #include "atn/EmptyPredictionContext.h"
 
 #include "atn/LexerATNSimulator.h"
@@ -79,6 +81,10 @@ size_t LexerATNSimulator::match(CharStream *input, size_t mode) {
 
   _startIndex = input->index();
   _prevAccept.reset();
+  if (_dfaTable != nullptr) {
+    return execDFATable(input);
+  }
+
   const dfa::DFA &dfa = _decisionToDFA[mode];
   if (dfa.s0 == nullptr) {
     return matchATN(input);
@@ -103,6 +109,14 @@ void LexerATNSimulator::clearDFA() {
   }
 }
 
+void LexerATNSimulator::setDFATable(const LexerDFATable *table) {
+  _dfaTable = table;
+}
+
+const LexerDFATable* LexerATNSimulator::getDFATable() const {
+  return _dfaTable;
+}
+
 size_t LexerATNSimulator::matchATN(CharStream *input) {
   ATNState *startState = atn.modeToStartState[_mode];
 
@@ -180,21 +194,50 @@ size_t LexerATNSimulator::execATN(CharStream *input, dfa::DFAState *ds0) {
   return failOrAccept(input, s->configs.get(), t);
 }
 
+size_t LexerATNSimulator::execDFATable(CharStream *input) {
+  // Same steps as in execATN(), but all targets are known already.
+  size_t s = _dfaTable->getStartState(_mode);
+  dfa::DFAState *state = _dfaTable->getDFAState(s);
+  if (state->isAcceptState) {
+    captureSimState(input, state);
+  }
+
+  size_t t = input->LA(1);
+  while (true) {
+    size_t target = _dfaTable->getTarget(s, t);
+    if (target == LexerDFATable::ERROR_STATE) {
+      break;
+    }
+
+    if (t != Token::EOF) {
+      consume(input);
+    }
+
+    s = target;
+    state = _dfaTable->getDFAState(s);
+    if (state->isAcceptState) {
+      captureSimState(input, state);
+      if (t == Token::EOF) {
+        break;
+      }
+    }
+
+    t = input->LA(1);
+  }
+
+  return failOrAccept(input, state->configs.get(), t);
+}
+
 dfa::DFAState *LexerATNSimulator::getExistingTargetState(dfa::DFAState *s, size_t t) {
   dfa::DFAState* retval = nullptr;
-  _edgeLock.readLock();
   if (t <= MAX_DFA_EDGE) {
-    auto iterator = s->edges.find(t - MIN_DFA_EDGE);
+    retval = s->getEdge(t - MIN_DFA_EDGE);
 #if DEBUG_ATN == 1
-    if (iterator != s->edges.end()) {
-      std::cout << std::string("reuse state ") << s->stateNumber << std::string(" edge to ") << iterator->second->stateNumber << std::endl;
+    if (retval != nullptr) {
+      std::cout << std::string("reuse state ") << s->stateNumber << std::string(" edge to ") << retval->stateNumber << std::endl;
     }
 #endif
-
-    if (iterator != s->edges.end())
-      retval = iterator->second;
   }
-  _edgeLock.readUnlock();
   return retval;
 }
 
@@ -241,6 +284,10 @@ void LexerATNSimulator::getReachableConfigSet(CharStream *input, ATNConfigSet *c
   // than a config that already reached an accept state for the same rule
   size_t skipAlt = ATN::INVALID_ALT_NUMBER;
 
+  // With a transition table the character is classified once and each transition is a single bit test.
+  const LexerTransitionTable *table = atn.lexerTransitionTable.get();
+  size_t charClass = table != nullptr ? table->getCharClass(t) : LexerTransitionTable::INVALID_CLASS;
+
   for (auto c : closure_->configs) {
     bool currentAltReachedAcceptState = c->alt == skipAlt;
     if (currentAltReachedAcceptState && (std::static_pointer_cast<LexerATNConfig>(c))->hasPassedThroughNonGreedyDecision()) {
@@ -251,10 +298,19 @@ void LexerATNSimulator::getReachableConfigSet(CharStream *input, ATNConfigSet *c
       std::cout << "testing " << getTokenName((int)t) << " at " << c->toString(true) << std::endl;
 #endif
 
+    if (charClass != LexerTransitionTable::INVALID_CLASS && !table->hasMatchingTransitions(c->state)) {
+      continue;
+    }
+
     size_t n = c->state->transitions.size();
     for (size_t ti = 0; ti < n; ti++) { // for each transition
       Transition *trans = c->state->transitions[ti];
-      ATNState *target = getReachableTarget(trans, (int)t);
+      ATNState *target;
+      if (charClass != LexerTransitionTable::INVALID_CLASS) {
+        target = table->matches(c->state, ti, charClass) ? trans->target : nullptr;
+      } else {
+        target = getReachableTarget(trans, (int)t);
+      }
       if (target != nullptr) {
         Ref<LexerActionExecutor> lexerActionExecutor = std::static_pointer_cast<LexerATNConfig>(c)->getLexerActionExecutor();
         if (lexerActionExecutor != nullptr) {
@@ -531,7 +587,7 @@ void LexerATNSimulator::addDFAEdge(dfa::DFAState *p, size_t t, dfa::DFAState *q)
   }
 
   _edgeLock.writeLock();
-  p->edges[t - MIN_DFA_EDGE] = q; // connect
+  p->setEdge(t - MIN_DFA_EDGE, q); // connect
   _edgeLock.writeUnlock();
 }
 
@@ -625,4 +681,5 @@ void LexerATNSimulator::InitializeInstanceFields() {
   _line = 1;
   _charPositionInLine = 0;
   _mode = antlr4::Lexer::DEFAULT_MODE;
+  _dfaTable = nullptr;
 }
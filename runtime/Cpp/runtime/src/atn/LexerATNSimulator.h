@@ -88,6 +88,9 @@ namespace atn {
     /// Used during DFA/ATN exec to record the most recent accept configuration info.
     SimState _prevAccept;
 
+    /// The precompiled DFAs used instead of _decisionToDFA, if set.
+    const LexerDFATable *_dfaTable;
+
   public:
     static int match_calls;
 
@@ -101,8 +104,17 @@ namespace atn {
 
     virtual void clearDFA() override;
 
+    /// Makes match() use the given precompiled DFAs (see LexerDFATable) instead of the lazily built ones, or
+    /// switches back to the latter for nullptr. The table must have been built from the ATN of this simulator
+    /// and must outlive it.
+    virtual void setDFATable(const LexerDFATable *table);
+    const LexerDFATable* getDFATable() const;
+
   protected:
     virtual size_t matchATN(CharStream *input);
+
+    /// The equivalent of execATN() for a precompiled DFA, which never needs the ATN.
+    virtual size_t execDFATable(CharStream *input);
     virtual size_t execATN(CharStream *input, dfa::DFAState *ds0);
 
     /// <summary>
@@ -3,7 +3,7 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 #include "atn/LexerIndexedCustomAction.h"
 #include "support/CPPUtils.h"
 #include "support/Arrays.h"
@@ -97,11 +97,11 @@ bool LexerActionExecutor::operator != (const LexerActionExecutor &obj) const {
 }
 
 size_t LexerActionExecutor::generateHashCode() const {
-  size_t hash = MurmurHash::initialize();
+  size_t hash = HashPolicy::initialize();
   for (auto lexerAction : _lexerActions) {
-    hash = MurmurHash::update(hash, lexerAction);
+    hash = HashPolicy::update(hash, lexerAction);
   }
-  hash = MurmurHash::finish(hash, _lexerActions.size());
+  hash = HashPolicy::finish(hash, _lexerActions.size());
 
   return hash;
 }
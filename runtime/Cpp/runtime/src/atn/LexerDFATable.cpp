@@ -0,0 +1,164 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ANTLRInputStream.h"
+#include "Exceptions.h"
+#include "Token.h"
+#include "atn/ATN.h"
+#include "atn/ATNConfigSet.h"
+#include "atn/ATNType.h"
+#include "atn/LexerAction.h"
+#include "atn/LexerATNSimulator.h"
+#include "atn/LexerTransitionTable.h"
+#include "atn/PredictionContext.h"
+#include "atn/TokensStartState.h"
+#include "atn/Transition.h"
+#include "dfa/DFAState.h"
+
+#include "atn/LexerDFATable.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+namespace {
+
+  // Gives access to the DFA construction of the lexer simulator.
+  class DFABuilder : public LexerATNSimulator {
+  public:
+    DFABuilder(const ATN &atn, std::vector<dfa::DFA> &decisionToDFA, PredictionContextCache &sharedContextCache)
+      : LexerATNSimulator(atn, decisionToDFA, sharedContextCache) {
+    }
+
+    dfa::DFAState* createStartState(CharStream *input, size_t mode) {
+      _mode = mode;
+      std::unique_ptr<ATNConfigSet> configs = computeStartState(input, atn.modeToStartState[mode]);
+      configs->hasSemanticContext = false;
+      dfa::DFAState *result = addDFAState(configs.release());
+      _decisionToDFA[mode].s0 = result;
+      return result;
+    }
+
+    // Returns the target of the given state in the current mode or nullptr if the symbol cannot be matched.
+    dfa::DFAState* createTargetState(CharStream *input, dfa::DFAState *state, size_t t) {
+      dfa::DFAState *target = computeTargetState(input, state, t);
+      return target == ERROR.get() ? nullptr : target;
+    }
+  };
+
+}
+
+bool LexerDFATable::isSupported(const ATN &atn) {
+  if (atn.grammarType != ATNType::LEXER) {
+    return false;
+  }
+
+  for (const Ref<LexerAction> &action : atn.lexerActions) {
+    if (action->getActionType() == LexerActionType::CUSTOM) {
+      return false;
+    }
+  }
+
+  for (ATNState *state : atn.states) {
+    if (state == nullptr) {
+      continue;
+    }
+
+    for (Transition *transition : state->transitions) {
+      if (transition->getSerializationType() == Transition::PREDICATE) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+LexerDFATable::LexerDFATable(const ATN &atn) : _transitionTable(atn.lexerTransitionTable) {
+  if (!isSupported(atn)) {
+    throw UnsupportedOperationException("Lexer DFA tables require a lexer without semantic predicates and custom actions.");
+  }
+
+  if (_transitionTable == nullptr) {
+    _transitionTable = std::make_shared<LexerTransitionTable>(atn);
+  }
+
+  size_t classCount = _transitionTable->getCharClassCount();
+  _columnCount = classCount + 1;
+
+  size_t modeCount = atn.modeToStartState.size();
+  _dfas.reserve(modeCount);
+  for (size_t mode = 0; mode < modeCount; ++mode) {
+    _dfas.emplace_back(atn.getDecisionState(mode), mode);
+  }
+
+  // No input is looked at while computing states, since there are no predicates.
+  ANTLRInputStream input;
+  PredictionContextCache contextCache;
+  DFABuilder builder(atn, _dfas, contextCache);
+
+  // The states of all modes are numbered consecutively, in the order they are found.
+  std::unordered_map<dfa::DFAState *, uint32_t> stateNumbers;
+  auto getStateNumber = [&](dfa::DFAState *state) {
+    auto iterator = stateNumbers.find(state);
+    if (iterator != stateNumbers.end()) {
+      return iterator->second;
+    }
+
+    uint32_t number = static_cast<uint32_t>(_states.size());
+    stateNumbers.emplace(state, number);
+    _states.push_back(state);
+    return number;
+  };
+
+  for (size_t mode = 0; mode < modeCount; ++mode) {
+    size_t next = _states.size();
+    _startStates.push_back(getStateNumber(builder.createStartState(&input, mode)));
+
+    // Builder states are created in the DFA of the current mode, so each mode is completed before the next.
+    for (; next < _states.size(); ++next) {
+      dfa::DFAState *state = _states[next];
+      _transitions.resize(_transitions.size() + _columnCount, static_cast<uint32_t>(ERROR_STATE));
+      uint32_t *row = &_transitions[next * _columnCount];
+      for (size_t charClass = 0; charClass < classCount; ++charClass) {
+        dfa::DFAState *target = builder.createTargetState(&input, state, _transitionTable->getCharClassStart(charClass));
+        if (target != nullptr) {
+          row[charClass] = getStateNumber(target);
+        }
+      }
+
+      dfa::DFAState *target = builder.createTargetState(&input, state, Token::EOF);
+      if (target != nullptr) {
+        row[classCount] = getStateNumber(target);
+      }
+    }
+  }
+}
+
+LexerDFATable::~LexerDFATable() {
+}
+
+size_t LexerDFATable::getStateCount() const {
+  return _states.size();
+}
+
+size_t LexerDFATable::getStartState(size_t mode) const {
+  return _startStates[mode];
+}
+
+size_t LexerDFATable::getTarget(size_t state, size_t symbol) const {
+  size_t column;
+  if (symbol == Token::EOF) {
+    column = _columnCount - 1;
+  } else {
+    column = _transitionTable->getCharClass(symbol);
+    if (column == LexerTransitionTable::INVALID_CLASS) {
+      return ERROR_STATE;
+    }
+  }
+  return _transitions[state * _columnCount + column];
+}
+
+dfa::DFAState* LexerDFATable::getDFAState(size_t state) const {
+  return _states[state];
+}
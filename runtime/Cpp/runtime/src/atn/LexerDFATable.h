@@ -0,0 +1,72 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "dfa/DFA.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// The complete DFAs of all modes of a lexer, built ahead of time.
+  ///
+  /// Normally the lexer DFA is built lazily while lexing (see LexerATNSimulator::computeTargetState), which
+  /// means the first occurrences of every token pay for ATN closure computations and every DFA step needs a
+  /// locked edge lookup. For lexers without semantic predicates and custom actions the DFA does not depend on
+  /// any runtime state, so it can be built completely in advance. The transitions are then held in a plain table
+  /// with one row per DFA state and one column per character class (see LexerTransitionTable) plus one for EOF,
+  /// which LexerATNSimulator::match() walks without locks or ATN fallbacks once set via
+  /// LexerATNSimulator::setDFATable(). Accept states keep their prediction and lexer action executor, so tokens,
+  /// channels, skip, more and mode actions behave exactly as with the lazily built DFA.
+  ///
+  /// Generated lexers create a table once per lexer class if the grammar sets the precompiledDFA option.
+  class ANTLR4CPP_PUBLIC LexerDFATable {
+  public:
+#if __cplusplus >= 201703L
+    static constexpr size_t ERROR_STATE = std::numeric_limits<uint32_t>::max();
+#else
+    enum : size_t {
+      ERROR_STATE = 0xFFFFFFFF,
+    };
+#endif
+
+    /// Returns true if a table can be built for the given lexer ATN, that is, if no semantic predicates and no
+    /// custom actions are used in it.
+    static bool isSupported(const ATN &atn);
+
+    /// Builds the DFAs for all modes of the given lexer ATN. Throws an UnsupportedOperationException if the
+    /// ATN is not supported (see isSupported()).
+    explicit LexerDFATable(const ATN &atn);
+    LexerDFATable(const LexerDFATable &) = delete;
+    ~LexerDFATable();
+
+    LexerDFATable& operator = (const LexerDFATable &) = delete;
+
+    size_t getStateCount() const;
+    size_t getStartState(size_t mode) const;
+
+    /// Returns the state reached from the given state on the given input symbol or ERROR_STATE if the symbol
+    /// cannot be matched.
+    size_t getTarget(size_t state, size_t symbol) const;
+
+    /// Returns the DFA state with the given number. It holds the accept information and the configurations of
+    /// the state (for error reporting).
+    dfa::DFAState* getDFAState(size_t state) const;
+
+  private:
+    Ref<LexerTransitionTable> _transitionTable;
+
+    /// The DFAs the states were created in, one per mode. They own the states.
+    std::vector<dfa::DFA> _dfas;
+    std::vector<dfa::DFAState *> _states;
+    std::vector<uint32_t> _startStates;
+
+    /// _columnCount entries per state: the targets for each character class followed by the target on EOF.
+    std::vector<uint32_t> _transitions;
+    size_t _columnCount;
+  };
+
+} // namespace atn
+} // namespace antlr4
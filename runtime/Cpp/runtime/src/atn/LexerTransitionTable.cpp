@@ -0,0 +1,147 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "atn/ATN.h"
+#include "atn/ATNState.h"
+#include "atn/Transition.h"
+#include "misc/IntervalSet.h"
+#include "Lexer.h"
+
+#include "atn/LexerTransitionTable.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+
+const uint32_t LexerTransitionTable::NO_ROW;
+const size_t LexerTransitionTable::DIRECT_LOOKUP_SIZE;
+
+namespace {
+
+  // Returns the characters matched by the given transition (limited to the character alphabet).
+  misc::IntervalSet getMatchedCharacters(const Transition *transition) {
+    misc::IntervalSet alphabet = misc::IntervalSet::of(static_cast<ssize_t>(Lexer::MIN_CHAR_VALUE),
+      static_cast<ssize_t>(Lexer::MAX_CHAR_VALUE));
+
+    switch (transition->getSerializationType()) {
+      case Transition::WILDCARD:
+        return alphabet;
+
+      case Transition::NOT_SET:
+        return alphabet.removeAll(transition->label());
+
+      default:
+        return alphabet.retainAll(transition->label());
+    }
+  }
+
+}
+
+LexerTransitionTable::LexerTransitionTable(const ATN &atn) : _rowSize(0) {
+  // Collect the matched characters of all transitions of states with matching transitions. Each interval start
+  // and each character following an interval starts a new class.
+  std::vector<misc::IntervalSet> characters;
+  _stateOffsets.assign(atn.states.size(), NO_ROW);
+  _classStarts.push_back(Lexer::MIN_CHAR_VALUE);
+  for (ATNState *state : atn.states) {
+    if (state == nullptr || std::all_of(state->transitions.begin(), state->transitions.end(),
+                                        [](Transition *transition) { return transition->isEpsilon(); })) {
+      continue;
+    }
+
+    _stateOffsets[static_cast<size_t>(state->stateNumber)] = static_cast<uint32_t>(_transitionRows.size());
+    for (Transition *transition : state->transitions) {
+      if (transition->isEpsilon()) {
+        characters.push_back(misc::IntervalSet());
+        _transitionRows.push_back(NO_ROW);
+        continue;
+      }
+
+      characters.push_back(getMatchedCharacters(transition));
+      _transitionRows.push_back(0); // Set below.
+      for (const misc::Interval &interval : characters.back().getIntervals()) {
+        _classStarts.push_back(static_cast<size_t>(interval.a));
+        if (static_cast<size_t>(interval.b) < Lexer::MAX_CHAR_VALUE) {
+          _classStarts.push_back(static_cast<size_t>(interval.b) + 1);
+        }
+      }
+    }
+  }
+
+  std::sort(_classStarts.begin(), _classStarts.end());
+  _classStarts.erase(std::unique(_classStarts.begin(), _classStarts.end()), _classStarts.end());
+  _rowSize = (_classStarts.size() + 63) / 64;
+
+  // Many transitions match the same characters (e.g. all uses of a set), so equal rows are shared.
+  std::map<std::vector<uint64_t>, uint32_t> rowIndexes;
+  for (size_t i = 0; i < characters.size(); ++i) {
+    if (_transitionRows[i] == NO_ROW) {
+      continue;
+    }
+
+    std::vector<uint64_t> row(_rowSize);
+    for (const misc::Interval &interval : characters[i].getIntervals()) {
+      size_t first = static_cast<size_t>(std::lower_bound(_classStarts.begin(), _classStarts.end(),
+        static_cast<size_t>(interval.a)) - _classStarts.begin());
+      size_t last = static_cast<size_t>(std::lower_bound(_classStarts.begin() + first, _classStarts.end(),
+        static_cast<size_t>(interval.b) + 1) - _classStarts.begin());
+      for (size_t charClass = first; charClass < last; ++charClass) {
+        row[charClass / 64] |= 1ULL << (charClass % 64);
+      }
+    }
+
+    auto iterator = rowIndexes.find(row);
+    if (iterator == rowIndexes.end()) {
+      iterator = rowIndexes.emplace(row, static_cast<uint32_t>(rowIndexes.size())).first;
+      _rows.insert(_rows.end(), row.begin(), row.end());
+    }
+    _transitionRows[i] = iterator->second;
+  }
+
+  _directClasses.resize(std::min(DIRECT_LOOKUP_SIZE, static_cast<size_t>(Lexer::MAX_CHAR_VALUE) + 1));
+  size_t charClass = 0;
+  for (size_t c = 0; c < _directClasses.size(); ++c) {
+    while (charClass + 1 < _classStarts.size() && _classStarts[charClass + 1] <= c) {
+      ++charClass;
+    }
+    _directClasses[c] = static_cast<uint32_t>(charClass);
+  }
+}
+
+size_t LexerTransitionTable::getCharClass(size_t symbol) const {
+  if (symbol < _directClasses.size()) {
+    return _directClasses[symbol];
+  }
+
+  if (symbol > Lexer::MAX_CHAR_VALUE) {
+    return INVALID_CLASS;
+  }
+
+  return static_cast<size_t>(std::upper_bound(_classStarts.begin(), _classStarts.end(), symbol) - _classStarts.begin()) - 1;
+}
+
+size_t LexerTransitionTable::getCharClassCount() const {
+  return _classStarts.size();
+}
+
+size_t LexerTransitionTable::getCharClassStart(size_t charClass) const {
+  return _classStarts[charClass];
+}
+
+bool LexerTransitionTable::hasMatchingTransitions(const ATNState *state) const {
+  return _stateOffsets[static_cast<size_t>(state->stateNumber)] != NO_ROW;
+}
+
+bool LexerTransitionTable::matches(const ATNState *state, size_t transitionIndex, size_t charClass) const {
+  uint32_t offset = _stateOffsets[static_cast<size_t>(state->stateNumber)];
+  if (offset == NO_ROW) {
+    return false;
+  }
+
+  uint32_t row = _transitionRows[offset + transitionIndex];
+  if (row == NO_ROW) {
+    return false;
+  }
+  return (_rows[row * _rowSize + charClass / 64] & (1ULL << (charClass % 64))) != 0;
+}
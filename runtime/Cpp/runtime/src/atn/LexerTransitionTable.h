@@ -0,0 +1,73 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace atn {
+
+  /// The matching transitions of a lexer ATN in table form.
+  ///
+  /// The character alphabet is partitioned into classes of characters which no transition of the ATN can tell
+  /// apart (as classic lexer generators do), e.g. 'a'..'z' would be a single class in a lexer which only uses
+  /// the range [a-z]. For each matching transition the table holds a bit row with the classes it matches, so
+  /// matching a character is one class lookup per character plus one bit test per transition, instead of a
+  /// virtual Transition::matches() call, which walks the intervals of set transitions.
+  ///
+  /// The table is created by the ATNDeserializer for lexer ATNs (see ATN::lexerTransitionTable) and must not be
+  /// used anymore if the transitions of the ATN are changed afterwards.
+  class ANTLR4CPP_PUBLIC LexerTransitionTable {
+  public:
+#if __cplusplus >= 201703L
+    static constexpr size_t INVALID_CLASS = std::numeric_limits<size_t>::max();
+#else
+    enum : size_t {
+      INVALID_CLASS = static_cast<size_t>(-1),
+    };
+#endif
+
+    explicit LexerTransitionTable(const ATN &atn);
+
+    /// Returns the class of the given input symbol or INVALID_CLASS for symbols outside of the character
+    /// alphabet (e.g. EOF). Transitions must be tested with Transition::matches() for such symbols.
+    size_t getCharClass(size_t symbol) const;
+
+    size_t getCharClassCount() const;
+
+    /// Returns the first (smallest) character of the given class, which can stand in for the whole class.
+    size_t getCharClassStart(size_t charClass) const;
+
+    /// Returns true if the given state has any transition which matches characters.
+    bool hasMatchingTransitions(const ATNState *state) const;
+
+    /// Returns true if the transition with the given index in the given state matches the characters of the
+    /// given class, which must not be INVALID_CLASS.
+    bool matches(const ATNState *state, size_t transitionIndex, size_t charClass) const;
+
+  private:
+    static const uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+
+    /// Classes are looked up in this table for small characters and by binary search in _classStarts for all others.
+    static const size_t DIRECT_LOOKUP_SIZE = 256;
+
+    /// The first character of each class, in ascending order. The first class starts at Lexer::MIN_CHAR_VALUE.
+    std::vector<size_t> _classStarts;
+    std::vector<uint32_t> _directClasses;
+
+    /// The bit rows for all distinct sets of classes matched by a transition, _rowSize words each.
+    std::vector<uint64_t> _rows;
+    size_t _rowSize;
+
+    /// The index of the first entry in _transitionRows for each ATN state (NO_ROW for states without matching
+    /// transitions). The entries hold the index of the row of each transition of the state (NO_ROW for epsilon
+    /// transitions).
+    std::vector<uint32_t> _stateOffsets;
+    std::vector<uint32_t> _transitionRows;
+  };
+
+} // namespace atn
+} // namespace antlr4
@@ -3,6 +3,9 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "atn/PredictionContext.h"
+#include "atn/LexerATNConfig.h"
+
 #include "atn/OrderedATNConfigSet.h"
 
 using namespace antlr4::atn;
@@ -10,3 +13,17 @@ using namespace antlr4::atn;
 size_t OrderedATNConfigSet::getHash(ATNConfig *c) {
   return c->hashCode();
 }
+
+bool OrderedATNConfigSet::isSameKey(ATNConfig *lhs, ATNConfig *rhs) {
+  // Only configs which are equal as a whole are combined, so the order of all others is kept.
+  if (lhs == rhs) {
+    return true;
+  }
+
+  LexerATNConfig *lexerLhs = dynamic_cast<LexerATNConfig *>(lhs);
+  LexerATNConfig *lexerRhs = dynamic_cast<LexerATNConfig *>(rhs);
+  if (lexerLhs != nullptr && lexerRhs != nullptr) {
+    return *lexerLhs == *lexerRhs;
+  }
+  return lexerLhs == nullptr && lexerRhs == nullptr && *lhs == *rhs;
+}
@@ -27,6 +27,7 @@
 #include "atn/BlockEndState.h"
 
 #include "misc/Interval.h"
+#include "misc/FastHash.h"
 #include "ANTLRErrorListener.h"
 
 #include "Vocabulary.h"
@@ -58,6 +59,8 @@ ParserATNSimulator::ParserATNSimulator(Parser *parser, const ATN &atn, std::vect
 }
 
 void ParserATNSimulator::reset() {
+  // Token indices and contexts in the memo refer to the previous input.
+  _fullContextMemo.clear();
 }
 
 void ParserATNSimulator::clearDFA() {
@@ -219,10 +222,51 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
         std::cout << "ctx sensitive state " << outerContext << " in " << D << std::endl;
 #endif
 
+      FullContextMemoKey key = { dfa.decision, startIndex, outerContext };
+      if (_fullContextMemoEnabled) {
+        auto iterator = _fullContextMemo.find(key);
+        if (iterator != _fullContextMemo.end()) {
+          ++_fullContextMemoHits;
+          return iterator->second;
+        }
+        ++_fullContextMemoMisses;
+      }
+
+      // The full context prediction depends only on the stack of outer rule invocations and the input
+      // (unless predicates are involved), so results are cached with these as key.
+      std::vector<size_t> stack;
+      size_t stackHash = 0;
+      if (_fullContextCacheLimit > 0) {
+        stackHash = misc::HashPolicy::initialize();
+        for (RuleContext *context = outerContext; context != nullptr && context->parent != nullptr &&
+             context != &ParserRuleContext::EMPTY; context = dynamic_cast<RuleContext *>(context->parent)) {
+          stack.push_back(context->invokingState);
+          stackHash = misc::HashPolicy::update(stackHash, context->invokingState);
+        }
+        stackHash = misc::HashPolicy::finish(stackHash, stack.size());
+
+        size_t conflictIndex = input->index();
+        size_t alt = getCachedFullContextPrediction(D, stack, stackHash, input, startIndex);
+        if (alt != ATN::INVALID_ALT_NUMBER) {
+          if (_fullContextMemoEnabled) {
+            _fullContextMemo[key] = alt;
+          }
+          return alt;
+        }
+        input->seek(conflictIndex);
+      }
+
       bool fullCtx = true;
+      _fullContextPredictionCacheable = true;
       Ref<ATNConfigSet> s0_closure = computeStartState(dfa.atnStartState, outerContext, fullCtx);
       reportAttemptingFullContext(dfa, conflictingAlts, D->configs.get(), startIndex, input->index());
       size_t alt = execATNWithFullContext(dfa, D, s0_closure.get(), input, startIndex, outerContext);
+      if (_fullContextMemoEnabled) {
+        _fullContextMemo[key] = alt;
+      }
+      if (_fullContextCacheLimit > 0 && _fullContextPredictionCacheable) {
+        cacheFullContextPrediction(D, std::move(stack), stackHash, input, startIndex, alt);
+      }
       return alt;
     }
 
@@ -259,12 +303,7 @@ size_t ParserATNSimulator::execATN(dfa::DFA &dfa, dfa::DFAState *s0, TokenStream
 }
 
 dfa::DFAState *ParserATNSimulator::getExistingTargetState(dfa::DFAState *previousD, size_t t) {
-  dfa::DFAState* retval;
-  _edgeLock.readLock();
-  auto iterator = previousD->edges.find(t);
-  retval = (iterator == previousD->edges.end()) ? nullptr : iterator->second;
-  _edgeLock.readUnlock();
-  return retval;
+  return previousD->getEdge(t);
 }
 
 dfa::DFAState *ParserATNSimulator::computeTargetState(dfa::DFA &dfa, dfa::DFAState *previousD, size_t t) {
@@ -353,6 +392,7 @@ size_t ParserATNSimulator::execATNWithFullContext(dfa::DFA &dfa, dfa::DFAState *
       // will get error no matter what.
       NoViableAltException e = noViableAlt(input, outerContext, previous, startIndex, previous != s0);
       input->seek(startIndex);
+      _fullContextPredictionCacheable = false; // An error which is reported later, no real prediction.
       size_t alt = getSynValidOrSemInvalidAltThatFinishedDecisionEntryRule(previous, outerContext);
       if (alt != ATN::INVALID_ALT_NUMBER) {
         return alt;
@@ -438,6 +478,7 @@ size_t ParserATNSimulator::execATNWithFullContext(dfa::DFA &dfa, dfa::DFAState *
 std::unique_ptr<ATNConfigSet> ParserATNSimulator::computeReachSet(ATNConfigSet *closure_, size_t t, bool fullCtx) {
 
   std::unique_ptr<ATNConfigSet> intermediate(new ATNConfigSet(fullCtx));
+  intermediate->reserve(closure_->size()); // The previous closure size is a good estimate for both sets.
 
   /* Configurations already in a rule stop state indicate reaching the end
    * of the decision rule (local context) or end of the start rule (full
@@ -504,6 +545,7 @@ std::unique_ptr<ATNConfigSet> ParserATNSimulator::computeReachSet(ATNConfigSet *
    */
   if (reach == nullptr) {
     reach.reset(new ATNConfigSet(fullCtx));
+    reach->reserve(closure_->size());
     ATNConfig::Set closureBusy;
 
     bool treatEofAsEpsilon = t == Token::EOF;
@@ -806,6 +848,7 @@ BitSet ParserATNSimulator::evalSemanticContext(std::vector<dfa::DFAState::PredPr
 
 bool ParserATNSimulator::evalSemanticContext(Ref<SemanticContext> const& pred, ParserRuleContext *parserCallStack,
                                              size_t /*alt*/, bool /*fullCtx*/) {
+  _fullContextPredictionCacheable = false; // The result of a full context prediction can depend on this.
   return pred->eval(parser, parserCallStack);
 }
 
@@ -1229,15 +1272,12 @@ NoViableAltException ParserATNSimulator::noViableAlt(TokenStream *input, ParserR
 }
 
 size_t ParserATNSimulator::getUniqueAlt(ATNConfigSet *configs) {
-  size_t alt = ATN::INVALID_ALT_NUMBER;
-  for (auto &c : configs->configs) {
-    if (alt == ATN::INVALID_ALT_NUMBER) {
-      alt = c->alt; // found first alt
-    } else if (c->alt != alt) {
-      return ATN::INVALID_ALT_NUMBER;
-    }
+  // The set keeps track of its alternatives.
+  antlrcpp::BitSet alts = configs->getAlts();
+  if (alts.count() != 1) {
+    return ATN::INVALID_ALT_NUMBER;
   }
-  return alt;
+  return alts.nextSetBit(0);
 }
 
 dfa::DFAState *ParserATNSimulator::addDFAEdge(dfa::DFA &dfa, dfa::DFAState *from, ssize_t t, dfa::DFAState *to) {
@@ -1258,7 +1298,7 @@ dfa::DFAState *ParserATNSimulator::addDFAEdge(dfa::DFA &dfa, dfa::DFAState *from
 
   {
     _edgeLock.writeLock();
-    from->edges[t] = to; // connect
+    from->setEdge(t, to); // connect
     _edgeLock.writeUnlock();
   }
 
@@ -1344,6 +1384,99 @@ atn::PredictionMode ParserATNSimulator::getPredictionMode() {
   return _mode;
 }
 
+void ParserATNSimulator::setFullContextMemoization(bool enable) {
+  _fullContextMemoEnabled = enable;
+  if (!enable) {
+    _fullContextMemo.clear();
+  }
+}
+
+bool ParserATNSimulator::isFullContextMemoizationEnabled() const {
+  return _fullContextMemoEnabled;
+}
+
+void ParserATNSimulator::clearFullContextMemo() {
+  if (!_fullContextMemo.empty()) {
+    _fullContextMemo.clear();
+  }
+}
+
+size_t ParserATNSimulator::getFullContextMemoHits() const {
+  return _fullContextMemoHits;
+}
+
+size_t ParserATNSimulator::getFullContextMemoMisses() const {
+  return _fullContextMemoMisses;
+}
+
+void ParserATNSimulator::setFullContextCacheLimit(size_t limit) {
+  _fullContextCacheLimit = limit;
+}
+
+size_t ParserATNSimulator::getFullContextCacheLimit() const {
+  return _fullContextCacheLimit;
+}
+
+size_t ParserATNSimulator::getCachedFullContextPrediction(dfa::DFAState *D, const std::vector<size_t> &stack,
+                                                          size_t stackHash, TokenStream *input, size_t startIndex) {
+  // The candidates are copied under the lock and compared with the input afterwards. Reading the input can run
+  // the lexer, which takes the (non reentrant) state lock itself when it adds DFA states.
+  std::vector<std::pair<std::vector<size_t>, size_t>> candidates;
+  _stateLock.readLock();
+  for (auto &entry : D->fullContextPredictions) {
+    if (entry.stackHash == stackHash && entry.stack == stack) {
+      candidates.emplace_back(entry.lookahead, entry.prediction);
+    }
+  }
+  _stateLock.readUnlock();
+
+  for (auto &candidate : candidates) {
+    const std::vector<size_t> &lookahead = candidate.first;
+    input->seek(startIndex);
+    size_t i = 0;
+    while (input->LA(1) == lookahead[i]) {
+      if (++i == lookahead.size()) {
+        return candidate.second;
+      }
+      input->consume();
+    }
+  }
+
+  return ATN::INVALID_ALT_NUMBER;
+}
+
+void ParserATNSimulator::cacheFullContextPrediction(dfa::DFAState *D, std::vector<size_t> stack, size_t stackHash,
+                                                    TokenStream *input, size_t startIndex, size_t prediction) {
+  dfa::DFAState::FullContextPrediction entry;
+  entry.stackHash = stackHash;
+  entry.stack = std::move(stack);
+  entry.prediction = prediction;
+
+  size_t stopIndex = input->index();
+  input->seek(startIndex);
+  while (true) {
+    size_t t = input->LA(1);
+    entry.lookahead.push_back(t);
+    if (t == Token::EOF || input->index() >= stopIndex) {
+      break;
+    }
+    input->consume();
+  }
+
+  _stateLock.writeLock();
+  if (D->fullContextPredictions.size() < _fullContextCacheLimit) {
+    D->fullContextPredictions.push_back(std::move(entry));
+  }
+  _stateLock.writeUnlock();
+}
+
+size_t ParserATNSimulator::FullContextMemoKey::Hasher::operator()(const FullContextMemoKey &k) const {
+  size_t hash = misc::HashPolicy::initialize();
+  hash = misc::HashPolicy::update(hash, k.decision, k.startIndex);
+  hash = misc::HashPolicy::update(hash, reinterpret_cast<size_t>(k.outerContext));
+  return misc::HashPolicy::finish(hash, 3);
+}
+
 Parser* ParserATNSimulator::getParser() {
   return parser;
 }
@@ -1367,4 +1500,10 @@ bool ParserATNSimulator::getLrLoopSetting() {
 void ParserATNSimulator::InitializeInstanceFields() {
   _mode = PredictionMode::LL;
   _startIndex = 0;
+  _dfaFastPathType = &typeid(ParserATNSimulator);
+  _fullContextMemoEnabled = false;
+  _fullContextMemoHits = 0;
+  _fullContextMemoMisses = 0;
+  _fullContextCacheLimit = 0;
+  _fullContextPredictionCacheable = false;
 }
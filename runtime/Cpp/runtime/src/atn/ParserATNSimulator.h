@@ -253,8 +253,20 @@ namespace atn {
 
     virtual void reset() override;
     virtual void clearDFA() override;
+    /// Generated parsers call predict(), which calls this method only if the prediction can't be taken from the
+    /// DFA directly. That shortcut is only taken for the simulator class named in _dfaFastPathType, so
+    /// subclasses (which may override this method) see every prediction, unless they opt in.
     virtual size_t adaptivePredict(TokenStream *input, size_t decision, ParserRuleContext *outerContext);
-    
+
+    /// The entry point for generated parsers. It first walks the DFA for the given decision directly on the
+    /// lookahead symbols (without mark/seek/release of the input or any other per call setup). Only if that
+    /// walk doesn't end in an accept state without predicates (a missing edge, an error state, a state
+    /// requiring full context or predicate evaluation) adaptivePredict() is called, which starts over.
+    /// The result is always the same as that of adaptivePredict().
+    /// Defined in atn/ParserATNSimulatorPredict.h (which antlr4-runtime.h includes), so that this header does
+    /// not depend on Parser.h.
+    inline size_t predict(TokenStream *input, size_t decision, ParserRuleContext *outerContext);
+
     static const bool TURN_OFF_LR_LOOP_ENTRY_BRANCH_OPT;
 
     std::vector<dfa::DFA> &decisionToDFA;
@@ -354,6 +366,38 @@ namespace atn {
     void setPredictionMode(PredictionMode newMode);
     PredictionMode getPredictionMode();
 
+    /// Enables (or disables) the memoization of full context (LL) predictions. The memo is keyed on the
+    /// decision, the start token index and the outer context and lives until the next reset() (i.e. it covers
+    /// one parse run). Full context predictions which are repeated at the same input position (for instance
+    /// after error recovery) are then looked up instead of simulated again.
+    ///
+    /// This requires semantic predicates to depend only on the input and the parser context. No
+    /// reportAttemptingFullContext/reportContextSensitivity notifications are sent for memoized predictions.
+    void setFullContextMemoization(bool enable);
+    bool isFullContextMemoizationEnabled() const;
+
+    /// Drops all memoized full context predictions. The parser calls this when it releases rule contexts for
+    /// reuse, because the memo refers to outer contexts by address.
+    void clearFullContextMemo();
+
+    /// The number of full context predictions which were taken from the memo or had to be computed,
+    /// since this simulator was created. Only predictions made while the memo is enabled are counted.
+    size_t getFullContextMemoHits() const;
+    size_t getFullContextMemoMisses() const;
+
+    /// Sets the number of full context (LL) predictions which are cached per DFA state (0, the default,
+    /// disables the cache). Without this cache DFA states which require full context repeat the full LL
+    /// simulation on every visit. With it, each result is stored in the DFA state together with the stack of
+    /// outer rule invocations and the tokens the simulation has read, and is reused for later predictions
+    /// with the same stack and input, also across parse runs and parsers sharing the DFA. Once the limit is
+    /// reached for a state, further results are not cached.
+    ///
+    /// Results which involved the evaluation of semantic predicates are never cached. No
+    /// reportAttemptingFullContext/reportContextSensitivity/reportAmbiguity notifications are sent for
+    /// cached predictions.
+    void setFullContextCacheLimit(size_t limit);
+    size_t getFullContextCacheLimit() const;
+
     Parser* getParser();
     
     virtual std::string getTokenName(size_t t);
@@ -386,6 +430,45 @@ namespace atn {
     size_t _startIndex;
     ParserRuleContext *_outerContext;
     dfa::DFA *_dfa; // Reference into the decisionToDFA vector.
+
+    /// predict() takes DFA paths without calling adaptivePredict() only if the dynamic type of this simulator is
+    /// this type. It is ParserATNSimulator by default, so subclasses go through adaptivePredict() for every
+    /// prediction. A subclass which doesn't need that can set its own type here, null disables the shortcut.
+    const std::type_info *_dfaFastPathType;
+
+    struct FullContextMemoKey {
+      size_t decision;
+      size_t startIndex;
+      ParserRuleContext *outerContext;
+
+      bool operator == (const FullContextMemoKey &other) const {
+        return decision == other.decision && startIndex == other.startIndex && outerContext == other.outerContext;
+      }
+
+      struct Hasher {
+        size_t operator()(const FullContextMemoKey &k) const;
+      };
+    };
+
+    bool _fullContextMemoEnabled;
+    std::unordered_map<FullContextMemoKey, size_t, FullContextMemoKey::Hasher> _fullContextMemo;
+    size_t _fullContextMemoHits;
+    size_t _fullContextMemoMisses;
+
+    size_t _fullContextCacheLimit;
+
+    // Cleared during a full context prediction which must not be cached.
+    bool _fullContextPredictionCacheable;
+
+    /// Returns a cached full context prediction for the given DFA state, stack and input (which is at the
+    /// given start index), or ATN::INVALID_ALT_NUMBER if there is none. Moves the input.
+    size_t getCachedFullContextPrediction(dfa::DFAState *D, const std::vector<size_t> &stack, size_t stackHash,
+                                          TokenStream *input, size_t startIndex);
+
+    /// Stores a full context prediction which read the input from startIndex up to the current index.
+    /// Moves the input.
+    void cacheFullContextPrediction(dfa::DFAState *D, std::vector<size_t> stack, size_t stackHash, TokenStream *input,
+                                    size_t startIndex, size_t prediction);
     
     /// <summary>
     /// Performs ATN simulation to compute a predicted alternative based
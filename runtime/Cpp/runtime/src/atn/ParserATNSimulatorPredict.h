@@ -0,0 +1,54 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "dfa/DFA.h"
+#include "dfa/DFAState.h"
+#include "atn/ParserATNSimulator.h"
+#include "Parser.h"
+#include "Token.h"
+
+namespace antlr4 {
+namespace atn {
+
+  // The DFA fast path of ParserATNSimulator::predict(), inlined into generated parsers.
+  inline size_t ParserATNSimulator::predict(TokenStream *input, size_t decision, ParserRuleContext *outerContext) {
+    if (_dfaFastPathType != nullptr && typeid(*this) == *_dfaFastPathType) {
+      dfa::DFA &dfa = decisionToDFA[decision];
+      dfa::DFAState *previousD = dfa.s0;
+      if (previousD != nullptr && dfa.isPrecedenceDfa()) {
+        previousD = previousD->getEdge(static_cast<size_t>(parser->getPrecedence()));
+      }
+
+      if (previousD != nullptr) {
+        size_t i = 1;
+        size_t t = input->LA(i);
+        while (true) {
+          dfa::DFAState *D = previousD->getEdge(t);
+          if (D == nullptr || D == ERROR.get() || (D->requiresFullContext && _mode != PredictionMode::SLL)) {
+            break;
+          }
+
+          if (D->isAcceptState) {
+            if (D->predicates.empty()) {
+              return D->prediction;
+            }
+            break;
+          }
+
+          previousD = D;
+          if (t != Token::EOF) {
+            t = input->LA(++i);
+          }
+        }
+      }
+    }
+
+    return adaptivePredict(input, decision, outerContext);
+  }
+
+} // namespace atn
+} // namespace antlr4
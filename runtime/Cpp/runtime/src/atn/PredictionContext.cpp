@@ -4,7 +4,7 @@
  */
 
 #include "atn/EmptyPredictionContext.h"
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 #include "atn/ArrayPredictionContext.h"
 #include "RuleContext.h"
 #include "ParserRuleContext.h"
@@ -64,32 +64,30 @@ size_t PredictionContext::hashCode() const {
 }
 
 size_t PredictionContext::calculateEmptyHashCode() {
-  size_t hash = MurmurHash::initialize(INITIAL_HASH);
-  hash = MurmurHash::finish(hash, 0);
+  size_t hash = HashPolicy::initialize(INITIAL_HASH);
+  hash = HashPolicy::finish(hash, 0);
   return hash;
 }
 
-size_t PredictionContext::calculateHashCode(Ref<PredictionContext> parent, size_t returnState) {
-  size_t hash = MurmurHash::initialize(INITIAL_HASH);
-  hash = MurmurHash::update(hash, parent);
-  hash = MurmurHash::update(hash, returnState);
-  hash = MurmurHash::finish(hash, 2);
+size_t PredictionContext::calculateHashCode(const Ref<PredictionContext> &parent, size_t returnState) {
+  size_t hash = HashPolicy::initialize(INITIAL_HASH);
+  hash = HashPolicy::update(hash, parent != nullptr ? parent->hashCode() : 0, returnState);
+  hash = HashPolicy::finish(hash, 2);
   return hash;
 }
 
 size_t PredictionContext::calculateHashCode(const std::vector<Ref<PredictionContext>> &parents,
                                             const std::vector<size_t> &returnStates) {
-  size_t hash = MurmurHash::initialize(INITIAL_HASH);
+  size_t hash = HashPolicy::initialize(INITIAL_HASH);
 
-  for (auto parent : parents) {
-    hash = MurmurHash::update(hash, parent);
+  // Parents and return states are hashed pairwise, one step per entry, the same way as for singleton contexts.
+  const Ref<PredictionContext> *parent = parents.data();
+  const size_t *returnState = returnStates.data();
+  for (size_t i = 0; i < returnStates.size(); ++i) {
+    hash = HashPolicy::update(hash, parent[i] != nullptr ? parent[i]->hashCode() : 0, returnState[i]);
   }
 
-  for (auto returnState : returnStates) {
-    hash = MurmurHash::update(hash, returnState);
-  }
-
-  return MurmurHash::finish(hash, parents.size() + returnStates.size());
+  return HashPolicy::finish(hash, parents.size() + returnStates.size());
 }
 
 Ref<PredictionContext> PredictionContext::merge(const Ref<PredictionContext> &a,
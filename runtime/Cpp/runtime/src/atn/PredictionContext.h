@@ -56,18 +56,14 @@ namespace atn {
     /// code is computed in parts to match the following reference algorithm.
     ///
     /// <pre>
-    ///  private int referenceHashCode() {
-    ///      int hash = <seealso cref="MurmurHash#initialize"/>(<seealso cref="#INITIAL_HASH"/>);
+    ///  size_t referenceHashCode() {
+    ///      size_t hash = HashPolicy::initialize(INITIAL_HASH);
     ///
-    ///      for (int i = 0; i < <seealso cref="#size()"/>; i++) {
-    ///          hash = <seealso cref="MurmurHash#update"/>(hash, <seealso cref="#getParent"/>(i));
+    ///      for (size_t i = 0; i < size(); i++) {
+    ///          hash = HashPolicy::update(hash, getParent(i)->hashCode(), getReturnState(i));
     ///      }
     ///
-    ///      for (int i = 0; i < <seealso cref="#size()"/>; i++) {
-    ///          hash = <seealso cref="MurmurHash#update"/>(hash, <seealso cref="#getReturnState"/>(i));
-    ///      }
-    ///
-    ///      hash = <seealso cref="MurmurHash#finish"/>(hash, 2 * <seealso cref="#size()"/>);
+    ///      hash = HashPolicy::finish(hash, 2 * size());
     ///      return hash;
     ///  }
     /// </pre>
@@ -96,7 +92,7 @@ namespace atn {
 
   protected:
     static size_t calculateEmptyHashCode();
-    static size_t calculateHashCode(Ref<PredictionContext> parent, size_t returnState);
+    static size_t calculateHashCode(const Ref<PredictionContext> &parent, size_t returnState);
     static size_t calculateHashCode(const std::vector<Ref<PredictionContext>> &parents,
                                     const std::vector<size_t> &returnStates);
 
@@ -6,7 +6,7 @@
 #include "atn/RuleStopState.h"
 #include "atn/ATNConfigSet.h"
 #include "atn/ATNConfig.h"
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 #include "SemanticContext.h"
 
 #include "PredictionMode.h"
@@ -22,10 +22,9 @@ struct AltAndContextConfigHasher
    * and {@link ATNConfig#context}.
    */
   size_t operator () (ATNConfig *o) const {
-    size_t hashCode = misc::MurmurHash::initialize(7);
-    hashCode = misc::MurmurHash::update(hashCode, o->state->stateNumber);
-    hashCode = misc::MurmurHash::update(hashCode, o->context);
-    return misc::MurmurHash::finish(hashCode, 2);
+    size_t hashCode = misc::HashPolicy::initialize(7);
+    hashCode = misc::HashPolicy::update(hashCode, o->state->stateNumber, o->context != nullptr ? o->context->hashCode() : 0);
+    return misc::HashPolicy::finish(hashCode, 2);
   }
 };
 
@@ -101,7 +100,7 @@ bool PredictionModeClass::allSubsetsConflict(const std::vector<antlrcpp::BitSet>
 }
 
 bool PredictionModeClass::hasNonConflictingAltSet(const std::vector<antlrcpp::BitSet>& altsets) {
-  for (antlrcpp::BitSet alts : altsets) {
+  for (const antlrcpp::BitSet &alts : altsets) {
     if (alts.count() == 1) {
       return true;
     }
@@ -110,7 +109,7 @@ bool PredictionModeClass::hasNonConflictingAltSet(const std::vector<antlrcpp::Bi
 }
 
 bool PredictionModeClass::hasConflictingAltSet(const std::vector<antlrcpp::BitSet>& altsets) {
-  for (antlrcpp::BitSet alts : altsets) {
+  for (const antlrcpp::BitSet &alts : altsets) {
     if (alts.count() > 1) {
       return true;
     }
@@ -142,7 +141,7 @@ size_t PredictionModeClass::getUniqueAlt(const std::vector<antlrcpp::BitSet>& al
 
 antlrcpp::BitSet PredictionModeClass::getAlts(const std::vector<antlrcpp::BitSet>& altsets) {
   antlrcpp::BitSet all;
-  for (antlrcpp::BitSet alts : altsets) {
+  for (const antlrcpp::BitSet &alts : altsets) {
     all |= alts;
   }
 
@@ -150,11 +149,7 @@ antlrcpp::BitSet PredictionModeClass::getAlts(const std::vector<antlrcpp::BitSet
 }
 
 antlrcpp::BitSet PredictionModeClass::getAlts(ATNConfigSet *configs) {
-  antlrcpp::BitSet alts;
-  for (auto &config : configs->configs) {
-    alts.set(config->alt);
-  }
-  return alts;
+  return configs->getAlts();
 }
 
 std::vector<antlrcpp::BitSet> PredictionModeClass::getConflictingAltSubsets(ATNConfigSet *configs) {
@@ -186,16 +181,16 @@ bool PredictionModeClass::hasStateAssociatedWithOneAlt(ATNConfigSet *configs) {
 }
 
 size_t PredictionModeClass::getSingleViableAlt(const std::vector<antlrcpp::BitSet>& altsets) {
-  antlrcpp::BitSet viableAlts;
-  for (antlrcpp::BitSet alts : altsets) {
+  // The minimum alts of all sets must be the same, so there is no need to collect them.
+  size_t viableAlt = ATN::INVALID_ALT_NUMBER;
+  for (const antlrcpp::BitSet &alts : altsets) {
     size_t minAlt = alts.nextSetBit(0);
-
-    viableAlts.set(minAlt);
-    if (viableAlts.count() > 1)  // more than 1 viable alt
-    {
+    if (viableAlt == ATN::INVALID_ALT_NUMBER) {
+      viableAlt = minAlt;
+    } else if (minAlt != viableAlt) { // more than 1 viable alt
       return ATN::INVALID_ALT_NUMBER;
     }
   }
 
-  return viableAlts.nextSetBit(0);
+  return viableAlt;
 }
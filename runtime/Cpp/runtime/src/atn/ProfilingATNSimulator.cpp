@@ -25,6 +25,9 @@ ProfilingATNSimulator::ProfilingATNSimulator(Parser *parser)
   for (size_t i = 0; i < atn.decisionToState.size(); i++) {
     _decisions.push_back(DecisionInfo(i));
   }
+
+  // All predictions must go through adaptivePredict() to be recorded.
+  _dfaFastPathType = nullptr;
 }
 
 size_t ProfilingATNSimulator::adaptivePredict(TokenStream *input, size_t decision, ParserRuleContext *outerContext) {
@@ -3,7 +3,7 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 #include "support/CPPUtils.h"
 #include "support/Arrays.h"
 
@@ -20,6 +20,10 @@ SemanticContext::Predicate::Predicate() : Predicate(INVALID_INDEX, INVALID_INDEX
 
 SemanticContext::Predicate::Predicate(size_t ruleIndex, size_t predIndex, bool isCtxDependent)
 : ruleIndex(ruleIndex), predIndex(predIndex), isCtxDependent(isCtxDependent) {
+  size_t hashCode = misc::HashPolicy::initialize();
+  hashCode = misc::HashPolicy::update(hashCode, ruleIndex, predIndex);
+  hashCode = misc::HashPolicy::update(hashCode, isCtxDependent ? 1 : 0);
+  _hashCode = misc::HashPolicy::finish(hashCode, 3);
 }
 
 
@@ -31,12 +35,7 @@ bool SemanticContext::Predicate::eval(Recognizer *parser, RuleContext *parserCal
 }
 
 size_t SemanticContext::Predicate::hashCode() const {
-  size_t hashCode = misc::MurmurHash::initialize();
-  hashCode = misc::MurmurHash::update(hashCode, ruleIndex);
-  hashCode = misc::MurmurHash::update(hashCode, predIndex);
-  hashCode = misc::MurmurHash::update(hashCode, isCtxDependent ? 1 : 0);
-  hashCode = misc::MurmurHash::finish(hashCode, 3);
-  return hashCode;
+  return _hashCode;
 }
 
 bool SemanticContext::Predicate::operator == (const SemanticContext &other) const {
@@ -103,7 +102,15 @@ std::string SemanticContext::PrecedencePredicate::toString() const {
 
 //------------------ AND -----------------------------------------------------------------------------------------------
 
-SemanticContext::AND::AND(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b) {
+SemanticContext::AND::AND(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b) : AND(combine(a, b)) {
+}
+
+SemanticContext::AND::AND(std::vector<Ref<SemanticContext>> operands) : opnds(std::move(operands)) {
+  _hashCode = misc::HashPolicy::hashCode(opnds, typeid(AND).hash_code());
+}
+
+std::vector<Ref<SemanticContext>> SemanticContext::AND::combine(Ref<SemanticContext> const& a,
+                                                                 Ref<SemanticContext> const& b) {
   Set operands;
 
   if (is<AND>(a)) {
@@ -134,7 +141,7 @@ SemanticContext::AND::AND(Ref<SemanticContext> const& a, Ref<SemanticContext> co
     operands.insert(*reduced);
   }
 
-  std::copy(operands.begin(), operands.end(), std::back_inserter(opnds));
+  return std::vector<Ref<SemanticContext>>(operands.begin(), operands.end());
 }
 
 std::vector<Ref<SemanticContext>> SemanticContext::AND::getOperands() const {
@@ -153,7 +160,7 @@ bool SemanticContext::AND::operator == (const SemanticContext &other) const {
 }
 
 size_t SemanticContext::AND::hashCode() const {
-  return misc::MurmurHash::hashCode(opnds, typeid(AND).hash_code());
+  return _hashCode;
 }
 
 bool SemanticContext::AND::eval(Recognizer *parser, RuleContext *parserCallStack) {
@@ -207,7 +214,15 @@ std::string SemanticContext::AND::toString() const {
 
 //------------------ OR ------------------------------------------------------------------------------------------------
 
-SemanticContext::OR::OR(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b) {
+SemanticContext::OR::OR(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b) : OR(combine(a, b)) {
+}
+
+SemanticContext::OR::OR(std::vector<Ref<SemanticContext>> operands) : opnds(std::move(operands)) {
+  _hashCode = misc::HashPolicy::hashCode(opnds, typeid(OR).hash_code());
+}
+
+std::vector<Ref<SemanticContext>> SemanticContext::OR::combine(Ref<SemanticContext> const& a,
+                                                               Ref<SemanticContext> const& b) {
   Set operands;
 
   if (is<OR>(a)) {
@@ -236,7 +251,7 @@ SemanticContext::OR::OR(Ref<SemanticContext> const& a, Ref<SemanticContext> cons
     operands.insert(*reduced);
   }
 
-  std::copy(operands.begin(), operands.end(), std::back_inserter(opnds));
+  return std::vector<Ref<SemanticContext>>(operands.begin(), operands.end());
 }
 
 std::vector<Ref<SemanticContext>> SemanticContext::OR::getOperands() const {
@@ -255,7 +270,7 @@ bool SemanticContext::OR::operator == (const SemanticContext &other) const {
 }
 
 size_t SemanticContext::OR::hashCode() const {
-  return misc::MurmurHash::hashCode(opnds, typeid(OR).hash_code());
+  return _hashCode;
 }
 
 bool SemanticContext::OR::eval(Recognizer *parser, RuleContext *parserCallStack) {
@@ -116,6 +116,10 @@ namespace atn {
     virtual size_t hashCode() const override;
     virtual bool operator == (const SemanticContext &other) const override;
     virtual std::string toString() const override;
+
+  private:
+    // Semantic contexts are immutable and hashed for each config set insertion, so the hash is computed once.
+    size_t _hashCode;
   };
 
   class ANTLR4CPP_PUBLIC SemanticContext::PrecedencePredicate : public SemanticContext {
@@ -164,10 +168,14 @@ namespace atn {
    */
   class ANTLR4CPP_PUBLIC SemanticContext::AND : public SemanticContext::Operator {
   public:
+    /// The hash code is computed from the operands on construction, so they must not be changed afterwards.
     std::vector<Ref<SemanticContext>> opnds;
 
     AND(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b) ;
 
+    /// Takes the operands as they are, without combining nested AND contexts or precedence predicates.
+    explicit AND(std::vector<Ref<SemanticContext>> operands);
+
     virtual std::vector<Ref<SemanticContext>> getOperands() const override;
     virtual bool operator == (const SemanticContext &other) const override;
     virtual size_t hashCode() const override;
@@ -179,6 +187,11 @@ namespace atn {
     virtual bool eval(Recognizer *parser, RuleContext *parserCallStack) override;
     virtual Ref<SemanticContext> evalPrecedence(Recognizer *parser, RuleContext *parserCallStack) override;
     virtual std::string toString() const override;
+
+  private:
+    size_t _hashCode; // Computed from the operands on construction.
+
+    static std::vector<Ref<SemanticContext>> combine(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b);
   };
 
   /**
@@ -187,10 +200,14 @@ namespace atn {
    */
   class ANTLR4CPP_PUBLIC SemanticContext::OR : public SemanticContext::Operator {
   public:
+    /// The hash code is computed from the operands on construction, so they must not be changed afterwards.
     std::vector<Ref<SemanticContext>> opnds;
 
     OR(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b);
 
+    /// Takes the operands as they are, without combining nested OR contexts or precedence predicates.
+    explicit OR(std::vector<Ref<SemanticContext>> operands);
+
     virtual std::vector<Ref<SemanticContext>> getOperands() const override;
     virtual bool operator == (const SemanticContext &other) const override;
     virtual size_t hashCode() const override;
@@ -202,6 +219,11 @@ namespace atn {
     virtual bool eval(Recognizer *parser, RuleContext *parserCallStack) override;
     virtual Ref<SemanticContext> evalPrecedence(Recognizer *parser, RuleContext *parserCallStack) override;
     virtual std::string toString() const override;
+
+  private:
+    size_t _hashCode; // Computed from the operands on construction.
+
+    static std::vector<Ref<SemanticContext>> combine(Ref<SemanticContext> const& a, Ref<SemanticContext> const& b);
   };
 
 } // namespace atn
@@ -11,8 +11,20 @@
 using namespace antlr4;
 using namespace antlr4::atn;
 
+namespace {
+
+  misc::IntervalSet createSet(const misc::IntervalSet &set) {
+    misc::IntervalSet result = set.isEmpty() ? misc::IntervalSet::of(Token::INVALID_TYPE) : set;
+
+    // Transition sets are tested for every symbol, so small symbols (token types, ASCII) get a bitmap.
+    result.createBitmap();
+    return result;
+  }
+
+}
+
 SetTransition::SetTransition(ATNState *target, const misc::IntervalSet &aSet)
-  : Transition(target), set(aSet.isEmpty() ? misc::IntervalSet::of(Token::INVALID_TYPE) : aSet) {
+  : Transition(target), set(createSet(aSet)) {
 }
 
 Transition::SerializationType SetTransition::getSerializationType() const {
@@ -63,11 +63,7 @@ bool DFA::isPrecedenceDfa() const {
 DFAState* DFA::getPrecedenceStartState(int precedence) const {
   assert(_precedenceDfa); // Only precedence DFAs may contain a precedence start state.
 
-  auto iterator = s0->edges.find(precedence);
-  if (iterator == s0->edges.end())
-    return nullptr;
-
-  return iterator->second;
+  return s0->getEdge(static_cast<size_t>(precedence));
 }
 
 void DFA::setPrecedenceStartState(int precedence, DFAState *startState, SingleWriteMultipleReadLock &lock) {
@@ -81,7 +77,7 @@ void DFA::setPrecedenceStartState(int precedence, DFAState *startState, SingleWr
 
   {
     lock.writeLock();
-    s0->edges[precedence] = startState;
+    s0->setEdge(precedence, startState);
     lock.writeUnlock();
   }
 }
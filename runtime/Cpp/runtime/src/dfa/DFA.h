@@ -34,7 +34,7 @@ namespace dfa {
     /**
      * Gets whether this DFA is a precedence DFA. Precedence DFAs use a special
      * start state {@link #s0} which is not stored in {@link #states}. The
-     * {@link DFAState#edges} array for this start state contains outgoing edges
+     * edges (see {@link DFAState#getEdge}) of this start state are outgoing edges
      * supplying individual start states corresponding to specific precedence
      * values.
      *
@@ -28,11 +28,11 @@ std::string DFASerializer::toString() const {
   std::stringstream ss;
   std::vector<DFAState *> states = _dfa->getStates();
   for (auto *s : states) {
-    for (size_t i = 0; i < s->edges.size(); i++) {
-      DFAState *t = s->edges[i];
-      if (t != nullptr && t->stateNumber != INT32_MAX) {
+    for (auto &edge : s->getEdges()) {
+      DFAState *t = edge.second;
+      if (t->stateNumber != INT32_MAX) {
         ss << getStateString(s);
-        std::string label = getEdgeLabel(i);
+        std::string label = getEdgeLabel(edge.first);
         ss << "-" << label << "->" << getStateString(t) << "\n";
       }
     }
@@ -0,0 +1,628 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "atn/ATN.h"
+#include "atn/ATNConfig.h"
+#include "atn/ATNConfigSet.h"
+#include "atn/ATNSimulator.h"
+#include "atn/ArrayPredictionContext.h"
+#include "atn/DecisionState.h"
+#include "atn/SemanticContext.h"
+#include "atn/SingletonPredictionContext.h"
+#include "atn/Transition.h"
+#include "misc/MurmurHash.h"
+#include "Exceptions.h"
+#include "support/CPPUtils.h"
+
+#include "dfa/DFASnapshot.h"
+
+using namespace antlr4;
+using namespace antlr4::atn;
+using namespace antlr4::dfa;
+using namespace antlrcpp;
+
+namespace {
+
+  const char MAGIC[] = { 'A', 'D', 'F', 'A' };
+  const uint64_t VERSION = 1;
+
+  enum : uint64_t {
+    SEMANTIC_NONE,
+    SEMANTIC_PREDICATE,
+    SEMANTIC_PRECEDENCE,
+    SEMANTIC_AND,
+    SEMANTIC_OR
+  };
+
+  enum : uint64_t {
+    CONTEXT_EMPTY,
+    CONTEXT_SINGLETON,
+    CONTEXT_ARRAY
+  };
+
+  // DFA states are referenced by their index in the snapshot + 2.
+  enum : uint64_t {
+    NO_STATE,
+    ERROR_STATE,
+    FIRST_STATE
+  };
+
+  // A fingerprint of the ATN, to make sure a snapshot is only applied to the grammar it was created for.
+  size_t computeChecksum(const ATN &atn) {
+    size_t hash = misc::MurmurHash::initialize();
+    hash = misc::MurmurHash::update(hash, static_cast<size_t>(atn.grammarType));
+    hash = misc::MurmurHash::update(hash, atn.maxTokenType);
+
+    size_t count = 2;
+    for (ATNState *state : atn.states) {
+      if (state == nullptr) {
+        hash = misc::MurmurHash::update(hash, static_cast<size_t>(ATNState::ATN_INVALID_TYPE));
+        ++count;
+        continue;
+      }
+
+      hash = misc::MurmurHash::update(hash, state->getStateType());
+      hash = misc::MurmurHash::update(hash, state->ruleIndex);
+      count += 2;
+      for (Transition *transition : state->transitions) {
+        hash = misc::MurmurHash::update(hash, static_cast<size_t>(transition->getSerializationType()));
+        hash = misc::MurmurHash::update(hash, transition->target->stateNumber);
+        count += 2;
+      }
+    }
+
+    for (DecisionState *state : atn.decisionToState) {
+      hash = misc::MurmurHash::update(hash, state->stateNumber);
+      ++count;
+    }
+
+    return misc::MurmurHash::finish(hash, count);
+  }
+
+  class SnapshotWriter {
+  public:
+    SnapshotWriter(std::ostream &output) : _output(output) {
+    }
+
+    void writeValue(uint64_t value) {
+      // LEB128: 7 bits per byte, high bit set if more bytes follow.
+      while (value >= 0x80) {
+        _output.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+      }
+      _output.put(static_cast<char>(value));
+    }
+
+    // Used for values which can be one of the size_t based markers (e.g. INVALID_INDEX, EOF or EMPTY_RETURN_STATE).
+    // These are written as small negative numbers, to keep snapshots independent of the size of size_t.
+    void writeSize(size_t value) {
+      int64_t signedValue = static_cast<ssize_t>(value);
+      writeValue((static_cast<uint64_t>(signedValue) << 1) ^ static_cast<uint64_t>(signedValue >> 63));
+    }
+
+    // Returns the index of the context in the semantic context table + 1.
+    uint64_t add(const Ref<SemanticContext> &context) {
+      auto iterator = _semanticContextIndex.find(context.get());
+      if (iterator != _semanticContextIndex.end()) {
+        return iterator->second;
+      }
+
+      // Operands are written before the operators using them.
+      if (is<SemanticContext::Operator>(context)) {
+        for (auto &operand : std::static_pointer_cast<SemanticContext::Operator>(context)->getOperands()) {
+          add(operand);
+        }
+      }
+
+      _semanticContexts.push_back(context);
+      return _semanticContextIndex[context.get()] = _semanticContexts.size();
+    }
+
+    // Returns the index of the context in the prediction context table + 1, or 0 for null.
+    uint64_t add(const Ref<PredictionContext> &context) {
+      if (context == nullptr) {
+        return 0;
+      }
+
+      auto iterator = _predictionContextIndex.find(context.get());
+      if (iterator != _predictionContextIndex.end()) {
+        return iterator->second;
+      }
+
+      // Parents are written before their children. Context graphs can be deep, so this is not done recursively.
+      std::vector<std::pair<Ref<PredictionContext>, bool>> pending = { { context, false } };
+      while (!pending.empty()) {
+        Ref<PredictionContext> current = pending.back().first;
+        if (_predictionContextIndex.count(current.get()) > 0) {
+          pending.pop_back();
+          continue;
+        }
+
+        if (pending.back().second) {
+          pending.pop_back();
+          _predictionContexts.push_back(current);
+          _predictionContextIndex[current.get()] = _predictionContexts.size();
+          continue;
+        }
+
+        pending.back().second = true;
+        if (current != PredictionContext::EMPTY) {
+          for (size_t i = 0; i < current->size(); ++i) {
+            Ref<PredictionContext> parent = current->getParent(i);
+            if (parent != nullptr && _predictionContextIndex.count(parent.get()) == 0) {
+              pending.push_back({ parent, false });
+            }
+          }
+        }
+      }
+
+      return _predictionContextIndex[context.get()];
+    }
+
+    void writeSemanticContexts() {
+      writeValue(_semanticContexts.size());
+      for (auto &context : _semanticContexts) {
+        if (context == SemanticContext::NONE) {
+          writeValue(SEMANTIC_NONE);
+        } else if (is<SemanticContext::Predicate>(context)) {
+          const SemanticContext::Predicate *predicate = static_cast<const SemanticContext::Predicate *>(context.get());
+          writeValue(SEMANTIC_PREDICATE);
+          writeSize(predicate->ruleIndex);
+          writeSize(predicate->predIndex);
+          writeValue(predicate->isCtxDependent ? 1 : 0);
+        } else if (is<SemanticContext::PrecedencePredicate>(context)) {
+          writeValue(SEMANTIC_PRECEDENCE);
+          writeSize(static_cast<size_t>(static_cast<const SemanticContext::PrecedencePredicate *>(context.get())->precedence));
+        } else {
+          writeValue(is<SemanticContext::AND>(context) ? SEMANTIC_AND : SEMANTIC_OR);
+          std::vector<Ref<SemanticContext>> operands = std::static_pointer_cast<SemanticContext::Operator>(context)->getOperands();
+          writeValue(operands.size());
+          for (auto &operand : operands) {
+            writeValue(_semanticContextIndex[operand.get()]);
+          }
+        }
+      }
+    }
+
+    void writePredictionContexts() {
+      writeValue(_predictionContexts.size());
+      for (auto &context : _predictionContexts) {
+        if (context == PredictionContext::EMPTY) {
+          writeValue(CONTEXT_EMPTY);
+          continue;
+        }
+
+        if (is<ArrayPredictionContext>(context)) {
+          writeValue(CONTEXT_ARRAY);
+          writeValue(context->size());
+        } else {
+          writeValue(CONTEXT_SINGLETON);
+        }
+
+        for (size_t i = 0; i < context->size(); ++i) {
+          Ref<PredictionContext> parent = context->getParent(i);
+          writeValue(parent == nullptr ? 0 : _predictionContextIndex[parent.get()]);
+          writeSize(context->getReturnState(i));
+        }
+      }
+    }
+
+    void writeDFA(const DFA &dfa, const std::vector<DFAState *> &states) {
+      std::unordered_map<const DFAState *, uint64_t> stateIndex;
+      for (size_t i = 0; i < states.size(); ++i) {
+        stateIndex[states[i]] = FIRST_STATE + i;
+      }
+
+      writeValue(states.size());
+      for (DFAState *state : states) {
+        writeState(state);
+      }
+
+      writeValue(dfa.isPrecedenceDfa() ? 1 : 0);
+      if (dfa.isPrecedenceDfa()) {
+        writeEdges(dfa.s0, stateIndex);
+      } else {
+        writeValue(dfa.s0 == nullptr ? NO_STATE : stateIndex.at(dfa.s0));
+      }
+
+      for (DFAState *state : states) {
+        writeEdges(state, stateIndex);
+      }
+    }
+
+  private:
+    std::ostream &_output;
+
+    std::vector<Ref<SemanticContext>> _semanticContexts;
+    std::unordered_map<const SemanticContext *, uint64_t> _semanticContextIndex;
+    std::vector<Ref<PredictionContext>> _predictionContexts;
+    std::unordered_map<const PredictionContext *, uint64_t> _predictionContextIndex;
+
+    void writeState(DFAState *state) {
+      writeValue(static_cast<uint64_t>(state->stateNumber));
+      writeValue((state->isAcceptState ? 1 : 0) | (state->requiresFullContext ? 2 : 0));
+      writeSize(state->prediction);
+
+      ATNConfigSet *configs = state->configs.get();
+      writeValue(configs->fullCtx ? 1 : 0);
+      writeSize(configs->uniqueAlt);
+      writeValue(configs->conflictingAlts.count());
+      for (size_t alt = configs->conflictingAlts.nextSetBit(0); alt != INVALID_INDEX;
+           alt = configs->conflictingAlts.nextSetBit(alt + 1)) {
+        writeValue(alt);
+      }
+      writeValue(configs->hasSemanticContext ? 1 : 0);
+      writeValue(configs->dipsIntoOuterContext ? 1 : 0);
+
+      writeValue(configs->size());
+      for (size_t i = 0; i < configs->size(); ++i) {
+        Ref<ATNConfig> config = configs->get(i);
+        writeValue(config->state->stateNumber);
+        writeSize(config->alt);
+        writeValue(add(config->context));
+        writeValue(add(config->semanticContext));
+        writeSize(config->reachesIntoOuterContext);
+      }
+
+      writeValue(state->predicates.size());
+      for (auto *prediction : state->predicates) {
+        writeValue(add(prediction->pred));
+        writeSize(static_cast<size_t>(prediction->alt));
+      }
+    }
+
+    void writeEdges(DFAState *state, const std::unordered_map<const DFAState *, uint64_t> &stateIndex) {
+      // Sorted, to get the same output for the same DFA.
+      std::map<size_t, DFAState *> edges = state->getEdges();
+      writeValue(edges.size());
+      for (auto &edge : edges) {
+        writeSize(edge.first);
+        if (edge.second == ATNSimulator::ERROR.get()) {
+          writeValue(ERROR_STATE);
+        } else {
+          auto iterator = stateIndex.find(edge.second);
+          if (iterator == stateIndex.end()) {
+            throw IllegalStateException("DFA edge to a state which is not part of the DFA.");
+          }
+          writeValue(iterator->second);
+        }
+      }
+    }
+  };
+
+
+
+  IllegalArgumentException invalidSnapshot(const std::string &reason) {
+    return IllegalArgumentException("Invalid DFA snapshot: " + reason + ".");
+  }
+
+  class SnapshotReader {
+  public:
+    SnapshotReader(std::istream &input, const ATN &atn) : _input(input), _atn(atn) {
+    }
+
+    uint64_t readValue() {
+      uint64_t value = 0;
+      for (size_t shift = 0; shift < 64; shift += 7) {
+        int byte = _input.get();
+        if (byte == std::char_traits<char>::eof()) {
+          throw invalidSnapshot("unexpected end of data");
+        }
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+          return value;
+        }
+      }
+      throw invalidSnapshot("invalid number");
+    }
+
+    size_t readSize() {
+      uint64_t value = readValue();
+      int64_t signedValue = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+      return static_cast<size_t>(static_cast<ssize_t>(signedValue));
+    }
+
+    // Reads a value, which must be less than the given limit.
+    size_t readIndex(size_t limit) {
+      uint64_t value = readValue();
+      if (value >= limit) {
+        throw invalidSnapshot("index out of range");
+      }
+      return static_cast<size_t>(value);
+    }
+
+    // Counts are used to reserve memory, so they are limited to catch garbage early.
+    size_t readCount() {
+      return readIndex(std::numeric_limits<int32_t>::max());
+    }
+
+    void readSemanticContexts() {
+      size_t count = readCount();
+      _semanticContexts.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        uint64_t type = readValue();
+        switch (type) {
+          case SEMANTIC_NONE:
+            _semanticContexts.push_back(SemanticContext::NONE);
+            break;
+
+          case SEMANTIC_PREDICATE: {
+            size_t ruleIndex = readSize();
+            size_t predIndex = readSize();
+            bool isCtxDependent = readValue() != 0;
+            _semanticContexts.push_back(std::make_shared<SemanticContext::Predicate>(ruleIndex, predIndex, isCtxDependent));
+            break;
+          }
+
+          case SEMANTIC_PRECEDENCE:
+            _semanticContexts.push_back(std::make_shared<SemanticContext::PrecedencePredicate>(static_cast<int>(readSize())));
+            break;
+
+          case SEMANTIC_AND:
+          case SEMANTIC_OR: {
+            std::vector<Ref<SemanticContext>> operands(readCount());
+            if (operands.empty()) {
+              throw invalidSnapshot("semantic context operator without operands");
+            }
+            for (auto &operand : operands) {
+              operand = readSemanticContext();
+            }
+
+            // The operands are taken over as they are (also their order), instead of combining them again.
+            if (type == SEMANTIC_AND) {
+              _semanticContexts.push_back(std::make_shared<SemanticContext::AND>(std::move(operands)));
+            } else {
+              _semanticContexts.push_back(std::make_shared<SemanticContext::OR>(std::move(operands)));
+            }
+            break;
+          }
+
+          default:
+            throw invalidSnapshot("unknown semantic context type");
+        }
+      }
+    }
+
+    void readPredictionContexts() {
+      size_t count = readCount();
+      _predictionContexts.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        switch (readValue()) {
+          case CONTEXT_EMPTY:
+            _predictionContexts.push_back(PredictionContext::EMPTY);
+            break;
+
+          case CONTEXT_SINGLETON: {
+            Ref<PredictionContext> parent;
+            size_t returnState;
+            readPredictionContextEntry(parent, returnState);
+            _predictionContexts.push_back(SingletonPredictionContext::create(parent, returnState));
+            break;
+          }
+
+          case CONTEXT_ARRAY: {
+            size_t size = readCount();
+            if (size == 0) {
+              throw invalidSnapshot("empty prediction context");
+            }
+
+            std::vector<Ref<PredictionContext>> parents(size);
+            std::vector<size_t> returnStates(size);
+            for (size_t j = 0; j < size; ++j) {
+              readPredictionContextEntry(parents[j], returnStates[j]);
+            }
+            _predictionContexts.push_back(std::make_shared<ArrayPredictionContext>(parents, returnStates));
+            break;
+          }
+
+          default:
+            throw invalidSnapshot("unknown prediction context type");
+        }
+      }
+    }
+
+    void readDFA(DFA &dfa) {
+      // Alternatives are numbered from 1.
+      size_t altLimit = dfa.atnStartState->transitions.size() + 1;
+      size_t count = readCount();
+      std::vector<DFAState *> states;
+      states.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        std::unique_ptr<DFAState> state = readState(altLimit);
+        if (!dfa.states.insert(state.get()).second) {
+          throw invalidSnapshot("duplicate DFA state");
+        }
+        states.push_back(state.release()); // Now owned by the DFA.
+      }
+
+      bool isPrecedenceDfa = readValue() != 0;
+      if (isPrecedenceDfa != dfa.isPrecedenceDfa()) {
+        throw invalidSnapshot("precedence DFA mismatch");
+      }
+
+      if (isPrecedenceDfa) {
+        readEdges(dfa.s0, states);
+      } else {
+        size_t index = readIndex(FIRST_STATE + states.size());
+        if (index == ERROR_STATE) {
+          throw invalidSnapshot("invalid start state");
+        }
+        dfa.s0 = index == NO_STATE ? nullptr : states[index - FIRST_STATE];
+      }
+
+      for (DFAState *state : states) {
+        readEdges(state, states);
+      }
+    }
+
+  private:
+    std::istream &_input;
+    const ATN &_atn;
+
+    std::vector<Ref<SemanticContext>> _semanticContexts;
+    std::vector<Ref<PredictionContext>> _predictionContexts;
+
+    Ref<SemanticContext> readSemanticContext() {
+      size_t index = readIndex(_semanticContexts.size() + 1);
+      if (index == 0) {
+        throw invalidSnapshot("missing semantic context");
+      }
+      return _semanticContexts[index - 1];
+    }
+
+    Ref<PredictionContext> readPredictionContext() {
+      size_t index = readIndex(_predictionContexts.size() + 1);
+      return index == 0 ? nullptr : _predictionContexts[index - 1];
+    }
+
+    void readPredictionContextEntry(Ref<PredictionContext> &parent, size_t &returnState) {
+      parent = readPredictionContext();
+      returnState = readSize();
+
+      // Only the empty context (or an array entry for it) has no parent.
+      if (parent == nullptr && returnState != PredictionContext::EMPTY_RETURN_STATE) {
+        throw invalidSnapshot("prediction context without parent");
+      }
+    }
+
+    std::unique_ptr<DFAState> readState(size_t altLimit) {
+      int stateNumber = static_cast<int>(readCount());
+      uint64_t flags = readValue();
+      size_t prediction = readSize();
+
+      std::unique_ptr<ATNConfigSet> configs(new ATNConfigSet(readValue() != 0));
+      configs->uniqueAlt = readSize();
+      size_t conflictCount = readCount();
+      for (size_t i = 0; i < conflictCount; ++i) {
+        configs->conflictingAlts.set(readIndex(altLimit));
+      }
+      bool hasSemanticContext = readValue() != 0;
+      bool dipsIntoOuterContext = readValue() != 0;
+
+      size_t configCount = readCount();
+      for (size_t i = 0; i < configCount; ++i) {
+        ATNState *state = _atn.states[readIndex(_atn.states.size())];
+        if (state == nullptr) {
+          throw invalidSnapshot("invalid ATN state");
+        }
+
+        size_t alt = readSize();
+        if (alt >= altLimit) {
+          throw invalidSnapshot("invalid alternative");
+        }
+        Ref<PredictionContext> context = readPredictionContext();
+        if (context == nullptr) {
+          throw invalidSnapshot("missing prediction context");
+        }
+
+        Ref<ATNConfig> config = std::make_shared<ATNConfig>(state, alt, context, readSemanticContext());
+        config->reachesIntoOuterContext = readSize();
+        configs->add(config);
+      }
+
+      configs->hasSemanticContext = hasSemanticContext;
+      configs->dipsIntoOuterContext = dipsIntoOuterContext;
+      configs->setReadonly(true);
+
+      std::unique_ptr<DFAState> state(new DFAState(std::move(configs)));
+      state->stateNumber = stateNumber;
+      state->isAcceptState = (flags & 1) != 0;
+      state->requiresFullContext = (flags & 2) != 0;
+      state->prediction = prediction;
+
+      size_t predicateCount = readCount();
+      for (size_t i = 0; i < predicateCount; ++i) {
+        Ref<SemanticContext> predicate = readSemanticContext();
+        int alt = static_cast<int>(readSize());
+        state->predicates.push_back(new DFAState::PredPrediction(predicate, alt));
+      }
+
+      return state;
+    }
+
+    void readEdges(DFAState *state, const std::vector<DFAState *> &states) {
+      size_t count = readCount();
+      for (size_t i = 0; i < count; ++i) {
+        size_t symbol = readSize();
+        size_t index = readIndex(FIRST_STATE + states.size());
+        if (index == NO_STATE) {
+          throw invalidSnapshot("invalid DFA edge");
+        }
+        state->setEdge(symbol, index == ERROR_STATE ? ATNSimulator::ERROR.get() : states[index - FIRST_STATE]);
+      }
+    }
+  };
+
+} // namespace
+
+void DFASnapshot::write(std::ostream &output, const ATN &atn, const std::vector<DFA> &decisionToDFA) {
+  if (decisionToDFA.size() != atn.decisionToState.size()) {
+    throw IllegalArgumentException("The DFAs don't belong to the given ATN.");
+  }
+
+  // All contexts are collected first, as they are written before the DFAs.
+  SnapshotWriter writer(output);
+  std::vector<std::vector<DFAState *>> states;
+  for (auto &dfa : decisionToDFA) {
+    states.push_back(dfa.getStates());
+    for (DFAState *state : states.back()) {
+      for (size_t i = 0; i < state->configs->size(); ++i) {
+        Ref<ATNConfig> config = state->configs->get(i);
+        writer.add(config->context);
+        writer.add(config->semanticContext);
+      }
+      for (auto *prediction : state->predicates) {
+        writer.add(prediction->pred);
+      }
+    }
+  }
+
+  output.write(MAGIC, sizeof(MAGIC));
+  writer.writeValue(VERSION);
+  writer.writeValue(computeChecksum(atn));
+  writer.writeValue(atn.states.size());
+  writer.writeValue(decisionToDFA.size());
+
+  writer.writeSemanticContexts();
+  writer.writePredictionContexts();
+  for (size_t i = 0; i < decisionToDFA.size(); ++i) {
+    writer.writeDFA(decisionToDFA[i], states[i]);
+  }
+}
+
+void DFASnapshot::read(std::istream &input, const ATN &atn, std::vector<DFA> &decisionToDFA) {
+  if (decisionToDFA.size() != atn.decisionToState.size()) {
+    throw IllegalArgumentException("The DFAs don't belong to the given ATN.");
+  }
+
+  char magic[sizeof(MAGIC)];
+  if (!input.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+    throw invalidSnapshot("unknown format");
+  }
+
+  SnapshotReader reader(input, atn);
+  if (reader.readValue() != VERSION) {
+    throw invalidSnapshot("unsupported version");
+  }
+
+  if (reader.readValue() != computeChecksum(atn) || reader.readValue() != atn.states.size()
+      || reader.readValue() != atn.decisionToState.size()) {
+    throw IllegalArgumentException("The DFA snapshot was not created for the given ATN.");
+  }
+
+  reader.readSemanticContexts();
+  reader.readPredictionContexts();
+
+  // Everything is loaded into new DFAs first, so the given ones stay untouched on error.
+  std::vector<DFA> dfas;
+  dfas.reserve(decisionToDFA.size());
+  for (size_t i = 0; i < decisionToDFA.size(); ++i) {
+    dfas.push_back(DFA(atn.getDecisionState(i), i));
+    reader.readDFA(dfas.back());
+  }
+
+  decisionToDFA.swap(dfas);
+}
@@ -0,0 +1,34 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "dfa/DFA.h"
+
+namespace antlr4 {
+namespace dfa {
+
+  /// Stores the DFAs of a parser in a binary stream and restores them from there.
+  ///
+  /// The DFA cache of a parser is built up lazily while parsing, which makes the first parse runs in a process
+  /// (and the first use of each decision) much slower than later ones. A snapshot taken after parsing a
+  /// representative corpus (e.g. with the DFA trainer in the tools folder) can be loaded at startup instead.
+  /// All DFA states are stored with their ATN configurations, so loaded DFAs can grow further as usual.
+  ///
+  /// A snapshot is bound to the ATN it was taken from (i.e. to one version of a grammar), which is verified
+  /// when reading it. Neither function may be called while a parser is using the DFAs.
+  class ANTLR4CPP_PUBLIC DFASnapshot {
+  public:
+    /// Writes the DFAs of all decisions in the given ATN. The stream must be opened in binary mode.
+    static void write(std::ostream &output, const atn::ATN &atn, const std::vector<DFA> &decisionToDFA);
+
+    /// Replaces the content of the given DFAs with that of a snapshot. The stream must be opened in binary mode.
+    /// Throws an IllegalArgumentException if the snapshot is invalid or was not taken from the given ATN. The
+    /// DFAs are not modified in this case.
+    static void read(std::istream &input, const atn::ATN &atn, std::vector<DFA> &decisionToDFA);
+  };
+
+} // namespace dfa
+} // namespace antlr4
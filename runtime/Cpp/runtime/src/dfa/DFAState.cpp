@@ -6,7 +6,7 @@
 #include "atn/ATNConfigSet.h"
 #include "atn/SemanticContext.h"
 #include "atn/ATNConfig.h"
-#include "misc/MurmurHash.h"
+#include "misc/FastHash.h"
 
 #include "dfa/DFAState.h"
 
@@ -45,6 +45,13 @@ DFAState::~DFAState() {
   for (auto *predicate : predicates) {
     delete predicate;
   }
+
+  EdgeBlock *block = _edgeBlocks.load(std::memory_order_relaxed);
+  while (block != nullptr) {
+    EdgeBlock *next = block->next.load(std::memory_order_relaxed);
+    delete block;
+    block = next;
+  }
 }
 
 std::set<size_t> DFAState::getAltSet() {
@@ -58,9 +65,9 @@ std::set<size_t> DFAState::getAltSet() {
 }
 
 size_t DFAState::hashCode() const {
-  size_t hash = misc::MurmurHash::initialize(7);
-  hash = misc::MurmurHash::update(hash, configs->hashCode());
-  hash = misc::MurmurHash::finish(hash, 1);
+  size_t hash = misc::HashPolicy::initialize(7);
+  hash = misc::HashPolicy::update(hash, configs->hashCode());
+  hash = misc::HashPolicy::finish(hash, 1);
   return hash;
 }
 
@@ -73,6 +80,53 @@ bool DFAState::operator == (const DFAState &o) const {
   return *configs == *o.configs;
 }
 
+void DFAState::setEdge(size_t symbol, DFAState *target) {
+  size_t index = symbol + 1; // EOF maps to 0.
+  size_t start = 0;
+  size_t size = 32;
+  while (index - start >= size) {
+    start += size;
+    size *= 2;
+  }
+
+  // Readers see the chain with or without a new block, both are consistent.
+  std::atomic<EdgeBlock *> *link = &_edgeBlocks;
+  EdgeBlock *block = link->load(std::memory_order_relaxed);
+  while (block != nullptr && block->start < start) {
+    link = &block->next;
+    block = link->load(std::memory_order_relaxed);
+  }
+  if (block == nullptr || block->start != start) {
+    EdgeBlock *newBlock = new EdgeBlock(start, size);
+    newBlock->next.store(block, std::memory_order_relaxed);
+    link->store(newBlock, std::memory_order_release);
+    block = newBlock;
+  }
+
+  block->targets[index - start].store(target, std::memory_order_release);
+}
+
+std::map<size_t, DFAState *> DFAState::getEdges() const {
+  std::map<size_t, DFAState *> edges;
+  for (const EdgeBlock *block = _edgeBlocks.load(std::memory_order_acquire); block != nullptr;
+       block = block->next.load(std::memory_order_acquire)) {
+    for (size_t i = 0; i < block->size; ++i) {
+      DFAState *target = block->targets[i].load(std::memory_order_acquire);
+      if (target != nullptr) {
+        edges[block->start + i - 1] = target; // Index 0 is EOF, which wraps around to Token::EOF.
+      }
+    }
+  }
+  return edges;
+}
+
+DFAState::EdgeBlock::EdgeBlock(size_t start_, size_t size_)
+  : start(start_), size(size_), targets(new std::atomic<DFAState *>[size_]), next(nullptr) {
+  for (size_t i = 0; i < size; ++i) {
+    targets[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
 std::string DFAState::toString() {
   std::stringstream ss;
   ss << stateNumber;
@@ -97,4 +151,5 @@ void DFAState::InitializeInstanceFields() {
   isAcceptState = false;
   prediction = 0;
   requiresFullContext = false;
+  _edgeBlocks = nullptr;
 }
@@ -55,12 +55,6 @@ namespace dfa {
 
     std::unique_ptr<atn::ATNConfigSet> configs;
 
-    /// {@code edges[symbol]} points to target of symbol. Shift up by 1 so (-1)
-    ///  <seealso cref="Token#EOF"/> maps to {@code edges[0]}.
-    // ml: this is a sparse list, so we use a map instead of a vector.
-    //     Watch out: we no longer have the -1 offset, as it isn't needed anymore.
-    std::unordered_map<size_t, DFAState *> edges;
-
     bool isAcceptState;
 
     /// if accept state, what ttype do we match or alt do we predict?
@@ -93,6 +87,19 @@ namespace dfa {
     /// </summary>
     std::vector<PredPrediction *> predicates;
 
+    /// A full context (LL) prediction made in a state which requires full context. It is only valid for the
+    /// same stack of outer rule invocations and the same input.
+    struct FullContextPrediction {
+      size_t stackHash;
+      std::vector<size_t> stack; // The invoking states of the outer context, innermost first.
+      std::vector<size_t> lookahead; // The token types the prediction has read, from the start of the decision.
+      size_t prediction;
+    };
+
+    /// Full context predictions cached by the ParserATNSimulator (if enabled there, see
+    /// ParserATNSimulator::setFullContextCacheLimit). Guarded by the DFA state lock.
+    std::vector<FullContextPrediction> fullContextPredictions;
+
     /// Map a predicate to a predicted alternative.
     DFAState();
     DFAState(int state);
@@ -122,6 +129,29 @@ namespace dfa {
 
     virtual std::string toString();
 
+    /// Returns the target of the edge for the given symbol (a token type, Token::EOF, a character or a
+    /// precedence), or null if there is none (yet). This can be read without holding the edge lock, as the
+    /// edge blocks are never moved or freed while the state lives, and their entries and links are set
+    /// atomically.
+    DFAState* getEdge(size_t symbol) const {
+      size_t index = symbol + 1; // EOF maps to 0.
+      const EdgeBlock *block = _edgeBlocks.load(std::memory_order_acquire);
+      while (block != nullptr && index >= block->start) {
+        if (index - block->start < block->size) {
+          return block->targets[index - block->start].load(std::memory_order_acquire);
+        }
+        block = block->next.load(std::memory_order_acquire);
+      }
+      return nullptr;
+    }
+
+    /// Adds or replaces the edge for the given symbol. The caller must hold the edge write lock.
+    void setEdge(size_t symbol, DFAState *target);
+
+    /// All edges of this state, ordered by symbol (so Token::EOF comes last). Meant for serialization and
+    /// debugging, use getEdge() for lookups.
+    std::map<size_t, DFAState *> getEdges() const;
+
     struct Hasher
     {
       size_t operator()(DFAState *k) const {
@@ -137,6 +167,20 @@ namespace dfa {
     };
 
   private:
+    /// A part of the dense edge table. Block k covers 2^k * 32 symbols, following those of block k - 1, so
+    /// the table grows without ever copying or replacing a block. Only blocks which have edges are allocated.
+    struct EdgeBlock {
+      EdgeBlock(size_t start, size_t size);
+
+      const size_t start;
+      const size_t size;
+      std::unique_ptr<std::atomic<DFAState *>[]> targets;
+      std::atomic<EdgeBlock *> next;
+    };
+
+    /// The edge blocks in ascending order of their symbols. They are owned by the state.
+    std::atomic<EdgeBlock *> _edgeBlocks;
+
     void InitializeInstanceFields();
   };
 
@@ -0,0 +1,127 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "misc/MurmurHash.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+  #include <intrin.h>
+#endif
+
+namespace antlr4 {
+namespace misc {
+
+  /// A hash function in the style of wyhash, with the same interface as MurmurHash.
+  ///
+  /// Each step folds the 128 bit product of two 64 bit words, which mixes much better per operation than the
+  /// MurmurHash rounds, so two values can be added to the hash with a single multiplication (see the pair
+  /// version of update()). All functions are inlined, which matters for the many small hashes computed during
+  /// ATN simulation (configs, prediction contexts, semantic contexts).
+  ///
+  /// The values are only meant for in-memory hashing and are not stable across platforms (32 vs. 64 bit).
+  class ANTLR4CPP_PUBLIC FastHash {
+  private:
+#if __cplusplus >= 201703L
+    static constexpr size_t DEFAULT_SEED = 0;
+#else
+    enum : size_t {
+      DEFAULT_SEED = 0,
+    };
+#endif
+
+  public:
+    static size_t initialize() {
+      return initialize(DEFAULT_SEED);
+    }
+
+    static size_t initialize(size_t seed) {
+      return seed;
+    }
+
+    /// Update the intermediate hash value for the next input value.
+    static size_t update(size_t hash, size_t value) {
+      return fold(mix(hash ^ SECRET0, value ^ SECRET1));
+    }
+
+    /// Update the intermediate hash value for the next two input values. This costs the same as a single
+    /// update(), so prefer it for hashing fields or arrays in pairs. It counts as two entries for finish().
+    static size_t update(size_t hash, size_t value1, size_t value2) {
+      return fold(mix(hash ^ value1 ^ SECRET0, value2 ^ SECRET1));
+    }
+
+    template <class T>
+    static size_t update(size_t hash, Ref<T> const& value) {
+      return update(hash, value != nullptr ? value->hashCode() : 0);
+    }
+
+    template <class T>
+    static size_t update(size_t hash, T *value) {
+      return update(hash, value != nullptr ? value->hashCode() : 0);
+    }
+
+    /// Apply the final computation steps to the intermediate hash value.
+    /// <param name="entryCount"> the number of values added with update() before calling finish() </param>
+    static size_t finish(size_t hash, size_t entryCount) {
+      return fold(mix(hash ^ SECRET2, entryCount ^ SECRET3));
+    }
+
+    /// Computes the hash code of an array of objects, two elements per step.
+    template<typename T>
+    static size_t hashCode(const std::vector<Ref<T>> &data, size_t seed) {
+      size_t hash = initialize(seed);
+      size_t i = 0;
+      for (; i + 1 < data.size(); i += 2) {
+        hash = update(hash, data[i]->hashCode(), data[i + 1]->hashCode());
+      }
+      if (i < data.size()) {
+        hash = update(hash, data[i]->hashCode());
+      }
+
+      return finish(hash, data.size());
+    }
+
+  private:
+    static const uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+    static const uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+    static const uint64_t SECRET2 = 0x8ebc6af09c88c6e3ULL;
+    static const uint64_t SECRET3 = 0x589965cc75374cc3ULL;
+
+    // Multiplies both values to a 128 bit result and folds it (xor of the high and low part) to 64 bits.
+    static uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+      __uint128_t r = static_cast<__uint128_t>(a) * b;
+      return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+      uint64_t high;
+      uint64_t low = _umul128(a, b, &high);
+      return low ^ high;
+#else
+      uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+      uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+      uint64_t carry = t < rl ? 1 : 0;
+      uint64_t low = t + (rm1 << 32);
+      carry += low < t ? 1 : 0;
+      uint64_t high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+      return low ^ high;
+#endif
+    }
+
+    static size_t fold(uint64_t value) {
+      return sizeof(size_t) < sizeof(uint64_t) ? static_cast<size_t>(value ^ (value >> 32)) : static_cast<size_t>(value);
+    }
+  };
+
+  /// The hash function used for the in-memory hashing in the ATN simulators (configs, config sets, prediction
+  /// and semantic contexts). Define USE_MURMURHASH_INSTEAD_OF_FASTHASH to switch back to MurmurHash, e.g. for
+  /// comparisons. Values which are persisted (like the ATN checksum of DFA snapshots) always use MurmurHash.
+#ifdef USE_MURMURHASH_INSTEAD_OF_FASTHASH
+  typedef MurmurHash HashPolicy;
+#else
+  typedef FastHash HashPolicy;
+#endif
+
+} // namespace misc
+} // namespace antlr4
@@ -3,122 +3,345 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "atn/ATN.h"
 #include "atn/ATNDeserializer.h"
+#include "Exceptions.h"
 #include "Vocabulary.h"
+#include "support/CPPUtils.h"
 
 #include "misc/InterpreterDataReader.h"
 
+using namespace antlr4;
 using namespace antlr4::dfa;
 using namespace antlr4::atn;
 using namespace antlr4::misc;
 
-InterpreterData::InterpreterData(std::vector<std::string> const& literalNames, std::vector<std::string> const& symbolicNames)
-: vocabulary(literalNames, symbolicNames) {
-}
-
-InterpreterData InterpreterDataReader::parseFile(std::string const& fileName) {
-  // The structure of the data file is very simple. Everything is line based with empty lines
-  // separating the different parts. For lexers the layout is:
-  // token literal names:
-  // ...
-  //
-  // token symbolic names:
-  // ...
-  //
-  // rule names:
-  // ...
-  //
-  // channel names:
-  // ...
-  //
-  // mode names:
-  // ...
-  //
-  // atn:
-  // <a single line with comma separated int values> enclosed in a pair of squared brackets.
-  //
-  // Data for a parser does not contain channel and mode names.
+namespace {
 
-  std::ifstream input(fileName);
-  if (!input.good())
-    return {};
+  const char MAGIC[] = { 'A', 'I', 'N', 'T' };
+  const uint32_t VERSION = 1;
 
-  std::vector<std::string> literalNames;
-  std::vector<std::string> symbolicNames;
+  // Set in the flags if the data contains channel and mode names (i.e. is for a lexer).
+  const uint32_t HAS_CHANNELS_AND_MODES = 1;
 
-  std::string line;
+  // The content of an interpreter data file, before the ATN is deserialized.
+  struct RawInterpreterData {
+    std::vector<std::string> literalNames;
+    std::vector<std::string> symbolicNames;
+    std::vector<std::string> ruleNames;
+    std::vector<std::string> channels;
+    std::vector<std::string> modes;
+    bool hasChannelsAndModes = false;
+    std::vector<uint16_t> serializedATN;
 
-  std::getline(input, line, '\n');
-  assert(line == "token literal names:");
-  while (true) {
-    std::getline(input, line, '\n');
-    if (line.empty())
-      break;
+    InterpreterData toInterpreterData() const {
+      InterpreterData result(literalNames, symbolicNames);
+      result.ruleNames = ruleNames;
+      result.channels = channels;
+      result.modes = modes;
 
-    literalNames.push_back(line == "null" ? "" : line);
+      ATNDeserializer deserializer;
+      result.atn = deserializer.deserialize(serializedATN);
+      return result;
+    }
   };
 
-  std::getline(input, line, '\n');
-  assert(line == "token symbolic names:");
-  while (true) {
-    std::getline(input, line, '\n');
-    if (line.empty())
-      break;
+  void readText(std::istream &input, RawInterpreterData &data) {
+    // The structure of the data file is very simple. Everything is line based with empty lines
+    // separating the different parts. For lexers the layout is:
+    // token literal names:
+    // ...
+    //
+    // token symbolic names:
+    // ...
+    //
+    // rule names:
+    // ...
+    //
+    // channel names:
+    // ...
+    //
+    // mode names:
+    // ...
+    //
+    // atn:
+    // <a single line with comma separated int values> enclosed in a pair of squared brackets.
+    //
+    // Data for a parser does not contain channel and mode names.
 
-    symbolicNames.push_back(line == "null" ? "" : line);
-  };
-  InterpreterData result(literalNames, symbolicNames);
+    std::string line;
 
-  std::getline(input, line, '\n');
-  assert(line == "rule names:");
-  while (true) {
     std::getline(input, line, '\n');
-    if (line.empty())
-      break;
+    assert(line == "token literal names:");
+    while (true) {
+      std::getline(input, line, '\n');
+      if (line.empty())
+        break;
 
-    result.ruleNames.push_back(line);
-  };
+      data.literalNames.push_back(line == "null" ? "" : line);
+    };
 
-  std::getline(input, line, '\n');
-  if (line == "channel names:") {
+    std::getline(input, line, '\n');
+    assert(line == "token symbolic names:");
     while (true) {
       std::getline(input, line, '\n');
       if (line.empty())
         break;
 
-      result.channels.push_back(line);
+      data.symbolicNames.push_back(line == "null" ? "" : line);
     };
 
     std::getline(input, line, '\n');
-    assert(line == "mode names:");
+    assert(line == "rule names:");
     while (true) {
       std::getline(input, line, '\n');
       if (line.empty())
         break;
 
-      result.modes.push_back(line);
+      data.ruleNames.push_back(line);
     };
+
+    std::getline(input, line, '\n');
+    if (line == "channel names:") {
+      data.hasChannelsAndModes = true;
+      while (true) {
+        std::getline(input, line, '\n');
+        if (line.empty())
+          break;
+
+        data.channels.push_back(line);
+      };
+
+      std::getline(input, line, '\n');
+      assert(line == "mode names:");
+      while (true) {
+        std::getline(input, line, '\n');
+        if (line.empty())
+          break;
+
+        data.modes.push_back(line);
+      };
+
+      std::getline(input, line, '\n');
+    }
+
+    // Parser data has no channel and mode names, so the line read above is already the atn header.
+    assert(line == "atn:");
+    std::getline(input, line, '\n');
+    std::stringstream tokenizer(line);
+    std::string value;
+    while (tokenizer.good()) {
+      std::getline(tokenizer, value, ',');
+      unsigned long number;
+      if (value[0] == '[')
+        number = std::strtoul(&value[1], nullptr, 10);
+      else
+        number = std::strtoul(value.c_str(), nullptr, 10);
+      data.serializedATN.push_back(static_cast<uint16_t>(number));
+    }
   }
 
-  std::vector<uint16_t> serializedATN;
-
-  std::getline(input, line, '\n');
-  assert(line == "atn:");
-  std::getline(input, line, '\n');
-  std::stringstream tokenizer(line);
-  std::string value;
-  while (tokenizer.good()) {
-    std::getline(tokenizer, value, ',');
-    unsigned long number;
-    if (value[0] == '[')
-      number = std::strtoul(&value[1], nullptr, 10);
-    else
-      number = std::strtoul(value.c_str(), nullptr, 10);
-    serializedATN.push_back(static_cast<uint16_t>(number));
+  // All numbers in the binary format are stored as little endian 32 bit values (16 bit for the ATN).
+  class BinaryWriter {
+  public:
+    BinaryWriter(std::ostream &output) : _output(output) {
+    }
+
+    void writeUInt32(uint32_t value) {
+      for (size_t i = 0; i < 4; ++i) {
+        _output.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+      }
+    }
+
+    void writeStrings(const std::vector<std::string> &strings) {
+      writeUInt32(static_cast<uint32_t>(strings.size()));
+      for (const std::string &string : strings) {
+        writeUInt32(static_cast<uint32_t>(string.size()));
+        _output.write(string.data(), static_cast<std::streamsize>(string.size()));
+      }
+    }
+
+    void writeATN(const std::vector<uint16_t> &serializedATN) {
+      writeUInt32(static_cast<uint32_t>(serializedATN.size()));
+      for (uint16_t value : serializedATN) {
+        _output.put(static_cast<char>(value & 0xFF));
+        _output.put(static_cast<char>(value >> 8));
+      }
+    }
+
+  private:
+    std::ostream &_output;
+  };
+
+  class BinaryReader {
+  public:
+    BinaryReader(const char *data, size_t size) : _data(reinterpret_cast<const uint8_t *>(data)), _size(size), _position(0) {
+    }
+
+    uint32_t readUInt32() {
+      ensureAvailable(4);
+      uint32_t result = 0;
+      for (size_t i = 0; i < 4; ++i) {
+        result |= static_cast<uint32_t>(_data[_position++]) << (8 * i);
+      }
+      return result;
+    }
+
+    void readStrings(std::vector<std::string> &strings) {
+      uint32_t count = readUInt32();
+      // Each string takes at least 4 bytes, which limits the count (and the memory reserved for it).
+      ensureAvailable(count, 4);
+      strings.reserve(count);
+      for (uint32_t i = 0; i < count; ++i) {
+        uint32_t length = readUInt32();
+        ensureAvailable(length);
+        strings.emplace_back(reinterpret_cast<const char *>(_data + _position), length);
+        _position += length;
+      }
+    }
+
+    void readATN(std::vector<uint16_t> &serializedATN) {
+      uint32_t count = readUInt32();
+      ensureAvailable(count, 2);
+      serializedATN.resize(count);
+      for (uint32_t i = 0; i < count; ++i) {
+        serializedATN[i] = static_cast<uint16_t>(_data[_position] | (_data[_position + 1] << 8));
+        _position += 2;
+      }
+    }
+
+    bool atEnd() const {
+      return _position == _size;
+    }
+
+  private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _position;
+
+    void ensureAvailable(size_t count) {
+      if (count > _size - _position) {
+        throw IllegalArgumentException("Invalid interpreter data: unexpected end of data.");
+      }
+    }
+
+    // Checks for count elements of elementSize bytes each. Divides instead of multiplying, as the product
+    // of a 32 bit count and the element size can overflow size_t on 32 bit platforms.
+    void ensureAvailable(uint32_t count, size_t elementSize) {
+      if (count > (_size - _position) / elementSize) {
+        throw IllegalArgumentException("Invalid interpreter data: unexpected end of data.");
+      }
+    }
+  };
+
+  void writeBinary(std::ostream &output, const RawInterpreterData &data) {
+    BinaryWriter writer(output);
+    output.write(MAGIC, sizeof(MAGIC));
+    writer.writeUInt32(VERSION);
+    writer.writeUInt32(data.hasChannelsAndModes ? HAS_CHANNELS_AND_MODES : 0);
+    writer.writeStrings(data.literalNames);
+    writer.writeStrings(data.symbolicNames);
+    writer.writeStrings(data.ruleNames);
+    if (data.hasChannelsAndModes) {
+      writer.writeStrings(data.channels);
+      writer.writeStrings(data.modes);
+    }
+    writer.writeATN(data.serializedATN);
+  }
+
+  void readBinary(const char *bytes, size_t size, RawInterpreterData &data) {
+    if (size < sizeof(MAGIC) || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), bytes)) {
+      throw IllegalArgumentException("Invalid interpreter data: not a binary interpreter data file.");
+    }
+
+    BinaryReader reader(bytes + sizeof(MAGIC), size - sizeof(MAGIC));
+    uint32_t version = reader.readUInt32();
+    if (version != VERSION) {
+      throw IllegalArgumentException("Invalid interpreter data: unsupported version " + std::to_string(version) + ".");
+    }
+
+    data.hasChannelsAndModes = (reader.readUInt32() & HAS_CHANNELS_AND_MODES) != 0;
+    reader.readStrings(data.literalNames);
+    reader.readStrings(data.symbolicNames);
+    reader.readStrings(data.ruleNames);
+    if (data.hasChannelsAndModes) {
+      reader.readStrings(data.channels);
+      reader.readStrings(data.modes);
+    }
+    reader.readATN(data.serializedATN);
+
+    if (!reader.atEnd()) {
+      throw IllegalArgumentException("Invalid interpreter data: unexpected data after the ATN.");
+    }
   }
 
-  ATNDeserializer deserializer;
-  result.atn = deserializer.deserialize(serializedATN);
-  return result;
+}
+
+InterpreterData::InterpreterData(std::vector<std::string> const& literalNames, std::vector<std::string> const& symbolicNames)
+: vocabulary(literalNames, symbolicNames) {
+}
+
+InterpreterData InterpreterDataReader::parseFile(std::string const& fileName) {
+  std::ifstream input(fileName);
+  if (!input.good())
+    return {};
+
+  RawInterpreterData data;
+  readText(input, data);
+  return data.toInterpreterData();
+}
+
+InterpreterData InterpreterDataReader::parseBinary(const char *data, size_t size) {
+  RawInterpreterData rawData;
+  readBinary(data, size, rawData);
+  return rawData.toInterpreterData();
+}
+
+InterpreterData InterpreterDataReader::parseBinaryFile(std::string const& fileName) {
+#ifdef _WIN32
+  std::ifstream input(fileName, std::ios::binary);
+  if (!input.good())
+    return {};
+
+  std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  return parseBinary(content.data(), content.size());
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+    return {};
+
+  auto onExit = antlrcpp::finally([file] {
+    close(file);
+  });
+
+  struct stat info;
+  if (fstat(file, &info) != 0)
+    return {};
+
+  size_t size = static_cast<size_t>(info.st_size);
+  if (size == 0)
+    return parseBinary(nullptr, 0);
+
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  if (mapping == MAP_FAILED)
+    return {};
+
+  auto onUnmap = antlrcpp::finally([mapping, size] {
+    munmap(mapping, size);
+  });
+  return parseBinary(static_cast<const char *>(mapping), size);
+#endif
+}
+
+void InterpreterDataReader::convertToBinary(std::istream &input, std::ostream &output) {
+  RawInterpreterData data;
+  readText(input, data);
+  writeBinary(output, data);
 }
@@ -21,10 +21,26 @@ namespace misc {
     InterpreterData(std::vector<std::string> const& literalNames, std::vector<std::string> const& symbolicNames);
   };
 
-  // A class to read plain text interpreter data produced by ANTLR.
+  // A class to read plain text interpreter data produced by ANTLR, or the same data in a binary form.
+  //
+  // The binary form (see convertToBinary()) holds the names and the serialized ATN as length prefixed little endian
+  // values, so loading it is a single pass over the bytes (which may come from a memory mapped file) without any text
+  // parsing. The format is versioned and checked when reading.
   class ANTLR4CPP_PUBLIC InterpreterDataReader {
   public:
     static InterpreterData parseFile(std::string const& fileName);
+
+    /// Reads binary interpreter data from the given memory, which is only used during the call.
+    /// Throws an IllegalArgumentException if the data is not valid.
+    static InterpreterData parseBinary(const char *data, size_t size);
+
+    /// Reads binary interpreter data from a file, which is memory mapped where supported. Returns empty data if the
+    /// file cannot be read and throws an IllegalArgumentException if its content is not valid.
+    static InterpreterData parseBinaryFile(std::string const& fileName);
+
+    /// Converts plain text interpreter data (the content of an .interp file) into the binary form. The output stream
+    /// must be opened in binary mode.
+    static void convertToBinary(std::istream &input, std::ostream &output);
   };
 
 } // namespace atn
@@ -13,6 +13,13 @@
 using namespace antlr4;
 using namespace antlr4::misc;
 
+namespace {
+
+  // Sets with up to this many intervals are searched linearly, which is faster than a binary search for them.
+  const size_t LINEAR_SEARCH_LIMIT = 8;
+
+}
+
 IntervalSet const IntervalSet::COMPLETE_CHAR_SET = 
     IntervalSet::of(Lexer::MIN_CHAR_VALUE, Lexer::MAX_CHAR_VALUE);
 
@@ -21,11 +28,10 @@ IntervalSet const IntervalSet::EMPTY_SET;
 IntervalSet::IntervalSet() : _intervals() {
 }
 
-IntervalSet::IntervalSet(const IntervalSet &set) : IntervalSet() {
-  _intervals = set._intervals;
+IntervalSet::IntervalSet(const IntervalSet &set) : _intervals(set._intervals), _bitmap(set._bitmap) {
 }
 
-IntervalSet::IntervalSet(IntervalSet&& set) : IntervalSet(std::move(set._intervals)) {
+IntervalSet::IntervalSet(IntervalSet&& set) : _intervals(std::move(set._intervals)), _bitmap(std::move(set._bitmap)) {
 }
 
 IntervalSet::IntervalSet(std::vector<Interval>&& intervals) : _intervals(std::move(intervals)) {
@@ -33,11 +39,13 @@ IntervalSet::IntervalSet(std::vector<Interval>&& intervals) : _intervals(std::mo
 
 IntervalSet& IntervalSet::operator=(const IntervalSet& other) {
   _intervals = other._intervals;
+  _bitmap = other._bitmap;
   return *this;
 }
 
 IntervalSet& IntervalSet::operator=(IntervalSet&& other) {
   _intervals = move(other._intervals);
+  _bitmap = move(other._bitmap);
   return *this;
 }
 
@@ -51,6 +59,7 @@ IntervalSet IntervalSet::of(ssize_t a, ssize_t b) {
 
 void IntervalSet::clear() {
   _intervals.clear();
+  _bitmap.clear();
 }
 
 void IntervalSet::add(ssize_t el) {
@@ -66,48 +75,32 @@ void IntervalSet::add(const Interval &addition) {
     return;
   }
 
-  // find position in list
-  for (auto iterator = _intervals.begin(); iterator != _intervals.end(); ++iterator) {
-    Interval r = *iterator;
-    if (addition == r) {
-      return;
-    }
-
-    if (addition.adjacent(r) || !addition.disjoint(r)) {
-      // next to each other, make a single larger interval
-      Interval bigger = addition.Union(r);
-      *iterator = bigger;
-
-      // make sure we didn't just create an interval that
-      // should be merged with next interval in list
-      while (iterator + 1 != _intervals.end()) {
-        Interval next = *++iterator;
-        if (!bigger.adjacent(next) && bigger.disjoint(next)) {
-          break;
-        }
-
-        // if we bump up against or overlap next, merge
-        iterator = _intervals.erase(iterator);// remove this one
-        --iterator; // move backwards to what we just set
-        *iterator = bigger.Union(next); // set to 3 merged ones
-        // ml: no need to advance iterator, we do that in the next round anyway. ++iterator; // first call to next after previous duplicates the result
-      }
-      return;
-    }
+  _bitmap.clear();
 
-    if (addition.startsBeforeDisjoint(r)) {
-      // insert before r
-      //--iterator;
-      _intervals.insert(iterator, addition);
-      return;
-    }
+  // Sets are mostly built in ascending order, so check for an append first.
+  if (_intervals.empty() || addition.a > _intervals.back().b + 1) {
+    _intervals.push_back(addition);
+    return;
+  }
 
-    // if disjoint and after r, a future iteration will handle it
+  // All intervals from first to last (exclusive) overlap or are adjacent to the addition and are merged with it.
+  auto first = std::lower_bound(_intervals.begin(), _intervals.end(), addition,
+    [](const Interval &interval, const Interval &addition) {
+      return interval.b + 1 < addition.a;
+    });
+  auto last = std::upper_bound(first, _intervals.end(), addition,
+    [](const Interval &addition, const Interval &interval) {
+      return addition.b + 1 < interval.a;
+    });
+
+  if (first == last) {
+    _intervals.insert(first, addition);
+    return;
   }
 
-  // ok, must be after last interval (and disjoint from last interval)
-  // just add it
-  _intervals.push_back(addition);
+  first->a = std::min(first->a, addition.a);
+  first->b = std::max((last - 1)->b, addition.b);
+  _intervals.erase(first + 1, last);
 }
 
 IntervalSet IntervalSet::Or(const std::vector<IntervalSet> &sets) {
@@ -119,6 +112,16 @@ IntervalSet IntervalSet::Or(const std::vector<IntervalSet> &sets) {
 }
 
 IntervalSet& IntervalSet::addAll(const IntervalSet &set) {
+  if (&set == this) {
+    return *this;
+  }
+
+  if (_intervals.empty()) {
+    _intervals = set._intervals;
+    _bitmap.clear();
+    return *this;
+  }
+
   // walk set and add each interval
   for (auto const& interval : set._intervals) {
     add(interval);
@@ -126,8 +129,32 @@ IntervalSet& IntervalSet::addAll(const IntervalSet &set) {
   return *this;
 }
 
+IntervalSet& IntervalSet::removeAll(const IntervalSet &set) {
+  if (_intervals.empty() || set._intervals.empty()) {
+    return *this;
+  }
+
+  std::vector<Interval> result;
+  subtract(_intervals, set._intervals, result);
+  _intervals.swap(result);
+  _bitmap.clear();
+  return *this;
+}
+
+IntervalSet& IntervalSet::retainAll(const IntervalSet &set) {
+  if (&set == this) {
+    return *this;
+  }
+
+  std::vector<Interval> result;
+  intersect(_intervals, set._intervals, result);
+  _intervals.swap(result);
+  _bitmap.clear();
+  return *this;
+}
+
 IntervalSet IntervalSet::complement(ssize_t minElement, ssize_t maxElement) const {
-  return complement(IntervalSet::of(minElement, maxElement));
+  return subtract(IntervalSet::of(minElement, maxElement), *this);
 }
 
 IntervalSet IntervalSet::complement(const IntervalSet &vocabulary) const {
@@ -139,124 +166,21 @@ IntervalSet IntervalSet::subtract(const IntervalSet &other) const {
 }
 
 IntervalSet IntervalSet::subtract(const IntervalSet &left, const IntervalSet &right) {
-  if (left.isEmpty()) {
-    return IntervalSet();
-  }
-
-  if (right.isEmpty()) {
-    // right set has no elements; just return the copy of the current set
-    return left;
-  }
-
-  IntervalSet result(left);
-  size_t resultI = 0;
-  size_t rightI = 0;
-  while (resultI < result._intervals.size() && rightI < right._intervals.size()) {
-    Interval &resultInterval = result._intervals[resultI];
-    const Interval &rightInterval = right._intervals[rightI];
-
-    // operation: (resultInterval - rightInterval) and update indexes
-
-    if (rightInterval.b < resultInterval.a) {
-      rightI++;
-      continue;
-    }
-
-    if (rightInterval.a > resultInterval.b) {
-      resultI++;
-      continue;
-    }
-
-    Interval beforeCurrent;
-    Interval afterCurrent;
-    if (rightInterval.a > resultInterval.a) {
-      beforeCurrent = Interval(resultInterval.a, rightInterval.a - 1);
-    }
-
-    if (rightInterval.b < resultInterval.b) {
-      afterCurrent = Interval(rightInterval.b + 1, resultInterval.b);
-    }
-
-    if (beforeCurrent.a > -1) { // -1 is the default value
-      if (afterCurrent.a > -1) {
-        // split the current interval into two
-        result._intervals[resultI] = beforeCurrent;
-        result._intervals.insert(result._intervals.begin() + resultI + 1, afterCurrent);
-        resultI++;
-        rightI++;
-      } else {
-        // replace the current interval
-        result._intervals[resultI] = beforeCurrent;
-        resultI++;
-      }
-    } else {
-      if (afterCurrent.a > -1) {
-        // replace the current interval
-        result._intervals[resultI] = afterCurrent;
-        rightI++;
-      } else {
-        // remove the current interval (thus no need to increment resultI)
-        result._intervals.erase(result._intervals.begin() + resultI);
-      }
-    }
-  }
-
-  // If rightI reached right.intervals.size(), no more intervals to subtract from result.
-  // If resultI reached result.intervals.size(), we would be subtracting from an empty set.
-  // Either way, we are done.
+  IntervalSet result;
+  subtract(left._intervals, right._intervals, result._intervals);
   return result;
 }
 
 IntervalSet IntervalSet::Or(const IntervalSet &a) const {
   IntervalSet result;
-  result.addAll(*this);
+  result._intervals = _intervals;
   result.addAll(a);
   return result;
 }
 
 IntervalSet IntervalSet::And(const IntervalSet &other) const {
   IntervalSet intersection;
-  size_t i = 0;
-  size_t j = 0;
-
-  // iterate down both interval lists looking for nondisjoint intervals
-  while (i < _intervals.size() && j < other._intervals.size()) {
-    Interval mine = _intervals[i];
-    Interval theirs = other._intervals[j];
-
-    if (mine.startsBeforeDisjoint(theirs)) {
-      // move this iterator looking for interval that might overlap
-      i++;
-    } else if (theirs.startsBeforeDisjoint(mine)) {
-      // move other iterator looking for interval that might overlap
-      j++;
-    } else if (mine.properlyContains(theirs)) {
-      // overlap, add intersection, get next theirs
-      intersection.add(mine.intersection(theirs));
-      j++;
-    } else if (theirs.properlyContains(mine)) {
-      // overlap, add intersection, get next mine
-      intersection.add(mine.intersection(theirs));
-      i++;
-    } else if (!mine.disjoint(theirs)) {
-      // overlap, add intersection
-      intersection.add(mine.intersection(theirs));
-
-      // Move the iterator of lower range [a..b], but not
-      // the upper range as it may contain elements that will collide
-      // with the next iterator. So, if mine=[0..115] and
-      // theirs=[115..200], then intersection is 115 and move mine
-      // but not theirs as theirs may collide with the next range
-      // in thisIter.
-      // move both iterators to next ranges
-      if (mine.startsAfterNonDisjoint(theirs)) {
-        j++;
-      } else if (theirs.startsAfterNonDisjoint(mine)) {
-        i++;
-      }
-    }
-  }
-
+  intersect(_intervals, other._intervals, intersection._intervals);
   return intersection;
 }
 
@@ -265,24 +189,57 @@ bool IntervalSet::contains(size_t el) const {
 }
 
 bool IntervalSet::contains(ssize_t el) const {
-  if (_intervals.empty())
-    return false;
+  if (el >= 0 && static_cast<size_t>(el) < _bitmap.size() * 64) {
+    return (_bitmap[static_cast<size_t>(el) / 64] & (1ULL << (static_cast<size_t>(el) % 64))) != 0;
+  }
 
-  if (el < _intervals[0].a) // list is sorted and el is before first interval; not here
+  if (_intervals.size() <= LINEAR_SEARCH_LIMIT) {
+    for (const auto &interval : _intervals) {
+      if (el < interval.a) {
+        return false; // list is sorted and el is before this interval; not here
+      }
+      if (el <= interval.b) {
+        return true; // found in this interval
+      }
+    }
     return false;
+  }
 
-  for (const auto &interval : _intervals) {
-    if (el >= interval.a && el <= interval.b) {
-      return true; // found in this interval
-    }
+  // Find the last interval starting at or before el.
+  auto iterator = std::upper_bound(_intervals.begin(), _intervals.end(), el, [](ssize_t el, const Interval &interval) {
+    return el < interval.a;
+  });
+  if (iterator == _intervals.begin()) {
+    return false;
   }
-  return false;
+  return el <= (iterator - 1)->b;
 }
 
 bool IntervalSet::isEmpty() const {
   return _intervals.empty();
 }
 
+void IntervalSet::createBitmap(size_t limit) {
+  _bitmap.clear();
+  if (_intervals.empty() || _intervals.back().b < 0) {
+    return;
+  }
+
+  size_t wordCount = std::min((limit + 63) / 64, static_cast<size_t>(_intervals.back().b) / 64 + 1);
+  ssize_t end = static_cast<ssize_t>(wordCount * 64);
+  std::vector<uint64_t> bitmap(wordCount);
+  for (const auto &interval : _intervals) {
+    if (interval.a >= end) {
+      break;
+    }
+
+    for (ssize_t v = std::max(interval.a, static_cast<ssize_t>(0)); v <= std::min(interval.b, end - 1); ++v) {
+      bitmap[static_cast<size_t>(v) / 64] |= 1ULL << (static_cast<size_t>(v) % 64);
+    }
+  }
+  _bitmap.swap(bitmap);
+}
+
 ssize_t IntervalSet::getSingleElement() const {
   if (_intervals.size() == 1) {
     if (_intervals[0].a == _intervals[0].b) {
@@ -486,6 +443,7 @@ void IntervalSet::remove(size_t el) {
 }
 
 void IntervalSet::remove(ssize_t el) {
+  _bitmap.clear();
   for (size_t i = 0; i < _intervals.size(); ++i) {
     Interval &interval = _intervals[i];
     ssize_t a = interval.a;
@@ -519,3 +477,52 @@ void IntervalSet::remove(ssize_t el) {
     }
   }
 }
+
+void IntervalSet::subtract(const std::vector<Interval> &left, const std::vector<Interval> &right,
+                           std::vector<Interval> &result) {
+  result.reserve(left.size() + right.size());
+
+  // Walk both lists together. Each interval of left is cut by all intervals of right overlapping it.
+  size_t rightI = 0;
+  for (Interval current : left) {
+    while (rightI < right.size() && right[rightI].b < current.a) {
+      rightI++;
+    }
+
+    // An interval of right can overlap the next interval of left too, so rightI is not moved past it.
+    for (size_t i = rightI; i < right.size() && right[i].a <= current.b; ++i) {
+      if (right[i].a > current.a) {
+        result.push_back(Interval(current.a, right[i].a - 1));
+      }
+      current.a = right[i].b + 1;
+      if (current.a > current.b) {
+        break;
+      }
+    }
+
+    if (current.a <= current.b) {
+      result.push_back(current);
+    }
+  }
+}
+
+void IntervalSet::intersect(const std::vector<Interval> &left, const std::vector<Interval> &right,
+                            std::vector<Interval> &result) {
+  // Both lists are sorted, disjoint and not adjacent, so the intersections come out in order and don't need merging.
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left.size() && j < right.size()) {
+    ssize_t a = std::max(left[i].a, right[j].a);
+    ssize_t b = std::min(left[i].b, right[j].b);
+    if (a <= b) {
+      result.push_back(Interval(a, b));
+    }
+
+    // Move on with the interval which ends first, the other one may still overlap the next one.
+    if (left[i].b < right[j].b) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+}
@@ -22,16 +22,27 @@ namespace misc {
    * This class is able to represent sets containing any combination of values in
    * the range {@link Integer#MIN_VALUE} to {@link Integer#MAX_VALUE}
    * (inclusive).</p>
+   *
+   * <p>
+   * Membership tests use a binary search for sets with many intervals. Sets which are
+   * tested often (e.g. the sets of transitions) can additionally get a bitmap for their
+   * small elements (token types, ASCII characters), see {@link #createBitmap}.</p>
    */
   class ANTLR4CPP_PUBLIC IntervalSet {
   public:
     static IntervalSet const COMPLETE_CHAR_SET;
     static IntervalSet const EMPTY_SET;
 
+    /// The default number of elements covered by the bitmap of a set.
+    static constexpr size_t DEFAULT_BITMAP_LIMIT = 1024;
+
   private:
     /// The list of sorted, disjoint intervals.
     std::vector<Interval> _intervals;
 
+    /// Optional membership bitmap for the elements 0 .. 64 * _bitmap.size() - 1. Any modification of the set drops it.
+    std::vector<uint64_t> _bitmap;
+
     explicit IntervalSet(std::vector<Interval>&& intervals);
 
   public:
@@ -76,6 +87,12 @@ namespace misc {
     void add(const Interval &addition);
     IntervalSet& addAll(const IntervalSet &set);
 
+    /// Removes all elements of the given set from this one (in place). Returns this set.
+    IntervalSet& removeAll(const IntervalSet &set);
+
+    /// Removes all elements from this set which are not in the given one (in place). Returns this set.
+    IntervalSet& retainAll(const IntervalSet &set);
+
     template<typename T1, typename... T_NEXT>
     void addItems(T1 t1, T_NEXT&&... next) {
       add(t1);
@@ -119,6 +136,11 @@ namespace misc {
     /// return true if this set has no members
     bool isEmpty() const;
 
+    /// Creates a bitmap for the elements of this set below the given limit (rounded up to a multiple of 64), so
+    /// that contains() needs a single lookup for them. Larger elements are still searched in the intervals.
+    /// The bitmap is dropped again when the set is modified, so call this once the set is complete.
+    void createBitmap(size_t limit = DEFAULT_BITMAP_LIMIT);
+
     /// If this set is a single integer, return it otherwise Token.INVALID_TYPE.
     ssize_t getSingleElement() const;
 
@@ -178,6 +200,11 @@ namespace misc {
 
   private:
     void addItems() { /* No-op */ }
+
+    static void subtract(const std::vector<Interval> &left, const std::vector<Interval> &right,
+                         std::vector<Interval> &result);
+    static void intersect(const std::vector<Interval> &left, const std::vector<Interval> &right,
+                          std::vector<Interval> &result);
   };
 
 } // namespace atn
@@ -35,6 +35,11 @@ namespace misc {
     /// Returns the updated intermediate hash value.
     static size_t update(size_t hash, size_t value);
 
+    /// Update the intermediate hash value for the next two input values (counting as two entries for finish()).
+    static size_t update(size_t hash, size_t value1, size_t value2) {
+      return update(update(hash, value1), value2);
+    }
+
     /**
      * Update the intermediate hash value for the next input {@code value}.
      *
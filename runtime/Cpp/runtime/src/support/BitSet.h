@@ -9,16 +9,204 @@
 
 namespace antlrcpp {
 
-  class ANTLR4CPP_PUBLIC BitSet : public std::bitset<2048> {
+  /// A bit set which grows as needed. It is mostly used for sets of alternatives, which are small for almost
+  /// all decisions, so the first 64 bits are stored inline and only wider sets allocate memory.
+  /// Bits beyond size() read as 0.
+  class ANTLR4CPP_PUBLIC BitSet {
   public:
+    BitSet() : _wordCount(1) {
+      _word = 0;
+    }
+
+    BitSet(const BitSet &other) : _wordCount(1) {
+      _word = 0;
+      *this = other;
+    }
+
+    BitSet(BitSet &&other) noexcept : _wordCount(other._wordCount) {
+      if (_wordCount == 1) {
+        _word = other._word;
+      } else {
+        _words = other._words;
+        other._wordCount = 1;
+        other._word = 0;
+      }
+    }
+
+    ~BitSet() {
+      if (_wordCount > 1) {
+        delete[] _words;
+      }
+    }
+
+    BitSet& operator = (const BitSet &other) {
+      if (this == &other) {
+        return *this;
+      }
+
+      if (other._wordCount == 1) {
+        reset();
+        words()[0] = other._word;
+        return *this;
+      }
+
+      if (_wordCount < other._wordCount) {
+        grow(other._wordCount);
+      }
+      uint64_t *target = words();
+      std::copy(other._words, other._words + other._wordCount, target);
+      std::fill(target + other._wordCount, target + _wordCount, 0);
+      return *this;
+    }
+
+    BitSet& operator = (BitSet &&other) noexcept {
+      if (this == &other) {
+        return *this;
+      }
+
+      if (_wordCount > 1) {
+        delete[] _words;
+      }
+      _wordCount = other._wordCount;
+      if (_wordCount == 1) {
+        _word = other._word;
+      } else {
+        _words = other._words;
+        other._wordCount = 1;
+        other._word = 0;
+      }
+      return *this;
+    }
+
+    /// The number of bits which can be held without growing.
+    size_t size() const {
+      return _wordCount * 64;
+    }
+
+    bool test(size_t pos) const {
+      if (pos >= size()) {
+        return false;
+      }
+      return (words()[pos / 64] & (1ULL << (pos % 64))) != 0;
+    }
+
+    bool operator [] (size_t pos) const {
+      return test(pos);
+    }
+
+    BitSet& set(size_t pos) {
+      if (pos >= size()) {
+        grow(pos / 64 + 1);
+      }
+      words()[pos / 64] |= 1ULL << (pos % 64);
+      return *this;
+    }
+
+    BitSet& set(size_t pos, bool value) {
+      return value ? set(pos) : reset(pos);
+    }
+
+    BitSet& reset() {
+      uint64_t *bits = words();
+      std::fill(bits, bits + _wordCount, 0);
+      return *this;
+    }
+
+    BitSet& reset(size_t pos) {
+      if (pos < size()) {
+        words()[pos / 64] &= ~(1ULL << (pos % 64));
+      }
+      return *this;
+    }
+
+    size_t count() const {
+      if (_wordCount == 1) {
+        return popCount(_word);
+      }
+
+      size_t result = 0;
+      for (size_t i = 0; i < _wordCount; ++i) {
+        result += popCount(_words[i]);
+      }
+      return result;
+    }
+
+    bool any() const {
+      const uint64_t *bits = words();
+      for (size_t i = 0; i < _wordCount; ++i) {
+        if (bits[i] != 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool none() const {
+      return !any();
+    }
+
+    /// Returns the index of the first set bit at or after pos, or INVALID_INDEX if there is none.
     size_t nextSetBit(size_t pos) const {
-      for (size_t i = pos; i < size(); i++){
-        if (test(i)) {
-          return i;
+      if (pos >= size()) {
+        return INVALID_INDEX;
+      }
+
+      const uint64_t *bits = words();
+      size_t index = pos / 64;
+      uint64_t word = bits[index] & (~0ULL << (pos % 64));
+      while (word == 0) {
+        if (++index == _wordCount) {
+          return INVALID_INDEX;
         }
+        word = bits[index];
+      }
+      return index * 64 + countTrailingZeros(word);
+    }
+
+    BitSet& operator |= (const BitSet &other) {
+      if (_wordCount < other._wordCount) {
+        grow(other._wordCount);
+      }
+
+      uint64_t *bits = words();
+      const uint64_t *otherBits = other.words();
+      for (size_t i = 0; i < other._wordCount; ++i) {
+        bits[i] |= otherBits[i];
       }
+      return *this;
+    }
 
-      return INVALID_INDEX;
+    BitSet& operator &= (const BitSet &other) {
+      uint64_t *bits = words();
+      const uint64_t *otherBits = other.words();
+      for (size_t i = 0; i < _wordCount; ++i) {
+        bits[i] = i < other._wordCount ? bits[i] & otherBits[i] : 0;
+      }
+      return *this;
+    }
+
+    bool operator == (const BitSet &other) const {
+      const uint64_t *bits = words();
+      const uint64_t *otherBits = other.words();
+      size_t common = std::min(_wordCount, other._wordCount);
+      for (size_t i = 0; i < common; ++i) {
+        if (bits[i] != otherBits[i]) {
+          return false;
+        }
+      }
+
+      // Sets of different sizes are equal if the additional words of the larger one are empty.
+      const uint64_t *rest = _wordCount > common ? bits : otherBits;
+      for (size_t i = common; i < std::max(_wordCount, other._wordCount); ++i) {
+        if (rest[i] != 0) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool operator != (const BitSet &other) const {
+      return !(*this == other);
     }
 
     // Prints a list of every index for which the bitset contains a bit in true.
@@ -26,13 +214,11 @@ namespace antlrcpp {
     {
       os << "{";
       size_t total = obj.count();
-      for (size_t i = 0; i < obj.size(); i++){
-        if (obj.test(i)){
-          os << i;
-          --total;
-          if (total > 1){
-            os << ", ";
-          }
+      for (size_t i = obj.nextSetBit(0); i != INVALID_INDEX; i = obj.nextSetBit(i + 1)) {
+        os << i;
+        --total;
+        if (total > 1){
+          os << ", ";
         }
       }
 
@@ -54,23 +240,74 @@ namespace antlrcpp {
       return result;
     }
 
-    std::string toString(){
+    std::string toString() const {
       std::stringstream stream;
       stream << "{";
       bool valueAdded = false;
-      for (size_t i = 0; i < size(); ++i){
-        if (test(i)){
-          if (valueAdded) {
-            stream << ", ";
-          }
-          stream << i;
-          valueAdded = true;
+      for (size_t i = nextSetBit(0); i != INVALID_INDEX; i = nextSetBit(i + 1)) {
+        if (valueAdded) {
+          stream << ", ";
         }
+        stream << i;
+        valueAdded = true;
       }
 
       stream << "}";
       return stream.str();
     }
 
+  private:
+    size_t _wordCount; // 1 means the bits are held in _word.
+    union {
+      uint64_t _word;
+      uint64_t *_words;
+    };
+
+    uint64_t* words() {
+      return _wordCount == 1 ? &_word : _words;
+    }
+
+    const uint64_t* words() const {
+      return _wordCount == 1 ? &_word : _words;
+    }
+
+    void grow(size_t wordCount) {
+      uint64_t *bits = new uint64_t[wordCount];
+      const uint64_t *oldBits = words();
+      std::copy(oldBits, oldBits + _wordCount, bits);
+      std::fill(bits + _wordCount, bits + wordCount, 0);
+      if (_wordCount > 1) {
+        delete[] _words;
+      }
+      _words = bits;
+      _wordCount = wordCount;
+    }
+
+    static size_t popCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<size_t>(__builtin_popcountll(word));
+#else
+      return std::bitset<64>(word).count();
+#endif
+    }
+
+    // The word must not be 0.
+    static size_t countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<size_t>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+      unsigned long index;
+      _BitScanForward64(&index, word);
+      return index;
+#else
+      size_t index = 0;
+      while ((word & 1) == 0) {
+        word >>= 1;
+        ++index;
+      }
+      return index;
+#endif
+    }
+
   };
 }
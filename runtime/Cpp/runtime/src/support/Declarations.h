@@ -52,6 +52,7 @@ namespace antlr4 {
   class WritableToken;
 
   namespace misc {
+    class FastHash;
     class InterpreterDataReader;
     class Interval;
     class IntervalSet;
@@ -85,9 +86,11 @@ namespace antlr4 {
     class LexerActionExecutor;
     class LexerATNConfig;
     class LexerATNSimulator;
+    class LexerDFATable;
     class LexerMoreAction;
     class LexerPopModeAction;
     class LexerSkipAction;
+    class LexerTransitionTable;
     class LookaheadEventInfo;
     class LoopEndState;
     class NotSetTransition;
@@ -118,6 +121,7 @@ namespace antlr4 {
   namespace dfa {
     class DFA;
     class DFASerializer;
+    class DFASnapshot;
     class DFAState;
     class LexerDFASerializer;
     class Vocabulary;
@@ -126,6 +130,7 @@ namespace antlr4 {
     class AbstractParseTreeVisitor;
     class ErrorNode;
     class ErrorNodeImpl;
+    class FlatParseTree;
     class ParseTree;
     class ParseTreeListener;
     template<typename T> class ParseTreeProperty;
@@ -139,9 +144,11 @@ namespace antlr4 {
 
     namespace pattern {
       class Chunk;
+      class CompiledParseTreePattern;
       class ParseTreeMatch;
       class ParseTreePattern;
       class ParseTreePatternMatcher;
+      class ParseTreePatternSet;
       class RuleTagToken;
       class TagChunk;
       class TextChunk;
@@ -151,6 +158,7 @@ namespace antlr4 {
     namespace xpath {
       class XPath;
       class XPathElement;
+      class XPathIndex;
       class XPathLexerErrorListener;
       class XPathRuleAnywhereElement;
       class XPathRuleElement;
@@ -0,0 +1,488 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Exceptions.h"
+#include "ParserRuleContext.h"
+#include "Token.h"
+#include "tree/ErrorNode.h"
+#include "tree/ParseTree.h"
+#include "tree/TerminalNode.h"
+#include "support/CPPUtils.h"
+
+#include "tree/FlatParseTree.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+
+namespace {
+
+  const char MAGIC[] = { 'A', 'F', 'P', 'T' };
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+  const uint32_t VERSION = 1;
+
+  // The value stored for INVALID_INDEX.
+  const uint32_t NONE = 0xFFFFFFFF;
+
+  // Set in the token flags if the terminal node of the token is an error node.
+  const uint32_t ERROR_NODE = 1;
+
+  enum HeaderField : size_t {
+    HEADER_MAGIC,
+    HEADER_BYTE_ORDER_MARK,
+    HEADER_VERSION,
+    HEADER_NODE_COUNT,
+    HEADER_TOKEN_COUNT,
+    HEADER_TEXT_SIZE,
+    HEADER_SIZE
+  };
+
+  const size_t NODE_COLUMNS = 7;
+  const size_t TOKEN_COLUMNS = 8;
+
+  uint64_t getWordCount(uint64_t nodeCount, uint64_t tokenCount, uint64_t textSize) {
+    return HEADER_SIZE + NODE_COLUMNS * nodeCount + TOKEN_COLUMNS * tokenCount + (tokenCount + 1) + (textSize + 3) / 4;
+  }
+
+  uint32_t toWord(size_t value) {
+    if (value == INVALID_INDEX) {
+      return NONE;
+    }
+    if (value >= NONE) {
+      throw UnsupportedOperationException("Flat parse trees can only hold 32 bit values.");
+    }
+    return static_cast<uint32_t>(value);
+  }
+
+  size_t fromWord(uint32_t value) {
+    return value == NONE ? INVALID_INDEX : value;
+  }
+
+  // Collects the columns of a tree before they are copied into the buffer.
+  struct Builder {
+    std::vector<uint32_t> nodeColumns[NODE_COLUMNS];
+    std::vector<uint32_t> tokenColumns[TOKEN_COLUMNS];
+    std::vector<uint32_t> textOffsets;
+    std::string text;
+
+    void add(ParseTree *t, uint32_t parent) {
+      size_t node = nodeColumns[0].size();
+      TerminalNode *terminal = dynamic_cast<TerminalNode *>(t);
+      if (terminal != nullptr) {
+        Token *symbol = terminal->getSymbol();
+        uint32_t tokenIndex = toWord(symbol->getTokenIndex());
+        addNode(NONE, 0, tokenIndex, tokenIndex, 1, parent, toWord(textOffsets.size()));
+
+        const uint32_t tokenValues[TOKEN_COLUMNS] = {
+          toWord(symbol->getType()), toWord(symbol->getChannel()), tokenIndex, toWord(symbol->getStartIndex()),
+          toWord(symbol->getStopIndex()), toWord(symbol->getLine()), toWord(symbol->getCharPositionInLine()),
+          antlrcpp::is<ErrorNode *>(t) ? ERROR_NODE : 0
+        };
+        for (size_t i = 0; i < TOKEN_COLUMNS; ++i) {
+          tokenColumns[i].push_back(tokenValues[i]);
+        }
+        textOffsets.push_back(toWord(text.size()));
+        text += symbol->getText();
+        return;
+      }
+
+      RuleContext *context = dynamic_cast<RuleContext *>(t);
+      if (context == nullptr) {
+        throw IllegalArgumentException("Flat parse trees can only hold rule contexts and terminal nodes.");
+      }
+
+      uint32_t start = NONE;
+      uint32_t stop = NONE;
+      ParserRuleContext *parserContext = dynamic_cast<ParserRuleContext *>(t);
+      if (parserContext != nullptr) {
+        if (parserContext->start != nullptr) {
+          start = toWord(parserContext->start->getTokenIndex());
+        }
+        if (parserContext->stop != nullptr) {
+          stop = toWord(parserContext->stop->getTokenIndex());
+        }
+      }
+
+      // The subtree size is set once the children are added.
+      addNode(toWord(context->getRuleIndex()), toWord(context->getAltNumber()), start, stop, 0, parent, NONE);
+      for (ParseTree *child : t->children) {
+        add(child, static_cast<uint32_t>(node));
+      }
+      nodeColumns[4][node] = toWord(nodeColumns[0].size() - node);
+    }
+
+    void addNode(uint32_t ruleIndex, uint32_t altNumber, uint32_t start, uint32_t stop, uint32_t subtreeSize,
+                 uint32_t parent, uint32_t token) {
+      const uint32_t values[NODE_COLUMNS] = { ruleIndex, altNumber, start, stop, subtreeSize, parent, token };
+      for (size_t i = 0; i < NODE_COLUMNS; ++i) {
+        nodeColumns[i].push_back(values[i]);
+      }
+    }
+  };
+
+}
+
+FlatParseTree::FlatParseTree(ParseTree *root) {
+  if (root == nullptr) {
+    throw IllegalArgumentException("root cannot be null");
+  }
+
+  Builder builder;
+  builder.add(root, NONE);
+  builder.textOffsets.push_back(toWord(builder.text.size()));
+
+  size_t nodeCount = builder.nodeColumns[0].size();
+  size_t tokenCount = builder.tokenColumns[0].size();
+  _storage.resize(static_cast<size_t>(getWordCount(nodeCount, tokenCount, builder.text.size())));
+
+  uint32_t *header = _storage.data();
+  memcpy(&header[HEADER_MAGIC], MAGIC, sizeof(MAGIC));
+  header[HEADER_BYTE_ORDER_MARK] = BYTE_ORDER_MARK;
+  header[HEADER_VERSION] = VERSION;
+  header[HEADER_NODE_COUNT] = toWord(nodeCount);
+  header[HEADER_TOKEN_COUNT] = toWord(tokenCount);
+  header[HEADER_TEXT_SIZE] = toWord(builder.text.size());
+
+  uint32_t *output = header + HEADER_SIZE;
+  for (const std::vector<uint32_t> &column : builder.nodeColumns) {
+    output = std::copy(column.begin(), column.end(), output);
+  }
+  for (const std::vector<uint32_t> &column : builder.tokenColumns) {
+    output = std::copy(column.begin(), column.end(), output);
+  }
+  output = std::copy(builder.textOffsets.begin(), builder.textOffsets.end(), output);
+  std::copy(builder.text.begin(), builder.text.end(), reinterpret_cast<char *>(output));
+
+  bind(_storage.data(), _storage.size() * sizeof(uint32_t));
+}
+
+FlatParseTree::FlatParseTree(const char *data, size_t size) {
+  if (reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) == 0) {
+    bind(reinterpret_cast<const uint32_t *>(data), size);
+  } else {
+    _storage.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    std::copy(data, data + size, reinterpret_cast<char *>(_storage.data()));
+    bind(_storage.data(), size);
+  }
+  validate();
+}
+
+FlatParseTree::FlatParseTree(FlatParseTree &&other) {
+  *this = std::move(other);
+}
+
+FlatParseTree::~FlatParseTree() {
+  release();
+}
+
+FlatParseTree& FlatParseTree::operator = (FlatParseTree &&other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  release();
+
+  // Moving the vector keeps its buffer, so the column pointers stay valid.
+  _storage = std::move(other._storage);
+  _mapping = other._mapping;
+  _mappingSize = other._mappingSize;
+  other._mapping = nullptr;
+  other._mappingSize = 0;
+
+  if (other._data != nullptr) {
+    bind(other._data, other._dataSize);
+  } else {
+    _data = nullptr;
+    _dataSize = 0;
+    _nodeCount = 0;
+    _tokenCount = 0;
+  }
+  other._data = nullptr;
+  other._dataSize = 0;
+  other._nodeCount = 0;
+  other._tokenCount = 0;
+  return *this;
+}
+
+FlatParseTree FlatParseTree::load(const std::string &fileName) {
+#ifdef _WIN32
+  std::ifstream input(fileName, std::ios::binary);
+  if (!input.good()) {
+    throw IllegalArgumentException("Cannot read the flat parse tree file " + fileName + ".");
+  }
+
+  std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  FlatParseTree result;
+  result._storage.resize((content.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+  std::copy(content.begin(), content.end(), reinterpret_cast<char *>(result._storage.data()));
+  result.bind(result._storage.data(), content.size());
+  result.validate();
+  return result;
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw IllegalArgumentException("Cannot read the flat parse tree file " + fileName + ".");
+  }
+
+  auto onExit = antlrcpp::finally([file] {
+    close(file);
+  });
+
+  struct stat info;
+  if (fstat(file, &info) != 0 || info.st_size == 0) {
+    throw IllegalArgumentException("Cannot read the flat parse tree file " + fileName + ".");
+  }
+
+  size_t size = static_cast<size_t>(info.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  if (mapping == MAP_FAILED) {
+    throw IllegalArgumentException("Cannot read the flat parse tree file " + fileName + ".");
+  }
+
+  // The result unmaps the file when it is destroyed, also if the content turns out to be invalid.
+  FlatParseTree result;
+  result._mapping = mapping;
+  result._mappingSize = size;
+  result.bind(static_cast<const uint32_t *>(mapping), size);
+  result.validate();
+  return result;
+#endif
+}
+
+void FlatParseTree::save(std::ostream &output) const {
+  output.write(reinterpret_cast<const char *>(_data), static_cast<std::streamsize>(_dataSize));
+}
+
+size_t FlatParseTree::size() const {
+  return _nodeCount;
+}
+
+size_t FlatParseTree::getTokenCount() const {
+  return _tokenCount;
+}
+
+bool FlatParseTree::isTerminal(size_t node) const {
+  return _tokens[node] != NONE;
+}
+
+bool FlatParseTree::isErrorNode(size_t node) const {
+  return _tokens[node] != NONE && (_tokenFlags[_tokens[node]] & ERROR_NODE) != 0;
+}
+
+size_t FlatParseTree::getRuleIndex(size_t node) const {
+  return fromWord(_ruleIndices[node]);
+}
+
+size_t FlatParseTree::getAltNumber(size_t node) const {
+  return _altNumbers[node];
+}
+
+size_t FlatParseTree::getStartTokenIndex(size_t node) const {
+  return fromWord(_startTokens[node]);
+}
+
+size_t FlatParseTree::getStopTokenIndex(size_t node) const {
+  return fromWord(_stopTokens[node]);
+}
+
+size_t FlatParseTree::getSubtreeSize(size_t node) const {
+  return _subtreeSizes[node];
+}
+
+size_t FlatParseTree::getSubtreeEnd(size_t node) const {
+  return node + _subtreeSizes[node];
+}
+
+size_t FlatParseTree::getParent(size_t node) const {
+  return fromWord(_parents[node]);
+}
+
+size_t FlatParseTree::getFirstChild(size_t node) const {
+  return _subtreeSizes[node] > 1 ? node + 1 : INVALID_INDEX;
+}
+
+size_t FlatParseTree::getNextSibling(size_t node) const {
+  uint32_t parent = _parents[node];
+  if (parent == NONE) {
+    return INVALID_INDEX;
+  }
+
+  size_t next = node + _subtreeSizes[node];
+  return next < static_cast<size_t>(parent) + _subtreeSizes[parent] ? next : INVALID_INDEX;
+}
+
+size_t FlatParseTree::getChildCount(size_t node) const {
+  size_t count = 0;
+  for (size_t child = node + 1; child < node + _subtreeSizes[node]; child += _subtreeSizes[child]) {
+    ++count;
+  }
+  return count;
+}
+
+FlatParseTree::ChildRange FlatParseTree::getChildren(size_t node) const {
+  return ChildRange(this, node + 1, node + _subtreeSizes[node]);
+}
+
+size_t FlatParseTree::getToken(size_t node) const {
+  return fromWord(_tokens[node]);
+}
+
+std::string FlatParseTree::getText(size_t node) const {
+  // The tokens of the terminal nodes of a subtree are consecutive rows of the token table.
+  size_t end = node + _subtreeSizes[node];
+  size_t first = node;
+  while (first < end && _tokens[first] == NONE) {
+    ++first;
+  }
+  if (first == end) {
+    return "";
+  }
+
+  size_t last = end - 1;
+  while (_tokens[last] == NONE) {
+    --last;
+  }
+
+  uint32_t textStart = _textOffsets[_tokens[first]];
+  return std::string(_text + textStart, _textOffsets[_tokens[last] + 1] - textStart);
+}
+
+size_t FlatParseTree::getTokenType(size_t token) const {
+  return fromWord(_tokenTypes[token]);
+}
+
+size_t FlatParseTree::getTokenChannel(size_t token) const {
+  return _tokenChannels[token];
+}
+
+size_t FlatParseTree::getTokenIndex(size_t token) const {
+  return fromWord(_tokenIndices[token]);
+}
+
+size_t FlatParseTree::getTokenStartIndex(size_t token) const {
+  return fromWord(_tokenStartIndices[token]);
+}
+
+size_t FlatParseTree::getTokenStopIndex(size_t token) const {
+  return fromWord(_tokenStopIndices[token]);
+}
+
+size_t FlatParseTree::getTokenLine(size_t token) const {
+  return _tokenLines[token];
+}
+
+size_t FlatParseTree::getTokenCharPositionInLine(size_t token) const {
+  return _tokenCharPositions[token];
+}
+
+std::string FlatParseTree::getTokenText(size_t token) const {
+  return std::string(_text + _textOffsets[token], _textOffsets[token + 1] - _textOffsets[token]);
+}
+
+void FlatParseTree::bind(const uint32_t *data, size_t size) {
+  if (size < HEADER_SIZE * sizeof(uint32_t) || memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    throw IllegalArgumentException("Invalid flat parse tree: not a flat parse tree.");
+  }
+  if (data[HEADER_BYTE_ORDER_MARK] != BYTE_ORDER_MARK) {
+    throw IllegalArgumentException("Invalid flat parse tree: written with a different byte order.");
+  }
+  if (data[HEADER_VERSION] != VERSION) {
+    throw IllegalArgumentException("Invalid flat parse tree: unsupported version " +
+                                   std::to_string(data[HEADER_VERSION]) + ".");
+  }
+
+  size_t nodeCount = data[HEADER_NODE_COUNT];
+  size_t tokenCount = data[HEADER_TOKEN_COUNT];
+  size_t textSize = data[HEADER_TEXT_SIZE];
+  if (nodeCount == 0 || getWordCount(nodeCount, tokenCount, textSize) * sizeof(uint32_t) != size) {
+    throw IllegalArgumentException("Invalid flat parse tree: the size does not match the content.");
+  }
+
+  _data = data;
+  _dataSize = size;
+  _nodeCount = nodeCount;
+  _tokenCount = tokenCount;
+
+  const uint32_t *column = data + HEADER_SIZE;
+  const uint32_t **nodeColumns[NODE_COLUMNS] = {
+    &_ruleIndices, &_altNumbers, &_startTokens, &_stopTokens, &_subtreeSizes, &_parents, &_tokens
+  };
+  for (const uint32_t **nodeColumn : nodeColumns) {
+    *nodeColumn = column;
+    column += nodeCount;
+  }
+
+  const uint32_t **tokenColumns[TOKEN_COLUMNS] = {
+    &_tokenTypes, &_tokenChannels, &_tokenIndices, &_tokenStartIndices, &_tokenStopIndices, &_tokenLines,
+    &_tokenCharPositions, &_tokenFlags
+  };
+  for (const uint32_t **tokenColumn : tokenColumns) {
+    *tokenColumn = column;
+    column += tokenCount;
+  }
+
+  _textOffsets = column;
+  _text = reinterpret_cast<const char *>(column + tokenCount + 1);
+}
+
+void FlatParseTree::validate() const {
+  // Rebuild the parent of each node from the subtree sizes, with the stack of the nodes whose subtree contains
+  // the current node, and compare it with the stored one.
+  std::vector<size_t> ancestors;
+  size_t nextToken = 0;
+  for (size_t node = 0; node < _nodeCount; ++node) {
+    while (!ancestors.empty() && node >= ancestors.back() + _subtreeSizes[ancestors.back()]) {
+      ancestors.pop_back();
+    }
+
+    size_t parent = ancestors.empty() ? INVALID_INDEX : ancestors.back();
+    size_t end = ancestors.empty() ? _nodeCount : parent + _subtreeSizes[parent];
+    if (fromWord(_parents[node]) != parent || (parent == INVALID_INDEX && node > 0) || _subtreeSizes[node] == 0 ||
+        _subtreeSizes[node] > end - node) {
+      throw IllegalArgumentException("Invalid flat parse tree: inconsistent structure at node " +
+                                     std::to_string(node) + ".");
+    }
+
+    // Terminal nodes are leaves with the next token table row.
+    if (_tokens[node] != NONE && (_tokens[node] != nextToken++ || _subtreeSizes[node] != 1)) {
+      throw IllegalArgumentException("Invalid flat parse tree: inconsistent token at node " +
+                                     std::to_string(node) + ".");
+    }
+    ancestors.push_back(node);
+  }
+
+  if (nextToken != _tokenCount) {
+    throw IllegalArgumentException("Invalid flat parse tree: unused token table rows.");
+  }
+
+  size_t textSize = _data[HEADER_TEXT_SIZE];
+  for (size_t token = 0; token < _tokenCount; ++token) {
+    if (_textOffsets[token] > _textOffsets[token + 1]) {
+      throw IllegalArgumentException("Invalid flat parse tree: inconsistent token text offsets.");
+    }
+  }
+  if (_textOffsets[0] != 0 || _textOffsets[_tokenCount] != textSize) {
+    throw IllegalArgumentException("Invalid flat parse tree: inconsistent token text offsets.");
+  }
+}
+
+void FlatParseTree::release() {
+#ifndef _WIN32
+  if (_mapping != nullptr) {
+    munmap(_mapping, _mappingSize);
+  }
+#endif
+  _mapping = nullptr;
+  _mappingSize = 0;
+  _storage.clear();
+}
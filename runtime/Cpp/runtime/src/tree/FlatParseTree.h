@@ -0,0 +1,198 @@
+﻿/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+
+  /// An immutable copy of a parse tree in flat, column oriented form.
+  ///
+  /// <para>
+  /// The nodes are numbered in document order (pre-order), with the root as node 0. For each node there is
+  /// one entry in each of the node columns: rule index, alt number, start and stop token index, subtree size,
+  /// parent and token. The terminal nodes have no rule index and refer to a row of the token table, which
+  /// holds the type, channel, position and text of their tokens. The nodes of a subtree are a contiguous range,
+  /// so skipping a subtree or moving to the next sibling is a single addition.</para>
+  ///
+  /// <para>
+  /// All columns are stored in a single buffer of 32 bit values, which is also the binary format written by
+  /// save(). load() maps such a file into memory and uses it in place, without converting or copying it.
+  /// The format is versioned and uses the byte order of the machine which wrote it. Reading checks both and the
+  /// structure of the tree, so invalid data cannot lead to access outside of the buffer.</para>
+  class ANTLR4CPP_PUBLIC FlatParseTree {
+  public:
+    /// Iterates over the children of a node.
+    class ANTLR4CPP_PUBLIC ChildIterator {
+    public:
+      ChildIterator(const FlatParseTree *tree, size_t node) : _tree(tree), _node(node) {}
+
+      size_t operator * () const {
+        return _node;
+      }
+
+      ChildIterator& operator ++ () {
+        _node += _tree->_subtreeSizes[_node];
+        return *this;
+      }
+
+      bool operator != (const ChildIterator &other) const {
+        return _node != other._node;
+      }
+
+    private:
+      const FlatParseTree *_tree;
+      size_t _node;
+    };
+
+    /// The children of a node, for use in range based for loops.
+    class ANTLR4CPP_PUBLIC ChildRange {
+    public:
+      ChildRange(const FlatParseTree *tree, size_t begin, size_t end) : _tree(tree), _begin(begin), _end(end) {}
+
+      ChildIterator begin() const {
+        return ChildIterator(_tree, _begin);
+      }
+
+      ChildIterator end() const {
+        return ChildIterator(_tree, _end);
+      }
+
+    private:
+      const FlatParseTree *_tree;
+      size_t _begin;
+      size_t _end;
+    };
+
+    /// Converts the tree below {@code root}.
+    explicit FlatParseTree(ParseTree *root);
+
+    /// Uses the binary data in {@code data} (as written by save()) in place if it is 4 byte aligned, or a copy
+    /// of it. Data used in place must outlive this object. Throws an IllegalArgumentException if the data is
+    /// not valid.
+    FlatParseTree(const char *data, size_t size);
+
+    FlatParseTree(FlatParseTree const&) = delete;
+    FlatParseTree(FlatParseTree &&other);
+    virtual ~FlatParseTree();
+
+    FlatParseTree& operator = (FlatParseTree const&) = delete;
+    FlatParseTree& operator = (FlatParseTree &&other);
+
+    /// Reads a tree written by save() from a file, which is memory mapped where supported. Throws an
+    /// IllegalArgumentException if the file cannot be read or its content is not valid.
+    static FlatParseTree load(const std::string &fileName);
+
+    /// Writes the tree in binary form. The output stream must be opened in binary mode.
+    void save(std::ostream &output) const;
+
+    /// The number of nodes.
+    size_t size() const;
+
+    /// The number of rows in the token table, which is the number of terminal nodes.
+    size_t getTokenCount() const;
+
+    // ---- Nodes ----
+
+    bool isTerminal(size_t node) const;
+    bool isErrorNode(size_t node) const;
+
+    /// The rule index of a rule node or INVALID_INDEX for terminal nodes.
+    size_t getRuleIndex(size_t node) const;
+
+    /// The alt number of a rule node (see RuleContext::getAltNumber()), 0 for terminal nodes.
+    size_t getAltNumber(size_t node) const;
+
+    /// The token index of the first and last token of a node or INVALID_INDEX if the node has no such token.
+    size_t getStartTokenIndex(size_t node) const;
+    size_t getStopTokenIndex(size_t node) const;
+
+    /// The number of nodes of the subtree of a node, including the node itself.
+    size_t getSubtreeSize(size_t node) const;
+
+    /// The node after the subtree of a node.
+    size_t getSubtreeEnd(size_t node) const;
+
+    /// The parent of a node or INVALID_INDEX for the root.
+    size_t getParent(size_t node) const;
+
+    /// The first child of a node or INVALID_INDEX if it has none.
+    size_t getFirstChild(size_t node) const;
+
+    /// The next sibling of a node or INVALID_INDEX if it is the last child (or the root).
+    size_t getNextSibling(size_t node) const;
+
+    size_t getChildCount(size_t node) const;
+    ChildRange getChildren(size_t node) const;
+
+    /// The token table row of a terminal node or INVALID_INDEX for rule nodes.
+    size_t getToken(size_t node) const;
+
+    /// The combined text of all terminal nodes in the subtree of a node (see ParseTree::getText()).
+    std::string getText(size_t node) const;
+
+    // ---- Tokens ----
+
+    size_t getTokenType(size_t token) const;
+    size_t getTokenChannel(size_t token) const;
+
+    /// The index of the token in its token stream (see Token::getTokenIndex()).
+    size_t getTokenIndex(size_t token) const;
+
+    /// The character indices of the token in its input.
+    size_t getTokenStartIndex(size_t token) const;
+    size_t getTokenStopIndex(size_t token) const;
+
+    size_t getTokenLine(size_t token) const;
+    size_t getTokenCharPositionInLine(size_t token) const;
+    std::string getTokenText(size_t token) const;
+
+  private:
+    // The buffer, if it is owned by this object and not memory mapped or provided by the caller.
+    std::vector<uint32_t> _storage;
+
+    // The memory mapping of a loaded file, if any.
+    void *_mapping = nullptr;
+    size_t _mappingSize = 0;
+
+    // The size of the buffer in bytes.
+    size_t _dataSize = 0;
+    const uint32_t *_data = nullptr;
+
+    size_t _nodeCount = 0;
+    size_t _tokenCount = 0;
+
+    // Node columns.
+    const uint32_t *_ruleIndices = nullptr;
+    const uint32_t *_altNumbers = nullptr;
+    const uint32_t *_startTokens = nullptr;
+    const uint32_t *_stopTokens = nullptr;
+    const uint32_t *_subtreeSizes = nullptr;
+    const uint32_t *_parents = nullptr;
+    const uint32_t *_tokens = nullptr;
+
+    // Token columns. There is one more text offset than tokens, for the end of the text of the last token.
+    const uint32_t *_tokenTypes = nullptr;
+    const uint32_t *_tokenChannels = nullptr;
+    const uint32_t *_tokenIndices = nullptr;
+    const uint32_t *_tokenStartIndices = nullptr;
+    const uint32_t *_tokenStopIndices = nullptr;
+    const uint32_t *_tokenLines = nullptr;
+    const uint32_t *_tokenCharPositions = nullptr;
+    const uint32_t *_tokenFlags = nullptr;
+    const uint32_t *_textOffsets = nullptr;
+    const char *_text = nullptr;
+
+    FlatParseTree() {}
+
+    void bind(const uint32_t *data, size_t size);
+    void validate() const;
+    void release();
+  };
+
+} // namespace tree
+} // namespace antlr4
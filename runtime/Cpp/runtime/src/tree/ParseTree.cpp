@@ -10,6 +10,10 @@ using namespace antlr4::tree;
 ParseTree::ParseTree() : parent(nullptr) {
 }
 
+void ParseTree::appendText(std::string &text) {
+  text += getText();
+}
+
 bool ParseTree::operator == (const ParseTree &other) const {
   return &other == this;
 }
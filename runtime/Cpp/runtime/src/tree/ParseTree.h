@@ -57,6 +57,11 @@ namespace tree {
     /// comments if they are sent to parser on hidden channel.
     virtual std::string getText() = 0;
 
+    /// Appends the text of getText() to the given string. Rule contexts whose getText() is not overridden pass
+    /// the string on to their children (see RuleContext::hasDefaultGetText()), so the text of a whole tree is
+    /// built in a single string instead of being copied once per tree level. Other nodes use this default.
+    virtual void appendText(std::string &text);
+
     /**
      * Return an {@link Interval} indicating the index in the
      * {@link TokenStream} of the first and last token associated with this
@@ -77,24 +82,77 @@ namespace tree {
   };
 
   // A class to help managing ParseTree instances without the need of a shared_ptr.
+  // Instances can be released for reuse (see Parser::setStreamingMode and ParserInterpreter::releaseContexts).
+  // They are kept in per type free lists and are only destroyed when they are reused (and constructed again in
+  // place) or on reset().
   class ANTLR4CPP_PUBLIC ParseTreeTracker {
   public:
     template<typename T, typename ... Args>
     T* createInstance(Args&& ... args) {
       static_assert(std::is_base_of<ParseTree, T>::value, "Argument must be a parse tree type");
-      T* result = new T(args...);
+      T* result = nullptr;
+      if (!_released.empty()) {
+        auto iterator = _released.find(&typeid(T));
+        if (iterator != _released.end() && !iterator->second.empty()) {
+          result = dynamic_cast<T *>(iterator->second.back());
+          iterator->second.pop_back();
+          result->~T();
+          new (result) T(args...);
+        }
+      }
+      if (result == nullptr) {
+        result = new T(args...);
+      }
       _allocated.push_back(result);
       return result;
     }
 
+    // The number of instances in use, i.e. created and not released.
+    size_t size() const {
+      return _allocated.size();
+    }
+
+    // The instance in use which was created last, or null if there is none.
+    ParseTree* getLast() const {
+      return _allocated.empty() ? nullptr : _allocated.back();
+    }
+
+    // Releases all instances in use except the first {@code count} ones. They stay valid until they are reused.
+    void release(size_t count) {
+      release(count, _allocated.size());
+    }
+
+    // Releases the instances in use from index {@code begin} up to (excluding) {@code end}.
+    void release(size_t begin, size_t end) {
+      end = std::min(end, _allocated.size());
+      if (begin >= end) {
+        return;
+      }
+      for (size_t i = begin; i < end; ++i) {
+        ParseTree *entry = _allocated[i];
+        _released[&typeid(*entry)].push_back(entry);
+      }
+      _allocated.erase(_allocated.begin() + static_cast<std::ptrdiff_t>(begin),
+                       _allocated.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+
     void reset() {
       for (auto * entry : _allocated)
         delete entry;
       _allocated.clear();
+      for (auto &list : _released) {
+        for (auto * entry : list.second)
+          delete entry;
+      }
+      _released.clear();
     }
 
   private:
     std::vector<ParseTree *> _allocated;
+
+    // Released instances by type. Keying on the type_info address may keep instances of one type in two lists
+    // if the type has several type_info objects (across shared libraries), but never mixes types.
+    std::unordered_map<const std::type_info *, std::vector<ParseTree *>> _released;
   };
 
 
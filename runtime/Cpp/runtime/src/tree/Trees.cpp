@@ -186,16 +186,16 @@ std::vector<ParseTree *> Trees::findAllNodes(ParseTree *t, size_t index, bool fi
   return nodes;
 }
 
-std::vector<ParseTree *> Trees::getDescendants(ParseTree *t) {
-  std::vector<ParseTree *> nodes;
+static void _getDescendants(ParseTree *t, std::vector<ParseTree *> &nodes) {
   nodes.push_back(t);
-  std::size_t n = t->children.size();
-  for (size_t i = 0 ; i < n ; i++) {
-    auto descentants = getDescendants(t->children[i]);
-    for (auto *entry: descentants) {
-      nodes.push_back(entry);
-    }
+  for (auto *child : t->children) {
+    _getDescendants(child, nodes);
   }
+}
+
+std::vector<ParseTree *> Trees::getDescendants(ParseTree *t) {
+  std::vector<ParseTree *> nodes;
+  _getDescendants(t, nodes);
   return nodes;
 }
 
@@ -0,0 +1,152 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "ParserRuleContext.h"
+#include "Token.h"
+#include "tree/ParseTree.h"
+#include "tree/TerminalNode.h"
+#include "tree/pattern/RuleTagToken.h"
+#include "tree/pattern/TokenTagToken.h"
+
+#include "tree/pattern/CompiledParseTreePattern.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+using namespace antlr4::tree::pattern;
+
+CompiledParseTreePattern::CompiledParseTreePattern(const std::string &pattern, size_t patternRuleIndex,
+                                                   ParseTree *patternTree)
+  : _pattern(pattern), _patternRuleIndex(patternRuleIndex) {
+  if (patternTree == nullptr) {
+    throw IllegalArgumentException("patternTree cannot be null");
+  }
+
+  add(patternTree);
+}
+
+const std::string& CompiledParseTreePattern::getPattern() const {
+  return _pattern;
+}
+
+size_t CompiledParseTreePattern::getPatternRuleIndex() const {
+  return _patternRuleIndex;
+}
+
+size_t CompiledParseTreePattern::getTagCount() const {
+  return _tagNames.size();
+}
+
+const std::string& CompiledParseTreePattern::getTagName(size_t tag) const {
+  return _tagNames[tag];
+}
+
+const std::string& CompiledParseTreePattern::getTagLabel(size_t tag) const {
+  return _tagLabels[tag];
+}
+
+size_t CompiledParseTreePattern::getTagIndex(const std::string &label) const {
+  for (size_t tag = _tagNames.size(); tag > 0; --tag) {
+    if (_tagNames[tag - 1] == label || _tagLabels[tag - 1] == label) {
+      return tag - 1;
+    }
+  }
+  return INVALID_INDEX;
+}
+
+bool CompiledParseTreePattern::matches(ParseTree *tree, ParseTree **bindings) const {
+  if (tree == nullptr) {
+    throw IllegalArgumentException("tree cannot be null");
+  }
+
+  size_t position = 0;
+  return matches(tree, position, bindings);
+}
+
+void CompiledParseTreePattern::add(ParseTree *patternTree) {
+  TerminalNode *terminal = dynamic_cast<TerminalNode *>(patternTree);
+  if (terminal != nullptr) {
+    Token *symbol = terminal->getSymbol();
+    TokenTagToken *tokenTag = dynamic_cast<TokenTagToken *>(symbol);
+    if (tokenTag != nullptr) {
+      _nodes.push_back({ NodeKind::TOKEN_TAG, symbol->getType(), _tagNames.size() });
+      _tagNames.push_back(tokenTag->getTokenName());
+      _tagLabels.push_back(tokenTag->getLabel());
+      return;
+    }
+
+    // The text is compared even for literal token types, a lexer action can change the text of a token.
+    _nodes.push_back({ NodeKind::TOKEN, symbol->getType(), _texts.size() });
+    _texts.push_back(symbol->getText());
+    return;
+  }
+
+  ParserRuleContext *context = dynamic_cast<ParserRuleContext *>(patternTree);
+  if (context == nullptr) {
+    throw IllegalArgumentException("pattern trees can only contain rule and terminal nodes");
+  }
+
+  // A rule tag is parsed as a rule node with a single rule tag token.
+  if (context->children.size() == 1) {
+    TerminalNode *child = dynamic_cast<TerminalNode *>(context->children[0]);
+    RuleTagToken *ruleTag = child != nullptr ? dynamic_cast<RuleTagToken *>(child->getSymbol()) : nullptr;
+    if (ruleTag != nullptr) {
+      _nodes.push_back({ NodeKind::RULE_TAG, context->getRuleIndex(), _tagNames.size() });
+      _tagNames.push_back(ruleTag->getRuleName());
+      _tagLabels.push_back(ruleTag->getLabel());
+      return;
+    }
+  }
+
+  _nodes.push_back({ NodeKind::RULE, context->getRuleIndex(), context->children.size() });
+  for (ParseTree *child : context->children) {
+    add(child);
+  }
+}
+
+bool CompiledParseTreePattern::matches(ParseTree *tree, size_t &position, ParseTree **bindings) const {
+  const Node &node = _nodes[position++];
+  switch (node.kind) {
+    case NodeKind::RULE:
+    case NodeKind::RULE_TAG: {
+      ParserRuleContext *context = dynamic_cast<ParserRuleContext *>(tree);
+      if (context == nullptr || context->getRuleIndex() != node.type) {
+        return false;
+      }
+
+      if (node.kind == NodeKind::RULE_TAG) {
+        if (bindings != nullptr) {
+          bindings[node.value] = tree;
+        }
+        return true;
+      }
+
+      if (context->children.size() != node.value) {
+        return false;
+      }
+      for (ParseTree *child : context->children) {
+        if (!matches(child, position, bindings)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    default: {
+      TerminalNode *terminal = dynamic_cast<TerminalNode *>(tree);
+      if (terminal == nullptr || terminal->getSymbol()->getType() != node.type) {
+        return false;
+      }
+
+      if (node.kind == NodeKind::TOKEN_TAG) {
+        if (bindings != nullptr) {
+          bindings[node.value] = tree;
+        }
+        return true;
+      }
+      return terminal->getSymbol()->getText() == _texts[node.value];
+    }
+  }
+}
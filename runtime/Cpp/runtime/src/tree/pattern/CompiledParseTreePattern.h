@@ -0,0 +1,88 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+namespace pattern {
+
+  /// A tree pattern in a flat form which can be matched without building label maps.
+  ///
+  /// <para>
+  /// The pattern tree is stored as an array of nodes in pre-order. Each node holds what a subtree must have
+  /// to match it: a rule index and a number of children, a token type and text, or a rule or token tag.
+  /// The tags are numbered in the order they appear in the pattern. A match binds the node matched by each
+  /// tag to the slot of that tag in an array provided by the caller, so matching does not allocate.</para>
+  ///
+  /// <para>
+  /// The pattern holds no references to the parser or the pattern tree it was created from. It can be used
+  /// with the trees of any parser for the same grammar, and it can be shared by several threads.</para>
+  class ANTLR4CPP_PUBLIC CompiledParseTreePattern {
+  public:
+    /// Flattens {@code patternTree}, as created by <seealso cref="ParseTreePatternMatcher#compile"/>.
+    CompiledParseTreePattern(const std::string &pattern, size_t patternRuleIndex, ParseTree *patternTree);
+    virtual ~CompiledParseTreePattern() {}
+
+    /// The tree pattern in concrete syntax form.
+    const std::string& getPattern() const;
+
+    /// The rule which is the root of the pattern. Only subtrees of that rule can match the pattern.
+    size_t getPatternRuleIndex() const;
+
+    /// The number of rule and token tags in the pattern, which is the size of the binding arrays of match().
+    size_t getTagCount() const;
+
+    /// The rule or token name of the given tag, e.g. {@code expr} for the tag {@code <e:expr>}.
+    const std::string& getTagName(size_t tag) const;
+
+    /// The label of the given tag, e.g. {@code e} for the tag {@code <e:expr>}, or an empty string.
+    const std::string& getTagLabel(size_t tag) const;
+
+    /// Returns the last tag with the given name or label, or INVALID_INDEX if there is none. This is the tag
+    /// whose node <seealso cref="ParseTreeMatch#get"/> returns for {@code label}.
+    size_t getTagIndex(const std::string &label) const;
+
+    /// Returns true if {@code tree} matches the pattern. If {@code bindings} is not null it must point to
+    /// getTagCount() entries, which receive the nodes matched by the tags of the pattern. After a failed
+    /// match the entries are undefined.
+    bool matches(ParseTree *tree, ParseTree **bindings = nullptr) const;
+
+  private:
+    enum class NodeKind : uint8_t {
+      RULE,
+      RULE_TAG,
+      TOKEN,
+      TOKEN_TAG
+    };
+
+    struct Node {
+      NodeKind kind;
+
+      // The rule index of rule nodes, the token type of token nodes.
+      size_t type;
+
+      // The number of children of rule nodes, the tag index of tags, the text index of tokens.
+      size_t value;
+    };
+
+    std::string _pattern;
+    size_t _patternRuleIndex;
+
+    // The nodes of the pattern tree in pre-order.
+    std::vector<Node> _nodes;
+    std::vector<std::string> _texts;
+    std::vector<std::string> _tagNames;
+    std::vector<std::string> _tagLabels;
+
+    void add(ParseTree *patternTree);
+    bool matches(ParseTree *tree, size_t &position, ParseTree **bindings) const;
+  };
+
+} // namespace pattern
+} // namespace tree
+} // namespace antlr4
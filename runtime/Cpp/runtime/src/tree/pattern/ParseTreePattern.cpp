@@ -3,9 +3,12 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "Parser.h"
 #include "tree/ParseTree.h"
+#include "tree/pattern/CompiledParseTreePattern.h"
 #include "tree/pattern/ParseTreePatternMatcher.h"
 #include "tree/pattern/ParseTreeMatch.h"
+#include "Exceptions.h"
 
 #include "tree/xpath/XPath.h"
 #include "tree/xpath/XPathElement.h"
@@ -20,6 +23,22 @@ using namespace antlrcpp;
 ParseTreePattern::ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex_,
                                    ParseTree *patternTree)
   : patternRuleIndex(patternRuleIndex_), _pattern(pattern), _patternTree(patternTree), _matcher(matcher) {
+  _compiledPattern = std::make_shared<CompiledParseTreePattern>(pattern, static_cast<size_t>(patternRuleIndex_),
+                                                                patternTree);
+}
+
+ParseTreePattern::ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex_,
+                                   Ref<ParseTree> patternTree)
+  : ParseTreePattern(matcher, pattern, patternRuleIndex_, patternTree.get()) {
+  _patternTreeOwner = std::move(patternTree);
+}
+
+ParseTreePattern::ParseTreePattern(Ref<ParseTreePatternMatcher> matcher, ParseTreePattern const& pattern)
+  : ParseTreePattern(pattern) {
+  if (matcher.get() != _matcher) {
+    throw IllegalArgumentException("The pattern was not created by this matcher.");
+  }
+  _matcherOwner = std::move(matcher);
 }
 
 ParseTreePattern::~ParseTreePattern() {
@@ -62,3 +81,7 @@ int ParseTreePattern::getPatternRuleIndex() const {
 ParseTree* ParseTreePattern::getPatternTree() const {
   return _patternTree;
 }
+
+Ref<const CompiledParseTreePattern> ParseTreePattern::getCompiledPattern() const {
+  return _compiledPattern;
+}
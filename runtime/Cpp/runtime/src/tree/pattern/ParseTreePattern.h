@@ -28,6 +28,19 @@ namespace pattern {
     /// <param name="patternTree"> The tree pattern in <seealso cref="ParseTree"/> form. </param>
     ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex,
                      ParseTree *patternTree);
+
+    /// <summary>
+    /// Like above, but the pattern and all copies of it share the ownership of the pattern tree (which may point
+    /// into a larger object that owns the tree, see the aliasing constructor of std::shared_ptr).
+    /// </summary>
+    ParseTreePattern(ParseTreePatternMatcher *matcher, const std::string &pattern, int patternRuleIndex,
+                     Ref<ParseTree> patternTree);
+
+    /// <summary>
+    /// A copy of {@code pattern} which also shares the ownership of its matcher, so the matcher lives as long
+    /// as the pattern is used. {@code matcher} must be the matcher which created the pattern.
+    /// </summary>
+    ParseTreePattern(Ref<ParseTreePatternMatcher> matcher, ParseTreePattern const& pattern);
     ParseTreePattern(ParseTreePattern const&) = default;
     virtual ~ParseTreePattern();
 
@@ -87,6 +100,13 @@ namespace pattern {
     /// <returns> The tree pattern as a <seealso cref="ParseTree"/>. </returns>
     virtual ParseTree* getPatternTree() const;
 
+    /// <summary>
+    /// Get the tree pattern in flat form, which can be matched without label maps and added to a
+    /// <seealso cref="ParseTreePatternSet"/>. It is created with this pattern.
+    /// </summary>
+    /// <returns> The tree pattern as a <seealso cref="CompiledParseTreePattern"/>. </returns>
+    virtual Ref<const CompiledParseTreePattern> getCompiledPattern() const;
+
   private:
     const int patternRuleIndex;
 
@@ -96,8 +116,17 @@ namespace pattern {
     /// This is the backing field for <seealso cref="#getPatternTree()"/>.
     ParseTree *_patternTree;
 
+    /// The owner of the pattern tree, or null if it is owned by someone else.
+    Ref<ParseTree> _patternTreeOwner;
+
     /// This is the backing field for <seealso cref="#getMatcher()"/>.
     ParseTreePatternMatcher *const _matcher;
+
+    /// The owner of the matcher, or null if it is owned by someone else.
+    Ref<ParseTreePatternMatcher> _matcherOwner;
+
+    /// This is the backing field for <seealso cref="#getCompiledPattern()"/>.
+    Ref<const CompiledParseTreePattern> _compiledPattern;
   };
 
 } // namespace pattern
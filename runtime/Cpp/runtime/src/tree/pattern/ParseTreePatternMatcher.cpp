@@ -3,6 +3,7 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "tree/pattern/CompiledParseTreePattern.h"
 #include "tree/pattern/ParseTreePattern.h"
 #include "tree/pattern/ParseTreeMatch.h"
 #include "tree/TerminalNode.h"
@@ -19,6 +20,7 @@
 #include "ListTokenSource.h"
 #include "tree/pattern/TextChunk.h"
 #include "ANTLRInputStream.h"
+#include "WritableToken.h"
 #include "support/Arrays.h"
 #include "Exceptions.h"
 #include "support/StringUtils.h"
@@ -40,6 +42,22 @@ ParseTreePatternMatcher::CannotInvokeStartRule::~CannotInvokeStartRule() {
 ParseTreePatternMatcher::StartRuleDoesNotConsumeFullPattern::~StartRuleDoesNotConsumeFullPattern() {
 }
 
+// The parser of a pattern, which owns the tokens and the parse tree of the pattern. It uses the DFAs of the matcher,
+// but does not access them anymore after parsing.
+struct ParseTreePatternMatcher::PatternParse {
+  PatternParse(std::vector<std::unique_ptr<Token>> tokens, Parser *parser, std::vector<dfa::DFA> &decisionToDFA,
+               atn::PredictionContextCache &sharedContextCache)
+    : tokenSource(std::move(tokens)), tokenStream(&tokenSource),
+      interpreter(parser->getGrammarFileName(), parser->getVocabulary(), parser->getRuleNames(),
+                  parser->getATNWithBypassAlts(), &tokenStream, decisionToDFA, sharedContextCache) {
+  }
+
+  ListTokenSource tokenSource;
+  CommonTokenStream tokenStream;
+  ParserInterpreter interpreter;
+  ParserRuleContext *tree = nullptr;
+};
+
 ParseTreePatternMatcher::ParseTreePatternMatcher(Lexer *lexer, Parser *parser) : _lexer(lexer), _parser(parser) {
   InitializeInstanceFields();
 }
@@ -62,8 +80,9 @@ void ParseTreePatternMatcher::setDelimiters(const std::string &start, const std:
 }
 
 bool ParseTreePatternMatcher::matches(ParseTree *tree, const std::string &pattern, int patternRuleIndex) {
-  ParseTreePattern p = compile(pattern, patternRuleIndex);
-  return matches(tree, p);
+  std::unique_ptr<PatternParse> patternParse = parse(pattern, patternRuleIndex);
+  std::map<std::string, std::vector<ParseTree *>> labels;
+  return matchImpl(tree, patternParse->tree, labels) == nullptr;
 }
 
 bool ParseTreePatternMatcher::matches(ParseTree *tree, const ParseTreePattern &pattern) {
@@ -84,41 +103,18 @@ ParseTreeMatch ParseTreePatternMatcher::match(ParseTree *tree, const ParseTreePa
 }
 
 ParseTreePattern ParseTreePatternMatcher::compile(const std::string &pattern, int patternRuleIndex) {
-  ListTokenSource tokenSrc(tokenize(pattern));
-  CommonTokenStream tokens(&tokenSrc);
-
-  ParserInterpreter parserInterp(_parser->getGrammarFileName(), _parser->getVocabulary(),
-                                 _parser->getRuleNames(), _parser->getATNWithBypassAlts(), &tokens);
-
-  ParserRuleContext *tree = nullptr;
-  try {
-    parserInterp.setErrorHandler(std::make_shared<BailErrorStrategy>());
-    tree = parserInterp.parse(patternRuleIndex);
-  } catch (ParseCancellationException &e) {
-#if defined(_MSC_FULL_VER) && _MSC_FULL_VER < 190023026
-    // rethrow_if_nested is not available before VS 2015.
-    throw e;
-#else
-    std::rethrow_if_nested(e); // Unwrap the nested exception.
-#endif
-  } catch (RecognitionException &re) {
-    throw re;
-#if defined(_MSC_FULL_VER) && _MSC_FULL_VER < 190023026
-  } catch (std::exception &e) {
-    // throw_with_nested is not available before VS 2015.
-    throw e;
-#else
-  } catch (std::exception & /*e*/) {
-    std::throw_with_nested((const char*)"Cannot invoke start rule"); // Wrap any other exception. We should however probably use one of the ANTLR exceptions here.
-#endif
-  }
+  // The pattern keeps the parser of the pattern (and with it the tree) alive.
+  Ref<PatternParse> patternParse = parse(pattern, patternRuleIndex);
+  Ref<ParseTree> tree(patternParse, patternParse->tree);
 
-  // Make sure tree pattern compilation checks for a complete parse
-  if (tokens.LA(1) != Token::EOF) {
-    throw StartRuleDoesNotConsumeFullPattern();
-  }
+  return ParseTreePattern(this, pattern, patternRuleIndex, std::move(tree));
+}
 
-  return ParseTreePattern(this, pattern, patternRuleIndex, tree);
+Ref<const CompiledParseTreePattern> ParseTreePatternMatcher::compileFlat(const std::string &pattern,
+                                                                       int patternRuleIndex) {
+  std::unique_ptr<PatternParse> patternParse = parse(pattern, patternRuleIndex);
+  return std::make_shared<CompiledParseTreePattern>(pattern, static_cast<size_t>(patternRuleIndex),
+                                                    patternParse->tree);
 }
 
 Lexer* ParseTreePatternMatcher::getLexer() {
@@ -232,13 +228,13 @@ RuleTagToken* ParseTreePatternMatcher::getRuleTagToken(ParseTree *t) {
 
 std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std::string &pattern) {
   // split pattern into chunks: sea (raw input) and islands (<ID>, <expr>)
-  std::vector<Chunk> chunks = split(pattern);
+  std::vector<std::unique_ptr<Chunk>> chunks = split(pattern);
 
   // create token stream from text and tags
   std::vector<std::unique_ptr<Token>> tokens;
-  for (auto chunk : chunks) {
-    if (is<TagChunk *>(&chunk)) {
-      TagChunk &tagChunk = (TagChunk&)chunk;
+  for (auto &chunk : chunks) {
+    if (is<TagChunk *>(chunk.get())) {
+      TagChunk &tagChunk = static_cast<TagChunk &>(*chunk);
       // add special rule token or conjure up new token from name
       if (isupper(tagChunk.getTag()[0])) {
         size_t ttype = _parser->getTokenType(tagChunk.getTag());
@@ -257,11 +253,16 @@ std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std:
         throw IllegalArgumentException("invalid tag: " + tagChunk.getTag() + " in pattern: " + pattern);
       }
     } else {
-      TextChunk &textChunk = (TextChunk&)chunk;
+      TextChunk &textChunk = static_cast<TextChunk &>(*chunk);
       ANTLRInputStream input(textChunk.getText());
       _lexer->setInputStream(&input);
       std::unique_ptr<Token> t(_lexer->nextToken());
       while (t->getType() != Token::EOF) {
+        // The input of the chunk goes away, so its text must be stored in the token.
+        WritableToken *writableToken = dynamic_cast<WritableToken *>(t.get());
+        if (writableToken != nullptr) {
+          writableToken->setText(t->getText());
+        }
         tokens.push_back(std::move(t));
         t = _lexer->nextToken();
       }
@@ -272,10 +273,10 @@ std::vector<std::unique_ptr<Token>> ParseTreePatternMatcher::tokenize(const std:
   return tokens;
 }
 
-std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
+std::vector<std::unique_ptr<Chunk>> ParseTreePatternMatcher::split(const std::string &pattern) {
   size_t p = 0;
   size_t n = pattern.length();
-  std::vector<Chunk> chunks;
+  std::vector<std::unique_ptr<Chunk>> chunks;
 
   // find all start and stop indexes first, then collect
   std::vector<size_t> starts;
@@ -312,14 +313,14 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
   }
 
   // collect into chunks now
-  if (ntags == 0) {
+  if (ntags == 0 && n > 0) {
     std::string text = pattern.substr(0, n);
-    chunks.push_back(TextChunk(text));
+    chunks.emplace_back(new TextChunk(text));
   }
 
   if (ntags > 0 && starts[0] > 0) { // copy text up to first tag into chunks
     std::string text = pattern.substr(0, starts[0]);
-    chunks.push_back(TextChunk(text));
+    chunks.emplace_back(new TextChunk(text));
   }
 
   for (size_t i = 0; i < ntags; i++) {
@@ -332,11 +333,11 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
       label = tag.substr(0,colon);
       ruleOrToken = tag.substr(colon + 1, tag.length() - (colon + 1));
     }
-    chunks.push_back(TagChunk(label, ruleOrToken));
-    if (i + 1 < ntags) {
+    chunks.emplace_back(new TagChunk(label, ruleOrToken));
+    if (i + 1 < ntags && starts[i + 1] > stops[i] + _stop.length()) {
       // copy from end of <tag> to start of next
       std::string text = pattern.substr(stops[i] + _stop.length(), starts[i + 1] - (stops[i] + _stop.length()));
-      chunks.push_back(TextChunk(text));
+      chunks.emplace_back(new TextChunk(text));
     }
   }
 
@@ -344,19 +345,20 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
     size_t afterLastTag = stops[ntags - 1] + _stop.length();
     if (afterLastTag < n) { // copy text from end of last tag to end
       std::string text = pattern.substr(afterLastTag, n - afterLastTag);
-      chunks.push_back(TextChunk(text));
+      chunks.emplace_back(new TextChunk(text));
     }
   }
 
   // strip out all backslashes from text chunks but not tags
   for (size_t i = 0; i < chunks.size(); i++) {
-    Chunk &c = chunks[i];
-    if (is<TextChunk *>(&c)) {
-      TextChunk &tc = (TextChunk&)c;
+    if (is<TextChunk *>(chunks[i].get())) {
+      TextChunk &tc = static_cast<TextChunk &>(*chunks[i]);
       std::string unescaped = tc.getText();
       unescaped.erase(std::remove(unescaped.begin(), unescaped.end(), '\\'), unescaped.end());
-      if (unescaped.length() < tc.getText().length()) {
-        chunks[i] = TextChunk(unescaped);
+      if (unescaped.empty()) {
+        chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(i--));
+      } else if (unescaped.length() < tc.getText().length()) {
+        chunks[i].reset(new TextChunk(unescaped));
       }
     }
   }
@@ -364,6 +366,48 @@ std::vector<Chunk> ParseTreePatternMatcher::split(const std::string &pattern) {
   return chunks;
 }
 
+std::unique_ptr<ParseTreePatternMatcher::PatternParse> ParseTreePatternMatcher::parse(const std::string &pattern,
+                                                                                      int patternRuleIndex) {
+  if (_decisionToDFA.empty()) {
+    const atn::ATN &atn = _parser->getATNWithBypassAlts();
+    for (size_t i = 0; i < atn.getNumberOfDecisions(); ++i) {
+      _decisionToDFA.push_back(dfa::DFA(atn.getDecisionState(i), i));
+    }
+  }
+
+  std::unique_ptr<PatternParse> result(new PatternParse(tokenize(pattern), _parser, _decisionToDFA,
+                                                        _sharedContextCache));
+  ParserInterpreter &parserInterp = result->interpreter;
+  try {
+    parserInterp.setErrorHandler(std::make_shared<BailErrorStrategy>());
+    result->tree = parserInterp.parse(patternRuleIndex);
+  } catch (ParseCancellationException &e) {
+#if defined(_MSC_FULL_VER) && _MSC_FULL_VER < 190023026
+    // rethrow_if_nested is not available before VS 2015.
+    throw e;
+#else
+    std::rethrow_if_nested(e); // Unwrap the nested exception.
+#endif
+  } catch (RecognitionException &re) {
+    throw re;
+#if defined(_MSC_FULL_VER) && _MSC_FULL_VER < 190023026
+  } catch (std::exception &e) {
+    // throw_with_nested is not available before VS 2015.
+    throw e;
+#else
+  } catch (std::exception & /*e*/) {
+    std::throw_with_nested((const char*)"Cannot invoke start rule"); // Wrap any other exception. We should however probably use one of the ANTLR exceptions here.
+#endif
+  }
+
+  // Make sure tree pattern compilation checks for a complete parse
+  if (result->tokenStream.LA(1) != Token::EOF) {
+    throw StartRuleDoesNotConsumeFullPattern();
+  }
+
+  return result;
+}
+
 void ParseTreePatternMatcher::InitializeInstanceFields() {
   _start = "<";
   _stop = ">";
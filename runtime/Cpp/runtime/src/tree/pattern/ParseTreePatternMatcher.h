@@ -6,6 +6,8 @@
 #pragma once
 
 #include "Exceptions.h"
+#include "atn/PredictionContext.h"
+#include "dfa/DFA.h"
 
 namespace antlr4 {
 namespace tree {
@@ -134,9 +136,19 @@ namespace pattern {
     /// <summary>
     /// For repeated use of a tree pattern, compile it to a
     /// <seealso cref="ParseTreePattern"/> using this method.
+    /// <p/>
+    /// The returned pattern (and its copies) own the pattern tree. Matching uses this matcher, which must
+    /// outlive the pattern for that (see ParseTreePattern(Ref<ParseTreePatternMatcher>, ParseTreePattern const&)).
+    /// All patterns compiled by a matcher share the predictions of the pattern parser, so compiling many
+    /// patterns gets cheaper with each pattern.
     /// </summary>
     virtual ParseTreePattern compile(const std::string &pattern, int patternRuleIndex);
 
+    /// Compiles {@code pattern} to a <seealso cref="CompiledParseTreePattern"/> only. The pattern tree is
+    /// released before this function returns. The result depends on the grammar only, not on this matcher
+    /// or its parser.
+    virtual Ref<const CompiledParseTreePattern> compileFlat(const std::string &pattern, int patternRuleIndex);
+
     /// <summary>
     /// Used to convert the tree pattern string into a series of tokens. The
     /// input stream is reset.
@@ -154,7 +166,7 @@ namespace pattern {
     virtual std::vector<std::unique_ptr<Token>> tokenize(const std::string &pattern);
 
     /// Split "<ID> = <e:expr>;" into 4 chunks for tokenizing by tokenize().
-    virtual std::vector<Chunk> split(const std::string &pattern);
+    virtual std::vector<std::unique_ptr<Chunk>> split(const std::string &pattern);
 
   protected:
     std::string _start;
@@ -174,9 +186,17 @@ namespace pattern {
     virtual RuleTagToken* getRuleTagToken(ParseTree *t);
 
   private:
+    struct PatternParse;
+
     Lexer *_lexer;
     Parser *_parser;
 
+    // The DFAs and context cache shared by the parsers of all patterns, created on first use.
+    std::vector<dfa::DFA> _decisionToDFA;
+    atn::PredictionContextCache _sharedContextCache;
+
+    std::unique_ptr<PatternParse> parse(const std::string &pattern, int patternRuleIndex);
+
     void InitializeInstanceFields();
   };
 
@@ -0,0 +1,77 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "Exceptions.h"
+#include "ParserRuleContext.h"
+#include "tree/ParseTree.h"
+#include "tree/pattern/CompiledParseTreePattern.h"
+
+#include "tree/pattern/ParseTreePatternSet.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+using namespace antlr4::tree::pattern;
+
+size_t ParseTreePatternSet::add(Ref<const CompiledParseTreePattern> const& pattern) {
+  if (pattern == nullptr) {
+    throw IllegalArgumentException("pattern cannot be null");
+  }
+
+  size_t ruleIndex = pattern->getPatternRuleIndex();
+  if (ruleIndex >= _patternsByRule.size()) {
+    _patternsByRule.resize(ruleIndex + 1);
+  }
+  _patternsByRule[ruleIndex].push_back(_patterns.size());
+  _maxTagCount = std::max(_maxTagCount, pattern->getTagCount());
+
+  _patterns.push_back(pattern);
+  return _patterns.size() - 1;
+}
+
+size_t ParseTreePatternSet::size() const {
+  return _patterns.size();
+}
+
+const CompiledParseTreePattern& ParseTreePatternSet::get(size_t patternIndex) const {
+  return *_patterns[patternIndex];
+}
+
+void ParseTreePatternSet::match(ParseTree *tree, const Visitor &visitor) const {
+  if (tree == nullptr) {
+    throw IllegalArgumentException("tree cannot be null");
+  }
+
+  std::vector<ParseTree *> bindings(_maxTagCount);
+  match(tree, bindings, visitor);
+}
+
+void ParseTreePatternSet::findAll(ParseTree *tree, const Visitor &visitor) const {
+  if (tree == nullptr) {
+    throw IllegalArgumentException("tree cannot be null");
+  }
+
+  std::vector<ParseTree *> bindings(_maxTagCount);
+  std::vector<ParseTree *> pending = { tree };
+  while (!pending.empty()) {
+    ParseTree *t = pending.back();
+    pending.pop_back();
+
+    match(t, bindings, visitor);
+    pending.insert(pending.end(), t->children.rbegin(), t->children.rend());
+  }
+}
+
+void ParseTreePatternSet::match(ParseTree *tree, std::vector<ParseTree *> &bindings, const Visitor &visitor) const {
+  ParserRuleContext *context = dynamic_cast<ParserRuleContext *>(tree);
+  if (context == nullptr || context->getRuleIndex() >= _patternsByRule.size()) {
+    return;
+  }
+
+  for (size_t patternIndex : _patternsByRule[context->getRuleIndex()]) {
+    if (_patterns[patternIndex]->matches(tree, bindings.data())) {
+      visitor(patternIndex, tree, bindings.data());
+    }
+  }
+}
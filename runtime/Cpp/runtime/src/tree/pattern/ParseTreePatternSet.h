@@ -0,0 +1,60 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+namespace pattern {
+
+  /// A set of compiled tree patterns which are matched against the subtrees of a parse tree together.
+  ///
+  /// <para>
+  /// The patterns are grouped by their root rule, so for each rule node of a tree only the patterns for the
+  /// rule of that node are tried. A whole tree is matched against all patterns in a single traversal, with one
+  /// binding array for the whole traversal.</para>
+  ///
+  /// <para>
+  /// The set is not modified by matching, so it can be shared by several threads once all patterns are added.
+  /// </para>
+  class ANTLR4CPP_PUBLIC ParseTreePatternSet {
+  public:
+    /// Called for each match with the index of the pattern in the set, the matched subtree and the nodes bound
+    /// to the tags of the pattern (see <seealso cref="CompiledParseTreePattern#getTagIndex"/>). The bindings are
+    /// only valid during the call.
+    typedef std::function<void (size_t patternIndex, ParseTree *tree, ParseTree *const *bindings)> Visitor;
+
+    virtual ~ParseTreePatternSet() {}
+
+    /// Adds a pattern to the set and returns its index.
+    size_t add(Ref<const CompiledParseTreePattern> const& pattern);
+
+    size_t size() const;
+    const CompiledParseTreePattern& get(size_t patternIndex) const;
+
+    /// Calls {@code visitor} for each pattern which matches {@code tree} itself, in the order the patterns
+    /// were added.
+    void match(ParseTree *tree, const Visitor &visitor) const;
+
+    /// Calls {@code visitor} for each subtree of {@code tree} (including {@code tree}) and each pattern which
+    /// matches it. The subtrees are visited in document order, the patterns of a subtree in the order they
+    /// were added.
+    void findAll(ParseTree *tree, const Visitor &visitor) const;
+
+  private:
+    std::vector<Ref<const CompiledParseTreePattern>> _patterns;
+
+    // The indices of the patterns per root rule index.
+    std::vector<std::vector<size_t>> _patternsByRule;
+    size_t _maxTagCount = 0;
+
+    void match(ParseTree *tree, std::vector<ParseTree *> &bindings, const Visitor &visitor) const;
+  };
+
+} // namespace pattern
+} // namespace tree
+} // namespace antlr4
@@ -12,6 +12,7 @@
 #include "XPathTokenElement.h"
 #include "XPathRuleAnywhereElement.h"
 #include "XPathRuleElement.h"
+#include "XPathIndex.h"
 
 #include "XPath.h"
 
@@ -25,6 +26,9 @@ const std::string XPath::NOT = "!";
 XPath::XPath(Parser *parser, const std::string &path) {
   _parser = parser;
   _path = path;
+  for (auto &element : split(path)) {
+    _elements.push_back(std::move(element));
+  }
 }
 
 std::vector<std::unique_ptr<XPathElement>> XPath::split(const std::string &path) {
@@ -120,35 +124,52 @@ std::unique_ptr<XPathElement> XPath::getXPathElement(Token *wordToken, bool anyw
   }
 }
 
-static ParserRuleContext dummyRoot;
-
 std::vector<ParseTree *> XPath::findAll(ParseTree *tree, std::string const& xpath, Parser *parser) {
   XPath p(parser, xpath);
   return p.evaluate(tree);
 }
 
 std::vector<ParseTree *> XPath::evaluate(ParseTree *t) {
-  dummyRoot.children = { t }; // don't set t's parent.
+  std::vector<ParseTree *> nodes;
+  forEachMatch(t, nullptr, [&nodes](ParseTree *node) {
+    nodes.push_back(node);
+  });
+  return nodes;
+}
 
-  std::vector<ParseTree *> work = { &dummyRoot };
+std::vector<ParseTree *> XPath::evaluate(ParseTree *t, const XPathIndex &index) const {
+  std::vector<ParseTree *> nodes;
+  forEachMatch(t, &index, [&nodes](ParseTree *node) {
+    nodes.push_back(node);
+  });
+  return nodes;
+}
 
-  size_t i = 0;
-  std::vector<std::unique_ptr<XPathElement>> elements = split(_path);
+void XPath::forEachMatch(ParseTree *t, const XPathIndex *index, const std::function<void (ParseTree *)> &visitor) const {
+  ParserRuleContext dummyRoot;
+  dummyRoot.children = { t }; // don't set t's parent.
 
-  while (i < elements.size()) {
-    std::vector<ParseTree *> next;
-    for (auto *node : work) {
+  // Instead of building the full work list for each path element, every node matched by an element
+  // is directly passed on to the next element (depth first). This yields the nodes in the same order.
+  // steps[i] receives the nodes matched by element i - 1.
+  std::vector<XPathElement::Visitor> steps(_elements.size() + 1);
+  steps[_elements.size()] = [&dummyRoot, &visitor](ParseTree *node) {
+    if (node != &dummyRoot) { // Only possible with //*, and not part of the tree.
+      visitor(node);
+    }
+  };
+  for (size_t i = _elements.size(); i > 0; --i) {
+    const XPathElement *element = _elements[i - 1].get();
+    const XPathElement::Visitor &next = steps[i];
+    steps[i - 1] = [element, index, &next](ParseTree *node) {
       if (!node->children.empty()) {
         // only try to match next element if it has children
         // e.g., //func/*/stat might have a token node for which
         // we can't go looking for stat nodes.
-        auto matching = elements[i]->evaluate(node);
-        next.insert(next.end(), matching.begin(), matching.end());
+        element->forEachMatch(node, index, next);
       }
-    }
-    i++;
-    work = next;
+    };
   }
 
-  return work;
+  steps[0](&dummyRoot);
 }
@@ -52,6 +52,12 @@ namespace xpath {
   ///
   /// <para>
   /// Whitespace is not allowed.</para>
+  ///
+  /// <para>
+  /// The path is split into its elements once, on construction, so an XPath object
+  /// can be used to evaluate the same query on many trees, also from several threads.
+  /// To run many queries on the same tree, build an <seealso cref="XPathIndex"/> of the
+  /// tree once and pass it to the evaluation functions.</para>
 
   class ANTLR4CPP_PUBLIC XPath {
   public:
@@ -71,10 +77,20 @@ namespace xpath {
     /// <seealso cref="#evaluate"/>.
     virtual std::vector<ParseTree *> evaluate(ParseTree *t);
 
+    /// Same as evaluate(t), using an index of the tree which contains {@code t}.
+    std::vector<ParseTree *> evaluate(ParseTree *t, const XPathIndex &index) const;
+
+    /// Call {@code visitor} for each node which evaluate() would return, in the same order,
+    /// as soon as it is found. No intermediate node lists are built. {@code index} is optional.
+    void forEachMatch(ParseTree *t, const XPathIndex *index, const std::function<void (ParseTree *)> &visitor) const;
+
   protected:
     std::string _path;
     Parser *_parser;
 
+    /// The compiled path. The elements are not modified after construction and are shared by copies.
+    std::vector<std::shared_ptr<const XPathElement>> _elements;
+
     /// Convert word like {@code *} or {@code ID} or {@code expr} to a path
     /// element. {@code anywhere} is {@code true} if {@code //} precedes the
     /// word.
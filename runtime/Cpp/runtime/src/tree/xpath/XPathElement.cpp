@@ -21,6 +21,13 @@ std::vector<ParseTree *> XPathElement::evaluate(ParseTree * /*t*/) {
   return {};
 }
 
+void XPathElement::forEachMatch(ParseTree *t, const XPathIndex * /*index*/, const Visitor &visitor) const {
+  // Path elements which only implement evaluate().
+  for (auto *node : const_cast<XPathElement *>(this)->evaluate(t)) {
+    visitor(node);
+  }
+}
+
 std::string XPathElement::toString() const {
   std::string inv = _invert ? "!" : "";
   return antlrcpp::toString(*this) + "[" + inv + _nodeName + "]";
@@ -29,3 +36,11 @@ std::string XPathElement::toString() const {
 void XPathElement::setInvert(bool value) {
   _invert = value;
 }
+
+std::vector<ParseTree *> XPathElement::collectMatches(ParseTree *t) const {
+  std::vector<ParseTree *> nodes;
+  forEachMatch(t, nullptr, [&nodes](ParseTree *node) {
+    nodes.push_back(node);
+  });
+  return nodes;
+}
@@ -12,9 +12,12 @@ namespace tree {
   class ParseTree;
 
 namespace xpath {
+  class XPathIndex;
 
   class ANTLR4CPP_PUBLIC XPathElement {
   public:
+    typedef std::function<void (ParseTree *)> Visitor;
+
     /// Construct element like {@code /ID} or {@code ID} or {@code /*} etc...
     ///  op is null if just node
     XPathElement(const std::string &nodeName);
@@ -26,12 +29,22 @@ namespace xpath {
     /// Given tree rooted at {@code t} return all nodes matched by this path
     /// element.
     virtual std::vector<ParseTree *> evaluate(ParseTree *t);
+
+    /// Call {@code visitor} for each node matched by this path element in the
+    /// tree rooted at {@code t}, in the order evaluate() returns them, without
+    /// collecting them first. If an index of the tree is given, it is used to
+    /// find the nodes instead of walking the tree.
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const;
     virtual std::string toString() const;
 
     void setInvert(bool value);
 
   protected:
     std::string _nodeName;
+
+    /// Collect the nodes visited by forEachMatch() (without an index).
+    std::vector<ParseTree *> collectMatches(ParseTree *t) const;
+
     bool _invert = false;
   };
 
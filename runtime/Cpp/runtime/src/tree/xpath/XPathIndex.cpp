@@ -0,0 +1,110 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#include "ParserRuleContext.h"
+#include "Token.h"
+#include "tree/ParseTree.h"
+#include "tree/TerminalNode.h"
+#include "support/CPPUtils.h"
+
+#include "XPathIndex.h"
+
+using namespace antlr4;
+using namespace antlr4::tree;
+using namespace antlr4::tree::xpath;
+
+using namespace antlrcpp;
+
+XPathIndex::XPathIndex(ParseTree *root) : _root(root) {
+  if (root != nullptr) {
+    add(root);
+  }
+}
+
+ParseTree* XPathIndex::getRoot() const {
+  return _root;
+}
+
+bool XPathIndex::contains(ParseTree *t) const {
+  return _positions.find(t) != _positions.end();
+}
+
+bool XPathIndex::forEachDescendant(ParseTree *t, const Visitor &visitor) const {
+  auto iterator = _positions.find(t);
+  if (iterator == _positions.end()) {
+    return false;
+  }
+
+  for (size_t i = iterator->second; i < _subtreeEnds[iterator->second]; ++i) {
+    visitor(_nodes[i]);
+  }
+  return true;
+}
+
+bool XPathIndex::forEachRuleNode(ParseTree *t, size_t ruleIndex, const Visitor &visitor) const {
+  auto iterator = _ruleNodes.find(ruleIndex);
+  return forEachNode(t, iterator == _ruleNodes.end() ? nullptr : &iterator->second, visitor);
+}
+
+bool XPathIndex::forEachTokenNode(ParseTree *t, size_t tokenType, const Visitor &visitor) const {
+  auto iterator = _tokenNodes.find(tokenType);
+  return forEachNode(t, iterator == _tokenNodes.end() ? nullptr : &iterator->second, visitor);
+}
+
+void XPathIndex::add(ParseTree *t) {
+  struct Entry {
+    ParseTree *node;
+    size_t position;
+    size_t nextChild;
+  };
+
+  // Iterative to avoid deep recursion on deeply nested trees.
+  std::vector<Entry> stack;
+  ParseTree *next = t;
+  while (true) {
+    if (next != nullptr) {
+      size_t position = _nodes.size();
+      _nodes.push_back(next);
+      _subtreeEnds.push_back(0);
+      _positions[next] = position;
+
+      if (is<TerminalNode *>(next)) {
+        _tokenNodes[static_cast<TerminalNode *>(next)->getSymbol()->getType()].push_back(position);
+      } else if (is<ParserRuleContext *>(next)) {
+        _ruleNodes[static_cast<ParserRuleContext *>(next)->getRuleIndex()].push_back(position);
+      }
+      stack.push_back({ next, position, 0 });
+    }
+
+    if (stack.empty()) {
+      break;
+    }
+
+    Entry &entry = stack.back();
+    if (entry.nextChild < entry.node->children.size()) {
+      next = entry.node->children[entry.nextChild++];
+    } else {
+      _subtreeEnds[entry.position] = _nodes.size();
+      stack.pop_back();
+      next = nullptr;
+    }
+  }
+}
+
+bool XPathIndex::forEachNode(ParseTree *t, const std::vector<size_t> *positions, const Visitor &visitor) const {
+  auto iterator = _positions.find(t);
+  if (iterator == _positions.end()) {
+    return false;
+  }
+
+  if (positions != nullptr) {
+    size_t end = _subtreeEnds[iterator->second];
+    for (auto p = std::lower_bound(positions->begin(), positions->end(), iterator->second);
+         p != positions->end() && *p < end; ++p) {
+      visitor(_nodes[*p]);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+#pragma once
+
+#include "antlr4-common.h"
+
+namespace antlr4 {
+namespace tree {
+  class ParseTree;
+
+namespace xpath {
+
+  /// An index of a parse tree, which makes evaluating many XPath queries on the same tree cheaper.
+  ///
+  /// <para>
+  /// The index holds all nodes of the tree in document order (pre-order) and for each rule index and
+  /// each token type the positions of the nodes with that rule index or token type. The nodes of a
+  /// subtree are a contiguous range in document order, so the rule or token nodes below any node of
+  /// the tree can be enumerated without walking the subtree.</para>
+  ///
+  /// <para>
+  /// The index is built once and is read-only afterwards, so it can be shared by several threads.
+  /// It must be rebuilt if the tree is modified.</para>
+  class ANTLR4CPP_PUBLIC XPathIndex {
+  public:
+    typedef std::function<void (ParseTree *)> Visitor;
+
+    XPathIndex(ParseTree *root);
+    virtual ~XPathIndex() {}
+
+    ParseTree* getRoot() const;
+
+    /// Returns true if the given node is part of the indexed tree.
+    bool contains(ParseTree *t) const;
+
+    /// Calls {@code visitor} for all nodes of the subtree {@code t} (including {@code t}) in document order.
+    /// Returns false (without calling the visitor) if {@code t} is not part of the indexed tree.
+    bool forEachDescendant(ParseTree *t, const Visitor &visitor) const;
+
+    /// Calls {@code visitor} for all rule nodes with the given rule index in the subtree {@code t}
+    /// (including {@code t}) in document order.
+    /// Returns false (without calling the visitor) if {@code t} is not part of the indexed tree.
+    bool forEachRuleNode(ParseTree *t, size_t ruleIndex, const Visitor &visitor) const;
+
+    /// Calls {@code visitor} for all terminal nodes with the given token type in the subtree {@code t}
+    /// (including {@code t}) in document order.
+    /// Returns false (without calling the visitor) if {@code t} is not part of the indexed tree.
+    bool forEachTokenNode(ParseTree *t, size_t tokenType, const Visitor &visitor) const;
+
+  private:
+    ParseTree *_root;
+
+    // All nodes in pre-order and for each of them the position after the last node of its subtree.
+    std::vector<ParseTree *> _nodes;
+    std::vector<size_t> _subtreeEnds;
+    std::unordered_map<const ParseTree *, size_t> _positions;
+
+    // Positions of the rule and terminal nodes, per rule index and token type.
+    std::unordered_map<size_t, std::vector<size_t>> _ruleNodes;
+    std::unordered_map<size_t, std::vector<size_t>> _tokenNodes;
+
+    void add(ParseTree *t);
+    bool forEachNode(ParseTree *t, const std::vector<size_t> *positions, const Visitor &visitor) const;
+  };
+
+} // namespace xpath
+} // namespace tree
+} // namespace antlr4
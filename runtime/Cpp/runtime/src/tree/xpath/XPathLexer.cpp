@@ -6,6 +6,11 @@ using namespace antlr4;
 
 XPathLexer::XPathLexer(CharStream *input) : Lexer(input) {
   _interpreter = new atn::LexerATNSimulator(this, _atn, _decisionToDFA, _sharedContextCache);
+
+  // Tokens can be matched in batches, unless nextToken() is overridden in the grammar, super class or a subclass.
+  if (std::is_same<decltype(&XPathLexer::nextToken), std::unique_ptr<antlr4::Token> (antlr4::Lexer::*)()>::value) {
+    _batchMatchingType = &typeid(XPathLexer);
+  }
 }
 
 XPathLexer::~XPathLexer() {
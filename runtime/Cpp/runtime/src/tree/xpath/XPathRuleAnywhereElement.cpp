@@ -3,8 +3,10 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "ParserRuleContext.h"
 #include "tree/ParseTree.h"
 #include "tree/Trees.h"
+#include "tree/xpath/XPathIndex.h"
 
 #include "tree/xpath/XPathRuleAnywhereElement.h"
 
@@ -16,5 +18,19 @@ XPathRuleAnywhereElement::XPathRuleAnywhereElement(const std::string &ruleName,
 }
 
 std::vector<ParseTree *> XPathRuleAnywhereElement::evaluate(ParseTree *t) {
-  return Trees::findAllRuleNodes(t, _ruleIndex);
+  return collectMatches(t);
+}
+
+void XPathRuleAnywhereElement::forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const {
+  // Same as Trees::findAllRuleNodes(), but subtrees covered by the index are not walked.
+  if (index != nullptr && index->forEachRuleNode(t, _ruleIndex, visitor)) {
+    return;
+  }
+
+  if (antlrcpp::is<ParserRuleContext *>(t) && static_cast<ParserRuleContext *>(t)->getRuleIndex() == (size_t)_ruleIndex) {
+    visitor(t);
+  }
+  for (auto *child : t->children) {
+    forEachMatch(child, index, visitor);
+  }
 }
@@ -17,6 +17,7 @@ namespace xpath {
     XPathRuleAnywhereElement(const std::string &ruleName, int ruleIndex);
 
     virtual std::vector<ParseTree *> evaluate(ParseTree *t) override;
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const override;
 
   protected:
     int _ruleIndex = 0;
@@ -16,15 +16,17 @@ XPathRuleElement::XPathRuleElement(const std::string &ruleName, size_t ruleIndex
 }
 
 std::vector<ParseTree *> XPathRuleElement::evaluate(ParseTree *t) {
-  // return all children of t that match nodeName
-  std::vector<ParseTree *> nodes;
+  return collectMatches(t);
+}
+
+void XPathRuleElement::forEachMatch(ParseTree *t, const XPathIndex * /*index*/, const Visitor &visitor) const {
+  // visit all children of t that match nodeName
   for (auto *c : t->children) {
     if (antlrcpp::is<ParserRuleContext *>(c)) {
-      ParserRuleContext *ctx = dynamic_cast<ParserRuleContext *>(c);
+      ParserRuleContext *ctx = static_cast<ParserRuleContext *>(c);
       if ((ctx->getRuleIndex() == _ruleIndex && !_invert) || (ctx->getRuleIndex() != _ruleIndex && _invert)) {
-        nodes.push_back(ctx);
+        visitor(ctx);
       }
     }
   }
-  return nodes;
 }
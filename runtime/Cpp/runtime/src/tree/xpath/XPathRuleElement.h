@@ -16,6 +16,7 @@ namespace xpath {
     XPathRuleElement(const std::string &ruleName, size_t ruleIndex);
 
     virtual std::vector<ParseTree *> evaluate(ParseTree *t) override;
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const override;
 
   protected:
     size_t _ruleIndex = 0;
@@ -3,11 +3,15 @@
  * can be found in the LICENSE.txt file in the project root.
  */
 
+#include "Token.h"
 #include "tree/ParseTree.h"
+#include "tree/TerminalNode.h"
 #include "tree/Trees.h"
+#include "tree/xpath/XPathIndex.h"
 
 #include "XPathTokenAnywhereElement.h"
 
+using namespace antlr4;
 using namespace antlr4::tree;
 using namespace antlr4::tree::xpath;
 
@@ -16,5 +20,19 @@ XPathTokenAnywhereElement::XPathTokenAnywhereElement(const std::string &tokenNam
 }
 
 std::vector<ParseTree *> XPathTokenAnywhereElement::evaluate(ParseTree *t) {
-  return Trees::findAllTokenNodes(t, tokenType);
+  return collectMatches(t);
+}
+
+void XPathTokenAnywhereElement::forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const {
+  // Same as Trees::findAllTokenNodes(), but subtrees covered by the index are not walked.
+  if (index != nullptr && index->forEachTokenNode(t, tokenType, visitor)) {
+    return;
+  }
+
+  if (antlrcpp::is<TerminalNode *>(t) && static_cast<TerminalNode *>(t)->getSymbol()->getType() == (size_t)tokenType) {
+    visitor(t);
+  }
+  for (auto *child : t->children) {
+    forEachMatch(child, index, visitor);
+  }
 }
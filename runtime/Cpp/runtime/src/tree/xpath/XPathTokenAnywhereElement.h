@@ -18,6 +18,7 @@ namespace xpath {
     XPathTokenAnywhereElement(const std::string &tokenName, int tokenType);
 
     virtual std::vector<ParseTree *> evaluate(ParseTree *t) override;
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const override;
   };
 
 } // namespace xpath
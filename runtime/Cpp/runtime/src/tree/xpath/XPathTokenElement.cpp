@@ -19,15 +19,17 @@ XPathTokenElement::XPathTokenElement(const std::string &tokenName, size_t tokenT
 }
 
 std::vector<ParseTree *> XPathTokenElement::evaluate(ParseTree *t) {
-  // return all children of t that match nodeName
-  std::vector<ParseTree *> nodes;
+  return collectMatches(t);
+}
+
+void XPathTokenElement::forEachMatch(ParseTree *t, const XPathIndex * /*index*/, const Visitor &visitor) const {
+  // visit all children of t that match nodeName
   for (auto *c : t->children) {
     if (antlrcpp::is<TerminalNode *>(c)) {
-      TerminalNode *tnode = dynamic_cast<TerminalNode *>(c);
+      TerminalNode *tnode = static_cast<TerminalNode *>(c);
       if ((tnode->getSymbol()->getType() == _tokenType && !_invert) || (tnode->getSymbol()->getType() != _tokenType && _invert)) {
-        nodes.push_back(tnode);
+        visitor(tnode);
       }
     }
   }
-  return nodes;
 }
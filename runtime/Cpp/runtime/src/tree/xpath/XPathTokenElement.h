@@ -16,6 +16,7 @@ namespace xpath {
     XPathTokenElement(const std::string &tokenName, size_t tokenType);
 
     virtual std::vector<ParseTree *> evaluate(ParseTree *t) override;
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const override;
 
   protected:
     size_t _tokenType = 0;
@@ -6,6 +6,7 @@
 #include "XPath.h"
 #include "tree/ParseTree.h"
 #include "tree/Trees.h"
+#include "tree/xpath/XPathIndex.h"
 
 #include "XPathWildcardAnywhereElement.h"
 
@@ -16,8 +17,20 @@ XPathWildcardAnywhereElement::XPathWildcardAnywhereElement() : XPathElement(XPat
 }
 
 std::vector<ParseTree *> XPathWildcardAnywhereElement::evaluate(ParseTree *t) {
+  return collectMatches(t);
+}
+
+void XPathWildcardAnywhereElement::forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const {
   if (_invert) {
-    return {}; // !* is weird but valid (empty)
+    return; // !* is weird but valid (empty)
+  }
+
+  if (index != nullptr && index->forEachDescendant(t, visitor)) {
+    return;
+  }
+
+  visitor(t);
+  for (auto *child : t->children) {
+    forEachMatch(child, index, visitor);
   }
-  return Trees::getDescendants(t);
 }
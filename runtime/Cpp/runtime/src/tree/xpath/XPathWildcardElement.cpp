@@ -22,3 +22,13 @@ std::vector<ParseTree *> XPathWildcardElement::evaluate(ParseTree *t) {
 
   return t->children;
 }
+
+void XPathWildcardElement::forEachMatch(ParseTree *t, const XPathIndex * /*index*/, const Visitor &visitor) const {
+  if (_invert) {
+    return;
+  }
+
+  for (auto *child : t->children) {
+    visitor(child);
+  }
+}
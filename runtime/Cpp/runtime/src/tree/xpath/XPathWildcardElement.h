@@ -16,6 +16,7 @@ namespace xpath {
     XPathWildcardElement();
 
     virtual std::vector<ParseTree *> evaluate(ParseTree *t) override;
+    virtual void forEachMatch(ParseTree *t, const XPathIndex *index, const Visitor &visitor) const override;
   };
 
 } // namespace xpath
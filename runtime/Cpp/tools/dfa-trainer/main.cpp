@@ -0,0 +1,251 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+//
+//  main.cpp
+//  antlr4-dfa-trainer
+//
+//  Parses a corpus with the interpreters for a grammar (using the .interp files generated by ANTLR along with the
+//  parser) and writes the warmed up parser DFAs to a snapshot file. The generated parser of the same grammar
+//  can load that snapshot with dfa::DFASnapshot::read(), so it doesn't start with cold decisions.
+//  Decisions which still needed full context (LL) prediction are reported at the end.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "antlr4-runtime.h"
+
+using namespace antlr4;
+
+namespace {
+
+  void printUsage() {
+    std::cerr << "Usage: antlr4-dfa-trainer [--merge <snapshot>] <lexer.interp> <parser.interp> <start rule> <output snapshot> <file or directory>..." << std::endl
+      << std::endl
+      << "  --merge <snapshot>  Start with the DFAs from an existing snapshot instead of empty ones." << std::endl;
+  }
+
+  // Adds the given file or, for a directory, all files in it (recursively) to the list.
+  void collectFiles(const std::string &path, std::vector<std::string> &files) {
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES || (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+      files.push_back(path);
+      return;
+    }
+
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((path + "\\*").c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE) {
+      return;
+    }
+
+    std::vector<std::string> entries;
+    do {
+      std::string name = data.cFileName;
+      if (name != "." && name != "..") {
+        entries.push_back(path + "\\" + name);
+      }
+    } while (FindNextFileA(handle, &data));
+    FindClose(handle);
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+      files.push_back(path);
+      return;
+    }
+
+    DIR *directory = opendir(path.c_str());
+    if (directory == nullptr) {
+      return;
+    }
+
+    std::vector<std::string> entries;
+    while (struct dirent *entry = readdir(directory)) {
+      std::string name = entry->d_name;
+      if (name != "." && name != "..") {
+        entries.push_back(path + "/" + name);
+      }
+    }
+    closedir(directory);
+#endif
+
+    // Same order on every run, so snapshots are reproducible.
+    std::sort(entries.begin(), entries.end());
+    for (auto &entry : entries) {
+      collectFiles(entry, files);
+    }
+  }
+
+  bool readFile(const std::string &fileName, std::string &content) {
+    std::ifstream stream(fileName, std::ios::binary);
+    if (!stream.good()) {
+      return false;
+    }
+
+    content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return !stream.bad();
+  }
+
+  void printReport(const misc::InterpreterData &parserData, atn::ParseInfo parseInfo) {
+    std::vector<atn::DecisionInfo> decisions = parseInfo.getDecisionInfo();
+
+    std::vector<const atn::DecisionInfo *> fullContextDecisions;
+    for (auto &decision : decisions) {
+      if (decision.LL_Fallback > 0) {
+        fullContextDecisions.push_back(&decision);
+      }
+    }
+
+    if (fullContextDecisions.empty()) {
+      std::cout << "No decision needed full context (LL) prediction." << std::endl;
+      return;
+    }
+
+    std::sort(fullContextDecisions.begin(), fullContextDecisions.end(),
+      [](const atn::DecisionInfo *lhs, const atn::DecisionInfo *rhs) {
+        return lhs->LL_Fallback > rhs->LL_Fallback;
+      });
+
+    std::cout << "Decisions which needed full context (LL) prediction:" << std::endl;
+    std::cout << std::setw(10) << "decision" << "  " << std::left << std::setw(30) << "rule" << std::right
+      << std::setw(13) << "invocations" << std::setw(14) << "LL fallbacks" << std::setw(14) << "LL lookahead"
+      << std::setw(13) << "ambiguities" << std::endl;
+    for (auto *decision : fullContextDecisions) {
+      size_t ruleIndex = parserData.atn.decisionToState[decision->decision]->ruleIndex;
+      std::cout << std::setw(10) << decision->decision << "  " << std::left << std::setw(30)
+        << parserData.ruleNames[ruleIndex] << std::right << std::setw(13) << decision->invocations
+        << std::setw(14) << decision->LL_Fallback << std::setw(14) << decision->LL_TotalLook
+        << std::setw(13) << decision->ambiguities.size() << std::endl;
+    }
+  }
+
+} // namespace
+
+int main(int argc, const char **argv) {
+  std::vector<std::string> arguments(argv + 1, argv + argc);
+  std::string mergeFile;
+  if (arguments.size() >= 2 && arguments[0] == "--merge") {
+    mergeFile = arguments[1];
+    arguments.erase(arguments.begin(), arguments.begin() + 2);
+  }
+
+  if (arguments.size() < 5) {
+    printUsage();
+    return 2;
+  }
+
+  const std::string &lexerFile = arguments[0];
+  const std::string &parserFile = arguments[1];
+  const std::string &startRule = arguments[2];
+  const std::string &outputFile = arguments[3];
+
+  std::vector<std::string> files;
+  for (size_t i = 4; i < arguments.size(); ++i) {
+    collectFiles(arguments[i], files);
+  }
+
+  try {
+    misc::InterpreterData lexerData = misc::InterpreterDataReader::parseFile(lexerFile);
+    if (lexerData.ruleNames.empty()) {
+      std::cerr << "Cannot load lexer data from " << lexerFile << std::endl;
+      return 1;
+    }
+
+    misc::InterpreterData parserData = misc::InterpreterDataReader::parseFile(parserFile);
+    if (parserData.ruleNames.empty()) {
+      std::cerr << "Cannot load parser data from " << parserFile << std::endl;
+      return 1;
+    }
+
+    auto iterator = std::find(parserData.ruleNames.begin(), parserData.ruleNames.end(), startRule);
+    if (iterator == parserData.ruleNames.end()) {
+      std::cerr << "Unknown start rule: " << startRule << std::endl;
+      return 1;
+    }
+    size_t startRuleIndex = static_cast<size_t>(iterator - parserData.ruleNames.begin());
+
+    // The lexer and parser are reused for all files, so their DFAs keep growing.
+    ANTLRInputStream input;
+    LexerInterpreter lexer(lexerFile, lexerData.vocabulary, lexerData.ruleNames, lexerData.channels, lexerData.modes,
+      lexerData.atn, &input);
+    lexer.removeErrorListeners();
+
+    CommonTokenStream emptyTokens(&lexer);
+    ParserInterpreter parser(parserFile, parserData.vocabulary, parserData.ruleNames, parserData.atn, &emptyTokens);
+    parser.removeErrorListeners();
+
+    if (!mergeFile.empty()) {
+      std::ifstream snapshot(mergeFile, std::ios::binary);
+      if (!snapshot.good()) {
+        std::cerr << "Cannot open " << mergeFile << std::endl;
+        return 1;
+      }
+      dfa::DFASnapshot::read(snapshot, parserData.atn, parser.getInterpreter<atn::ParserATNSimulator>()->decisionToDFA);
+    }
+    parser.setProfile(true);
+
+    size_t filesWithErrors = 0;
+    for (auto &fileName : files) {
+      std::string content;
+      if (!readFile(fileName, content)) {
+        std::cerr << "Cannot read " << fileName << std::endl;
+        return 1;
+      }
+
+      input.load(content);
+      input.name = fileName;
+      lexer.reset();
+
+      CommonTokenStream tokens(&lexer);
+      parser.setTokenStream(&tokens);
+      parser.parse(startRuleIndex);
+
+      size_t errors = lexer.getNumberOfSyntaxErrors() + parser.getNumberOfSyntaxErrors();
+      if (errors > 0) {
+        std::cerr << fileName << ": " << errors << " syntax error(s)" << std::endl;
+        ++filesWithErrors;
+      }
+
+      // The parse tree is not needed, resetting the parser releases it.
+      parser.reset();
+    }
+    parser.setTokenStream(&emptyTokens);
+
+    std::vector<dfa::DFA> &decisionToDFA = parser.getInterpreter<atn::ParserATNSimulator>()->decisionToDFA;
+    std::ofstream output(outputFile, std::ios::binary);
+    dfa::DFASnapshot::write(output, parserData.atn, decisionToDFA);
+    output.close();
+    if (!output.good()) {
+      std::cerr << "Cannot write " << outputFile << std::endl;
+      return 1;
+    }
+
+    size_t stateCount = 0;
+    for (auto &dfa : decisionToDFA) {
+      stateCount += dfa.states.size();
+    }
+    std::cout << "Parsed " << files.size() << " file(s), " << filesWithErrors << " with syntax errors. "
+      << "Wrote " << stateCount << " DFA states for " << decisionToDFA.size() << " decisions to " << outputFile << "."
+      << std::endl << std::endl;
+
+    printReport(parserData, parser.getParseInfo());
+  } catch (std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2012-2017 The ANTLR Project. All rights reserved.
+ * Use of this file is governed by the BSD 3-clause license that
+ * can be found in the LICENSE.txt file in the project root.
+ */
+
+//
+//  main.cpp
+//  antlr4-interp-converter
+//
+//  Converts the .interp files generated by ANTLR into the binary interpreter data format, which
+//  misc::InterpreterDataReader::parseBinaryFile() loads without any text parsing.
+//
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "antlr4-runtime.h"
+
+using namespace antlr4;
+
+namespace {
+
+  void printUsage() {
+    std::cerr << "Usage: antlr4-interp-converter <input.interp> <output file>" << std::endl;
+  }
+
+}
+
+int main(int argc, const char **argv) {
+  if (argc != 3) {
+    printUsage();
+    return 2;
+  }
+
+  const std::string inputFile = argv[1];
+  const std::string outputFile = argv[2];
+
+  try {
+    std::ifstream input(inputFile);
+    if (!input.good()) {
+      std::cerr << "Cannot open " << inputFile << std::endl;
+      return 1;
+    }
+
+    std::stringstream binary;
+    misc::InterpreterDataReader::convertToBinary(input, binary);
+
+    // Make sure the result can be loaded (this also deserializes the ATN) before writing it.
+    std::string content = binary.str();
+    misc::InterpreterData data = misc::InterpreterDataReader::parseBinary(content.data(), content.size());
+
+    std::ofstream output(outputFile, std::ios::binary);
+    output.write(content.data(), static_cast<std::streamsize>(content.size()));
+    output.close();
+    if (!output.good()) {
+      std::cerr << "Cannot write " << outputFile << std::endl;
+      return 1;
+    }
+
+    std::cout << "Wrote " << data.ruleNames.size() << " rules and " << data.atn.states.size() << " ATN states to "
+      << outputFile << " (" << content.size() << " bytes)." << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
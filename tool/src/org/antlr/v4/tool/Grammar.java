@@ -83,6 +83,7 @@ public class Grammar implements AttributeResolver {
 		parserOptions.add("language");
 		parserOptions.add("accessLevel");
 		parserOptions.add("exportMacro");
+		parserOptions.add("precompiledDFA");
 	}
 
 	public static final Set<String> lexerOptions = parserOptions;